@@ -0,0 +1,24 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+// Timing shared by the standalone benchmarks.
+
+// Best of repetitions runs, in milliseconds.
+inline double Measure(int repetitions, const std::function<void()>& work)
+{
+	double best = 1e30;
+
+	for (int i = 0; i < repetitions; i++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		work();
+		auto end = std::chrono::high_resolution_clock::now();
+
+		best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+	}
+
+	return best;
+}
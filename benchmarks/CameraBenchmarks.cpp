@@ -0,0 +1,523 @@
+/* Camera and math hot path benchmarks (Google Benchmark).
+
+   Covers the SimdMath kernels against libm and glm, camera input and matrix
+   updates (single cameras and CameraBatch), per-object matrix building with glm
+   for N objects, frustum plane extraction and sphere culling (single frustum
+   and MultiViewCuller).
+
+   Build and run with CMake (from the repository root):
+     cmake -S . -B build -DCMAKE_BUILD_TYPE=Release
+     cmake --build build --target camera_benchmarks
+     cmake --build build --target run_benchmarks
+
+   run_benchmarks writes build/benchmark_results.json. Results of two runs can
+   be compared with compare.py from the Google Benchmark sources.
+*/
+
+#include "Camera/Camera.h"
+#include "Camera/CameraBatch.h"
+#include "Camera/CameraController.h"
+#include "Camera/OrbitCamera.h"
+#include "Camera/Projection.h"
+#include "Culling/Frustum.h"
+#include "Culling/MultiViewCulling.h"
+#include "Jobs/JobSystem.h"
+#include "Math/SimdMath.h"
+
+#include <benchmark/benchmark.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+const float ASPECT = 16.0f / 9.0f;
+const float Z_NEAR = 0.1f;
+const float Z_FAR = 100.0f;
+const float OBJECT_RADIUS = 0.87f;
+
+// Object positions in a cube of side 200 around the origin, fixed seed.
+static void MakePositions(size_t count, std::vector<float>& x, std::vector<float>& y, std::vector<float>& z)
+{
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+
+	x.resize(count);
+	y.resize(count);
+	z.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		x[i] = coordinate(random);
+		y[i] = coordinate(random);
+		z[i] = coordinate(random);
+	}
+}
+
+
+static Frustum MakeFrustum(float yaw)
+{
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f), DEFAULT_WORLD_UP, yaw, PITCH);
+	glm::mat4 projection = glm::perspective(glm::radians(DEFAULT_FOV), ASPECT, Z_NEAR, Z_FAR);
+
+	Frustum frustum;
+	frustum.ExtractPlanes(projection * camera.GetViewMatrix(), false);
+	return frustum;
+}
+
+
+#pragma region Math
+
+const size_t ANGLE_COUNT = 4096;
+
+static std::vector<float> MakeAngles()
+{
+	std::vector<float> angles(ANGLE_COUNT);
+	for (size_t i = 0; i < ANGLE_COUNT; i++)
+		angles[i] = -3.0f + 6.0f * i / ANGLE_COUNT;
+	return angles;
+}
+
+
+static void BM_SinCosLibm(benchmark::State& state)
+{
+	std::vector<float> angles = MakeAngles();
+	std::vector<float> sines(ANGLE_COUNT), cosines(ANGLE_COUNT);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < ANGLE_COUNT; i++)
+		{
+			sines[i] = std::sin(angles[i]);
+			cosines[i] = std::cos(angles[i]);
+		}
+		benchmark::DoNotOptimize(sines.data());
+		benchmark::DoNotOptimize(cosines.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * ANGLE_COUNT);
+}
+BENCHMARK(BM_SinCosLibm);
+
+
+static void BM_SinCos4(benchmark::State& state)
+{
+	std::vector<float> angles = MakeAngles();
+	std::vector<float> sines(ANGLE_COUNT), cosines(ANGLE_COUNT);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < ANGLE_COUNT; i += 4)
+		{
+			__m128 sinValues, cosValues;
+			SinCos(_mm_loadu_ps(&angles[i]), sinValues, cosValues);
+			_mm_storeu_ps(&sines[i], sinValues);
+			_mm_storeu_ps(&cosines[i], cosValues);
+		}
+		benchmark::DoNotOptimize(sines.data());
+		benchmark::DoNotOptimize(cosines.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * ANGLE_COUNT);
+}
+BENCHMARK(BM_SinCos4);
+
+
+SIMD_TARGET_AVX2
+static void SinCos8(const float* angles, float* sines, float* cosines)
+{
+	for (size_t i = 0; i < ANGLE_COUNT; i += 8)
+	{
+		__m256 sinValues, cosValues;
+		SinCos(_mm256_loadu_ps(&angles[i]), sinValues, cosValues);
+		_mm256_storeu_ps(&sines[i], sinValues);
+		_mm256_storeu_ps(&cosines[i], cosValues);
+	}
+}
+
+static void BM_SinCos8(benchmark::State& state)
+{
+	if (!HasAvx2Fma())
+	{
+		state.SkipWithError("AVX2/FMA not supported");
+		return;
+	}
+
+	std::vector<float> angles = MakeAngles();
+	std::vector<float> sines(ANGLE_COUNT), cosines(ANGLE_COUNT);
+
+	for (auto _ : state)
+	{
+		SinCos8(angles.data(), sines.data(), cosines.data());
+		benchmark::DoNotOptimize(sines.data());
+		benchmark::DoNotOptimize(cosines.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * ANGLE_COUNT);
+}
+BENCHMARK(BM_SinCos8);
+
+
+static void BM_NormalizeGlm(benchmark::State& state)
+{
+	std::vector<float> x, y, z;
+	MakePositions(ANGLE_COUNT, x, y, z);
+	std::vector<glm::vec3> normals(ANGLE_COUNT);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < ANGLE_COUNT; i++)
+			normals[i] = glm::normalize(glm::vec3(x[i], y[i], z[i]));
+		benchmark::DoNotOptimize(normals.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * ANGLE_COUNT);
+}
+BENCHMARK(BM_NormalizeGlm);
+
+
+static void BM_Normalize4(benchmark::State& state)
+{
+	std::vector<float> x, y, z;
+	MakePositions(ANGLE_COUNT, x, y, z);
+	std::vector<float> nx(ANGLE_COUNT), ny(ANGLE_COUNT), nz(ANGLE_COUNT);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < ANGLE_COUNT; i += 4)
+		{
+			Vec3x4 v = { _mm_loadu_ps(&x[i]), _mm_loadu_ps(&y[i]), _mm_loadu_ps(&z[i]) };
+			Vec3x4 n = Normalize(v);
+			_mm_storeu_ps(&nx[i], n.X);
+			_mm_storeu_ps(&ny[i], n.Y);
+			_mm_storeu_ps(&nz[i], n.Z);
+		}
+		benchmark::DoNotOptimize(nx.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * ANGLE_COUNT);
+}
+BENCHMARK(BM_Normalize4);
+
+#pragma endregion
+
+
+#pragma region Camera
+
+static void BM_ProcessMouseInput(benchmark::State& state)
+{
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+	float direction = 1.0f;
+
+	for (auto _ : state)
+	{
+		camera.ProcessMouseInput(3.0f * direction, -2.0f * direction);
+		direction = -direction;
+		benchmark::DoNotOptimize(camera);
+	}
+}
+BENCHMARK(BM_ProcessMouseInput);
+
+
+// UpdateCameraVectors is private; SetState calls it whenever the state changes,
+// so yaw is wrapped to keep every step distinct in float.
+static void BM_UpdateCameraVectors(benchmark::State& state)
+{
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+	float yaw = YAW;
+
+	for (auto _ : state)
+	{
+		yaw = std::fmod(yaw + 0.5f, 360.0f);
+		camera.SetState(glm::dvec3(0.0, 0.0, 3.0), yaw, 10.0f, DEFAULT_FOV);
+		benchmark::DoNotOptimize(camera);
+	}
+}
+BENCHMARK(BM_UpdateCameraVectors);
+
+
+static void BM_GetViewMatrix(benchmark::State& state)
+{
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(camera);
+		glm::mat4 view = camera.GetViewMatrix();
+		benchmark::DoNotOptimize(view);
+	}
+}
+BENCHMARK(BM_GetViewMatrix);
+
+
+static void BM_GetViewMatrixRelativeTo(benchmark::State& state)
+{
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+	glm::dvec3 origin(1.0e6, 0.0, -1.0e6);
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(camera);
+		glm::mat4 view = camera.GetViewMatrixRelativeTo(origin);
+		benchmark::DoNotOptimize(view);
+	}
+}
+BENCHMARK(BM_GetViewMatrixRelativeTo);
+
+
+// Forward + right held: one ProcessKeyboard call per pressed key.
+static void BM_ProcessKeyboardPerKey(benchmark::State& state)
+{
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+	for (auto _ : state)
+	{
+		camera.ProcessKeyboard(FORWARD, 1.0f / 120.0f);
+		camera.ProcessKeyboard(RIGHT, 1.0f / 120.0f);
+		benchmark::DoNotOptimize(camera);
+	}
+}
+BENCHMARK(BM_ProcessKeyboardPerKey);
+
+
+template <typename Controller>
+static void BM_ControllerMovement(benchmark::State& state)
+{
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+	Controller controller;
+	unsigned int mask = MOVEMENT_BIT(FORWARD) | MOVEMENT_BIT(RIGHT);
+
+	for (auto _ : state)
+	{
+		controller.ProcessMovement(camera, mask, 1.0f / 120.0f);
+		benchmark::DoNotOptimize(camera);
+	}
+}
+BENCHMARK_TEMPLATE(BM_ControllerMovement, FlyController);
+BENCHMARK_TEMPLATE(BM_ControllerMovement, FpsController);
+BENCHMARK_TEMPLATE(BM_ControllerMovement, SixDofController);
+
+
+// Coasting orbit (Arg 1) against a settled one, which skips the camera update.
+static void BM_OrbitCameraTick(benchmark::State& state)
+{
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+	OrbitCamera orbit;
+	orbit.LookFrom(camera, glm::dvec3(0.0));
+	orbit.SetDamping(state.range(0) ? 0.0f : ORBIT_DAMPING);
+
+	orbit.Rotate(50.0f, 0.0f);
+	orbit.Update(1.0f / 120.0f, true);
+	while (!state.range(0) && orbit.Update(1.0f / 120.0f, false))
+		;
+
+	for (auto _ : state)
+	{
+		if (orbit.Update(1.0f / 120.0f, false))
+			orbit.Apply(camera);
+		benchmark::DoNotOptimize(camera);
+	}
+}
+BENCHMARK(BM_OrbitCameraTick)->Arg(0)->Arg(1);
+
+// N standalone cameras: turn, then view and projection matrices.
+static void BM_CameraObjectsUpdate(benchmark::State& state)
+{
+	size_t count = static_cast<size_t>(state.range(0));
+	ProjectionSettings projection;
+	std::vector<Camera> cameras;
+	std::vector<glm::mat4> views(count), projections(count);
+
+	for (size_t i = 0; i < count; i++)
+		cameras.emplace_back(glm::vec3(static_cast<float>(i), 0.0f, 3.0f), DEFAULT_WORLD_UP, YAW + i, PITCH);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			cameras[i].ProcessMouseInput(1.0f, 0.0f);
+			views[i] = cameras[i].GetViewMatrix();
+			projections[i] = BuildProjectionMatrix(projection, cameras[i].GetCurrentFOV(), ASPECT);
+		}
+		benchmark::DoNotOptimize(views.data());
+		benchmark::DoNotOptimize(projections.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CameraObjectsUpdate)->RangeMultiplier(4)->Range(16, 4096);
+
+
+// The same cameras in a CameraBatch, updated in one SIMD pass.
+static void BM_CameraBatchUpdate(benchmark::State& state)
+{
+	size_t count = static_cast<size_t>(state.range(0));
+	CameraBatch batch;
+
+	for (size_t i = 0; i < count; i++)
+		batch.Add(glm::dvec3(static_cast<double>(i), 0.0, 3.0), YAW + i, PITCH, DEFAULT_FOV, ASPECT);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < count; i++)
+			batch[i].ProcessMouseInput(1.0f, 0.0f);
+		batch.Update();
+		benchmark::DoNotOptimize(batch.GetViewMatrices());
+		benchmark::DoNotOptimize(batch.GetProjectionMatrices());
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CameraBatchUpdate)->RangeMultiplier(4)->Range(16, 4096);
+
+#pragma endregion
+
+
+#pragma region Matrices
+
+static void BM_Perspective(benchmark::State& state)
+{
+	float fov = DEFAULT_FOV;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(fov);
+		glm::mat4 projection = glm::perspective(glm::radians(fov), ASPECT, Z_NEAR, Z_FAR);
+		benchmark::DoNotOptimize(projection);
+	}
+}
+BENCHMARK(BM_Perspective);
+
+
+static void BM_PerspectiveReverseZInfinite(benchmark::State& state)
+{
+	float fov = DEFAULT_FOV;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(fov);
+		glm::mat4 projection = PerspectiveReverseZInfinite(glm::radians(fov), ASPECT, Z_NEAR, true);
+		benchmark::DoNotOptimize(projection);
+	}
+}
+BENCHMARK(BM_PerspectiveReverseZInfinite);
+
+
+// Model matrix per object with glm::translate.
+static void BM_TranslateObjects(benchmark::State& state)
+{
+	size_t count = static_cast<size_t>(state.range(0));
+	std::vector<float> x, y, z;
+	MakePositions(count, x, y, z);
+	std::vector<glm::mat4> models(count);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < count; i++)
+			models[i] = glm::translate(glm::mat4(1.0f), glm::vec3(x[i], y[i], z[i]));
+		benchmark::DoNotOptimize(models.data());
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TranslateObjects)->RangeMultiplier(8)->Range(1 << 9, 1 << 21);
+
+
+// Projection * view * model per object, as a per-object uniform upload would need.
+static void BM_ModelViewProjectionObjects(benchmark::State& state)
+{
+	size_t count = static_cast<size_t>(state.range(0));
+	std::vector<float> x, y, z;
+	MakePositions(count, x, y, z);
+	std::vector<glm::mat4> matrices(count);
+
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+	glm::mat4 viewProjection = glm::perspective(glm::radians(DEFAULT_FOV), ASPECT, Z_NEAR, Z_FAR) * camera.GetViewMatrix();
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < count; i++)
+			matrices[i] = viewProjection * glm::translate(glm::mat4(1.0f), glm::vec3(x[i], y[i], z[i]));
+		benchmark::DoNotOptimize(matrices.data());
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ModelViewProjectionObjects)->RangeMultiplier(8)->Range(1 << 9, 1 << 21);
+
+#pragma endregion
+
+
+#pragma region Culling
+
+static void BM_FrustumExtractPlanes(benchmark::State& state)
+{
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+	glm::mat4 viewProjection = glm::perspective(glm::radians(DEFAULT_FOV), ASPECT, Z_NEAR, Z_FAR) * camera.GetViewMatrix();
+	bool zeroToOneDepth = state.range(0) != 0;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(viewProjection);
+		Frustum frustum;
+		frustum.ExtractPlanes(viewProjection, zeroToOneDepth);
+		benchmark::DoNotOptimize(frustum);
+	}
+}
+BENCHMARK(BM_FrustumExtractPlanes)->Arg(0)->Arg(1);
+
+
+static void BM_FrustumCullSpheres(benchmark::State& state)
+{
+	size_t count = static_cast<size_t>(state.range(0));
+	std::vector<float> x, y, z;
+	MakePositions(count, x, y, z);
+	Frustum frustum = MakeFrustum(YAW);
+
+	size_t visible = 0;
+	for (auto _ : state)
+	{
+		visible = 0;
+		for (size_t i = 0; i < count; i++)
+			visible += frustum.IsSphereVisible(glm::vec3(x[i], y[i], z[i]), OBJECT_RADIUS) ? 1 : 0;
+		benchmark::DoNotOptimize(visible);
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["visible"] = static_cast<double>(visible);
+}
+BENCHMARK(BM_FrustumCullSpheres)->RangeMultiplier(8)->Range(1 << 9, 1 << 21);
+
+
+// MultiViewCuller over all hardware threads: objects x views.
+static void BM_MultiViewCull(benchmark::State& state)
+{
+	static JobSystem jobs;
+
+	size_t count = static_cast<size_t>(state.range(0));
+	int viewCount = static_cast<int>(state.range(1));
+	std::vector<float> x, y, z;
+	MakePositions(count, x, y, z);
+
+	std::vector<Frustum> frustums;
+	for (int v = 0; v < viewCount; v++)
+		frustums.push_back(MakeFrustum(YAW + v * 360.0f / viewCount));
+
+	MultiViewCuller culler;
+	for (auto _ : state)
+	{
+		culler.Cull(frustums.data(), viewCount, x.data(), y.data(), z.data(), OBJECT_RADIUS, count, jobs);
+		benchmark::DoNotOptimize(culler.GetSharedInstances().data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["shared"] = static_cast<double>(culler.GetSharedInstances().size());
+}
+BENCHMARK(BM_MultiViewCull)->ArgsProduct({ { 1 << 14, 1 << 17, 1 << 20 }, { 1, 4 } })->UseRealTime();
+
+#pragma endregion
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,114 @@
+/* Frame pacing benchmark.
+
+   Runs frames with a random amount of busy work and paces them three ways:
+   a plain sleep for the rest of the frame, the FrameLimiter (sleep plus spin
+   against a running deadline) and no limit. Frame-to-frame intervals go into
+   FrameStats, and the deviation from the target interval is reported next to
+   the CPU time the pacing itself cost.
+
+   Build (from the repository root):
+     g++ -O2 -std=c++17 -pthread -Isrc benchmarks/FramePacingBenchmark.cpp
+         src/Timing/FrameLimiter.cpp src/Timing/FrameStats.cpp -o frame_pacing_benchmark
+*/
+
+#include "Timing/FrameLimiter.h"
+#include "Timing/FrameStats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+
+const double TARGET_FPS = 120.0;
+const int FRAME_COUNT = 600;
+
+// Simulated frame work, milliseconds.
+const double MIN_WORK_MS = 1.0;
+const double MAX_WORK_MS = 5.0;
+
+typedef std::chrono::steady_clock Clock;
+
+enum Pacing_Mode
+{
+	PACING_SLEEP,
+	PACING_LIMITER,
+	PACING_NONE
+};
+
+static void BusyWork(double milliseconds)
+{
+	Clock::time_point start = Clock::now();
+	while (std::chrono::duration<double, std::milli>(Clock::now() - start).count() < milliseconds)
+		;
+}
+
+
+static void RunPacing(Pacing_Mode mode, const char* label)
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<double> work(MIN_WORK_MS, MAX_WORK_MS);
+
+	FrameLimiter limiter(TARGET_FPS);
+	FrameStats stats;
+	double targetMs = 1000.0 / TARGET_FPS;
+	double deviationSum = 0.0;
+	double waitSeconds = 0.0;
+
+	Clock::time_point last = Clock::now();
+	for (int frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		Clock::time_point frameStart = Clock::now();
+		BusyWork(work(random));
+
+		if (mode == PACING_SLEEP)
+		{
+			double rest = targetMs - std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+			if (rest > 0.0)
+				std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(rest));
+		}
+		else if (mode == PACING_LIMITER)
+		{
+			waitSeconds += limiter.Wait();
+		}
+
+		Clock::time_point now = Clock::now();
+		double interval = std::chrono::duration<double>(now - last).count();
+		last = now;
+
+		if (frame == 0)
+			continue;
+
+		stats.AddFrame(interval);
+		deviationSum += std::abs(interval * 1000.0 - targetMs);
+	}
+
+	FrameStatsSummary summary = stats.GetSummary();
+	std::cout << label << ": p50 " << summary.P50Ms << " ms, p99 " << summary.P99Ms << " ms, max " << summary.MaxMs
+		<< " ms, mean deviation from " << targetMs << " ms: " << deviationSum / (FRAME_COUNT - 1) << " ms";
+	if (mode == PACING_LIMITER)
+		std::cout << ", oversleep estimate " << limiter.GetOversleep() * 1000.0 << " ms, waited " << waitSeconds << " s";
+	std::cout << "\n";
+}
+
+
+int main()
+{
+	std::cout << FRAME_COUNT << " frames at " << TARGET_FPS << " fps with " << MIN_WORK_MS << "-" << MAX_WORK_MS << " ms of work each.\n";
+
+	RunPacing(PACING_SLEEP, "sleep   ");
+	RunPacing(PACING_LIMITER, "limiter ");
+	RunPacing(PACING_NONE, "no limit");
+
+	// Histogram accuracy against exact percentiles of a known distribution.
+	FrameStats stats;
+	for (int i = 1; i <= 100000; i++)
+		stats.AddFrame(i * 1.0e-6);
+
+	double p99 = stats.GetPercentileMs(0.99);
+	double error = std::abs(p99 - 99.0) / 99.0;
+	std::cout << "Histogram p99 of 1..100 ms: " << p99 << " ms (relative error " << error << ", bound " << 1.0 / FRAME_STATS_SUB_BUCKETS << ").\n";
+
+	return error <= 1.0 / FRAME_STATS_SUB_BUCKETS ? 0 : 1;
+}
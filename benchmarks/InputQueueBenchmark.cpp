@@ -0,0 +1,176 @@
+/* Input queue benchmark.
+
+   A producer thread polls the "mouse" at 8 kHz and pushes cursor events into
+   the InputEventQueue while the main thread runs 144 Hz frames that drain,
+   coalesce and apply the input to a camera once per frame. The per-frame
+   input cost is compared against idle frames and against applying every
+   event to the camera directly (what the GLFW callbacks used to do).
+
+   Fails if the p99 queue + coalesce cost exceeds MAX_BUDGET_FRACTION of the
+   frame budget, or if the queue dropped any events.
+
+   Build (from the repository root):
+     g++ -O2 -std=c++17 -pthread -IDependencies/includes -Isrc benchmarks/InputQueueBenchmark.cpp
+         src/Input/InputEventQueue.cpp src/Input/InputCoalescer.cpp src/Camera/Camera.cpp -o input_queue_benchmark
+*/
+
+#include "Camera/Camera.h"
+#include "Input/InputCoalescer.h"
+#include "Input/InputEventQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+const double POLLING_RATE_HZ = 8000.0;
+const double FRAME_RATE_HZ = 144.0;
+const int FRAME_COUNT = 720;
+
+// Share of the frame budget the coalesced input stage may take at p99.
+const double MAX_BUDGET_FRACTION = 0.01;
+
+typedef std::chrono::steady_clock Clock;
+
+static double SecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+
+// Busy-wait until the given time, sleeping would be far too coarse for 8 kHz.
+static void WaitUntil(Clock::time_point start, double seconds)
+{
+	while (SecondsSince(start) < seconds)
+	{
+	}
+}
+
+
+struct FrameCosts
+{
+	double MeanUs = 0.0;
+	double P99Us = 0.0;
+	double EventsPerFrame = 0.0;
+	size_t Dropped = 0;
+};
+
+static FrameCosts Summarize(std::vector<double>& costs, size_t events)
+{
+	std::sort(costs.begin(), costs.end());
+
+	FrameCosts summary;
+	for (double cost : costs)
+		summary.MeanUs += cost;
+
+	summary.MeanUs /= costs.size();
+	summary.P99Us = costs[costs.size() * 99 / 100];
+	summary.EventsPerFrame = double(events) / costs.size();
+
+	return summary;
+}
+
+
+// Frames at FRAME_RATE_HZ, timing only the input stage. With a producer the
+// mouse moves in circles at POLLING_RATE_HZ meanwhile.
+static FrameCosts RunFrames(bool withProducer, bool coalesce)
+{
+	InputEventQueue queue;
+	InputCoalescer coalescer;
+	Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+	std::atomic<bool> running(true);
+	Clock::time_point start = Clock::now();
+
+	std::thread producer([&]
+	{
+		for (long long poll = 0; running.load(std::memory_order_relaxed) && withProducer; poll++)
+		{
+			double time = poll / POLLING_RATE_HZ;
+			WaitUntil(start, time);
+
+			InputEvent event;
+			event.Time = time;
+			event.Type = INPUT_CURSOR_MOVED;
+			event.X = static_cast<float>(400.0 + 100.0 * std::cos(time));
+			event.Y = static_cast<float>(300.0 + 100.0 * std::sin(time));
+			queue.Push(event);
+		}
+	});
+
+	std::vector<double> costs;
+	size_t events = 0;
+	float lastX = 0.0f, lastY = 0.0f;
+
+	for (int frame = 1; frame <= FRAME_COUNT; frame++)
+	{
+		WaitUntil(start, frame / FRAME_RATE_HZ);
+		Clock::time_point inputStart = Clock::now();
+
+		if (coalesce)
+		{
+			coalescer.Drain(queue);
+			CoalescedInput input = coalescer.Take();
+
+			if (input.CursorEvents > 0)
+				camera.ProcessMouseInput(input.MouseX * 0.001f, input.MouseY * 0.001f);
+
+			events += input.CursorEvents;
+		}
+		else
+		{
+			// One camera update per event, like the old callbacks.
+			InputEvent event;
+			while (queue.Pop(event))
+			{
+				camera.ProcessMouseInput((event.X - lastX) * 0.001f, (lastY - event.Y) * 0.001f);
+				lastX = event.X;
+				lastY = event.Y;
+				events++;
+			}
+		}
+
+		costs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - inputStart).count());
+	}
+
+	running = false;
+	producer.join();
+
+	FrameCosts summary = Summarize(costs, events);
+	summary.Dropped = queue.GetDroppedCount();
+
+	if (summary.Dropped > 0)
+		std::cout << "  (" << summary.Dropped << " events dropped)\n";
+
+	return summary;
+}
+
+
+static void Print(const char* name, const FrameCosts& costs)
+{
+	std::cout << name << costs.MeanUs << " us mean, " << costs.P99Us << " us p99, " << costs.EventsPerFrame << " events/frame\n";
+}
+
+
+int main()
+{
+	std::cout << "Input cost per " << FRAME_RATE_HZ << " Hz frame (" << 1e6 / FRAME_RATE_HZ << " us budget), "
+		<< POLLING_RATE_HZ << " Hz mouse:\n";
+
+	FrameCosts idle = RunFrames(false, true);
+	Print("  Idle:                 ", idle);
+	FrameCosts coalesced = RunFrames(true, true);
+	Print("  Queue + coalesce:     ", coalesced);
+	FrameCosts perEvent = RunFrames(true, false);
+	Print("  Queue, per event:     ", perEvent);
+
+	double limitUs = MAX_BUDGET_FRACTION * 1e6 / FRAME_RATE_HZ;
+	std::cout << "Queue + coalesce p99: " << coalesced.P99Us << " us (bound " << limitUs << " us, "
+		<< MAX_BUDGET_FRACTION * 100.0 << "% of the budget).\n";
+
+	bool dropped = idle.Dropped + coalesced.Dropped + perEvent.Dropped > 0;
+	return coalesced.P99Us <= limitUs && !dropped ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+/* Mip generation benchmark.
+
+   Builds the full mip chain of a 4K and an 8K image with a naive scalar
+   filter (pow() per channel), the SIMD box and Kaiser filters of
+   MipGenerator, and stb_image_resize when it is available. Fails (exit code
+   1) if the SIMD box chain differs from the naive one by more than
+   MAX_BOX_DIFFERENCE in any channel.
+
+   Build (from the repository root):
+     g++ -O2 -std=c++17 -pthread -IDependencies/includes -Isrc benchmarks/MipGenerationBenchmark.cpp
+         src/Textures/MipGenerator.cpp src/Jobs/JobSystem.cpp -o mip_generation_benchmark
+
+   Add -DHAVE_STB_IMAGE_RESIZE with stb_image_resize.h (v1) on the include
+   path to compare against stbir_resize_uint8_srgb.
+*/
+
+#include "Textures/MipGenerator.h"
+#include "Textures/TextureFormat.h"
+
+#ifdef HAVE_STB_IMAGE_RESIZE
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include "stb_image_resize.h"
+#endif
+
+#include "BenchmarkTiming.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+const int REPETITIONS = 3;
+
+// Largest difference per channel between the SIMD box chain and the naive one.
+const int MAX_BOX_DIFFERENCE = 1;
+
+
+static float SrgbToLinear(float value)
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+
+static float LinearToSrgb(float value)
+{
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+
+// Smooth gradients with some noise, opaque.
+static TextureImage BuildTestImage(uint32_t width, uint32_t height)
+{
+	TextureImage image;
+	image.Width = width;
+	image.Height = height;
+	image.Pixels.resize(static_cast<size_t>(width) * height * 4);
+
+	uint32_t seed = 1;
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			uint8_t* pixel = &image.Pixels[(static_cast<size_t>(y) * width + x) * 4];
+
+			pixel[0] = static_cast<uint8_t>(x * 255 / width);
+			pixel[1] = static_cast<uint8_t>(y * 255 / height);
+			pixel[2] = static_cast<uint8_t>(seed >> 24);
+			pixel[3] = 255;
+		}
+	}
+
+	return image;
+}
+
+
+// Every level from the previous RGBA8 level, sRGB decoded and encoded per channel.
+static std::vector<TextureImage> NaiveMipChain(const TextureImage& image)
+{
+	uint32_t levelCount = GetMipLevelCount(image.Width, image.Height);
+	std::vector<TextureImage> levels(levelCount);
+	levels[0] = image;
+
+	for (uint32_t level = 1; level < levelCount; level++)
+	{
+		const TextureImage& source = levels[level - 1];
+		TextureImage& mip = levels[level];
+		mip.Width = std::max(source.Width / 2, 1u);
+		mip.Height = std::max(source.Height / 2, 1u);
+		mip.Pixels.resize(static_cast<size_t>(mip.Width) * mip.Height * 4);
+
+		for (uint32_t y = 0; y < mip.Height; y++)
+		{
+			for (uint32_t x = 0; x < mip.Width; x++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					float sum = 0.0f;
+					for (uint32_t dy = 0; dy < 2; dy++)
+					{
+						for (uint32_t dx = 0; dx < 2; dx++)
+						{
+							uint32_t sx = std::min(x * 2 + dx, source.Width - 1);
+							uint32_t sy = std::min(y * 2 + dy, source.Height - 1);
+							float value = source.Pixels[(static_cast<size_t>(sy) * source.Width + sx) * 4 + c] / 255.0f;
+
+							sum += (c == 3) ? value : SrgbToLinear(value);
+						}
+					}
+
+					float average = sum * 0.25f;
+					float encoded = (c == 3) ? average : LinearToSrgb(average);
+					mip.Pixels[(static_cast<size_t>(y) * mip.Width + x) * 4 + c] = static_cast<uint8_t>(encoded * 255.0f + 0.5f);
+				}
+			}
+		}
+	}
+
+	return levels;
+}
+
+
+// Largest per channel difference between two chains of the same image.
+static int MaxDifference(const std::vector<TextureImage>& a, const std::vector<TextureImage>& b)
+{
+	if (a.size() != b.size())
+		return 256;
+
+	int difference = 0;
+	for (size_t level = 0; level < a.size(); level++)
+	{
+		if (a[level].Pixels.size() != b[level].Pixels.size())
+			return 256;
+
+		for (size_t i = 0; i < a[level].Pixels.size(); i++)
+			difference = std::max(difference, std::abs(a[level].Pixels[i] - b[level].Pixels[i]));
+	}
+
+	return difference;
+}
+
+
+#ifdef HAVE_STB_IMAGE_RESIZE
+// Every level from the previous one with stbir's default (Mitchell) filter.
+static std::vector<TextureImage> StbirMipChain(const TextureImage& image)
+{
+	uint32_t levelCount = GetMipLevelCount(image.Width, image.Height);
+	std::vector<TextureImage> levels(levelCount);
+	levels[0] = image;
+
+	for (uint32_t level = 1; level < levelCount; level++)
+	{
+		const TextureImage& source = levels[level - 1];
+		TextureImage& mip = levels[level];
+		mip.Width = std::max(source.Width / 2, 1u);
+		mip.Height = std::max(source.Height / 2, 1u);
+		mip.Pixels.resize(static_cast<size_t>(mip.Width) * mip.Height * 4);
+
+		stbir_resize_uint8_srgb(source.Pixels.data(), source.Width, source.Height, 0,
+			mip.Pixels.data(), mip.Width, mip.Height, 0, 4, 3, 0);
+	}
+
+	return levels;
+}
+#endif
+
+
+int main(int argc, char** argv)
+{
+	unsigned int threadCount = argc > 1 ? static_cast<unsigned int>(atoi(argv[1])) : 0;
+	JobSystem jobs(threadCount);
+
+	std::cout << "Threads: " << jobs.GetThreadCount() << "\n";
+	bool passed = true;
+
+	for (uint32_t size : { 4096u, 8192u })
+	{
+		TextureImage image = BuildTestImage(size, size);
+		std::vector<TextureImage> naive, box;
+
+		double naiveMs = Measure(REPETITIONS, [&] { naive = NaiveMipChain(image); });
+		double boxMs = Measure(REPETITIONS, [&] { box = GenerateMipChain(image, jobs, MIP_FILTER_BOX); });
+		double kaiserMs = Measure(REPETITIONS, [&] { GenerateMipChain(image, jobs, MIP_FILTER_KAISER); });
+
+		std::cout << size << "x" << size << " (" << naive.size() << " levels)\n";
+		std::cout << "  Naive scalar:    " << naiveMs << " ms\n";
+#ifdef HAVE_STB_IMAGE_RESIZE
+		double stbirMs = Measure(REPETITIONS, [&] { StbirMipChain(image); });
+		std::cout << "  stbir:           " << stbirMs << " ms\n";
+#endif
+		std::cout << "  SIMD box:        " << boxMs << " ms\n";
+		std::cout << "  SIMD Kaiser:     " << kaiserMs << " ms\n";
+
+		// Vectorization bugs show up as differences to the scalar chain.
+		int difference = MaxDifference(naive, box);
+		std::cout << "  SIMD box vs naive: " << difference << " max difference (bound " << MAX_BOX_DIFFERENCE << ")\n";
+		passed &= difference <= MAX_BOX_DIFFERENCE;
+	}
+
+	return passed ? 0 : 1;
+}
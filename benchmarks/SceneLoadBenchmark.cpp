@@ -0,0 +1,71 @@
+/* Scene load benchmark.
+
+   Loads the same cube field scene from the text format and from the binary
+   memory-mapped format, and touches every instance so page faults are counted.
+
+   Build (from the repository root):
+     g++ -O2 -std=c++17 -IDependencies/includes -Isrc benchmarks/SceneLoadBenchmark.cpp
+         src/Scene/SceneData.cpp src/Scene/SceneFile.cpp src/Scene/DefaultScene.cpp src/IO/MappedFile.cpp -o scene_load_benchmark
+*/
+
+#include "Scene/DefaultScene.h"
+#include "Scene/SceneFile.h"
+
+#include "BenchmarkTiming.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+const size_t DEFAULT_INSTANCE_COUNT = 2000000;
+const int REPETITIONS = 5;
+
+
+// Sum of instance positions, so loads can't be optimized away.
+static double SumPositions(const SceneView& view)
+{
+	double sum = 0.0;
+	for (size_t i = 0; i < view.InstanceCount; i++)
+		sum += view.Instances[i].Position[0] + view.Instances[i].Position[1] + view.Instances[i].Position[2];
+
+	return sum;
+}
+
+
+int main(int argc, char** argv)
+{
+	size_t instanceCount = argc > 1 ? static_cast<size_t>(strtoull(argv[1], nullptr, 10)) : DEFAULT_INSTANCE_COUNT;
+
+	const char* textPath = "scene_benchmark.txt";
+	const char* binaryPath = "scene_benchmark.scene";
+
+	SceneData scene = BuildCubeFieldScene(instanceCount, 1000.0, 42);
+	if (!scene.SaveText(textPath) || !WriteSceneFile(binaryPath, scene))
+		return 1;
+
+	double textSum = 0.0;
+	double textMs = Measure(REPETITIONS, [&]
+	{
+		SceneData loaded;
+		loaded.LoadText(textPath);
+		textSum = SumPositions(loaded.GetView());
+	});
+
+	double binarySum = 0.0;
+	double binaryMs = Measure(REPETITIONS, [&]
+	{
+		SceneFile file;
+		file.Open(binaryPath);
+		binarySum = SumPositions(file.GetView());
+	});
+
+	std::cout << "Instances: " << instanceCount << "\n";
+	std::cout << "Text parse:       " << textMs << " ms\n";
+	std::cout << "Memory-mapped:    " << binaryMs << " ms\n";
+	std::cout << "Checksums: " << textSum << " / " << binarySum << "\n";
+
+	std::remove(textPath);
+	std::remove(binaryPath);
+
+	return 0;
+}
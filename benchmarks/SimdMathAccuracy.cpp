@@ -0,0 +1,177 @@
+/* SIMD math accuracy check.
+
+   Compares the kernels of Math/SimdMath.h against double precision libm and
+   glm over dense sweeps, prints the largest errors and fails (exit code 1) if
+   any exceeds the bound documented in SimdMath.h. The 8-lane kernels are
+   skipped on CPUs without AVX2/FMA.
+
+   Build (from the repository root):
+     g++ -O2 -std=c++17 -IDependencies/includes -Isrc benchmarks/SimdMathAccuracy.cpp -o simd_math_accuracy
+*/
+
+#include "Math/SimdMath.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// Bounds documented in SimdMath.h.
+const double SIN_COS_MAX_ABS_ERROR = 1.2e-7;
+const double SIN_COS_RANGE = 8192.0;
+const double RECIPROCAL_SQRT_MAX_REL_ERROR = 4e-7;
+const double NORMALIZE_MAX_LENGTH_ERROR = 4e-7;
+
+static bool Report(const char* name, double error, double bound)
+{
+	bool passed = error <= bound;
+	printf("%-36s %.3e  (bound %.1e)  %s\n", name, error, bound, passed ? "ok" : "FAILED");
+	return passed;
+}
+
+
+// Largest absolute sin/cos error of 4 lanes at a time over [-range, range].
+static void MeasureSinCos4(double range, size_t samples, double& outSinError, double& outCosError)
+{
+	outSinError = 0.0;
+	outCosError = 0.0;
+
+	for (size_t i = 0; i < samples; i += 4)
+	{
+		alignas(16) float x[4], s[4], c[4];
+		for (int lane = 0; lane < 4; lane++)
+			x[lane] = static_cast<float>(-range + 2.0 * range * (i + lane) / samples);
+
+		__m128 sinValues, cosValues;
+		SinCos(_mm_load_ps(x), sinValues, cosValues);
+		_mm_store_ps(s, sinValues);
+		_mm_store_ps(c, cosValues);
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			outSinError = std::max(outSinError, std::fabs(s[lane] - std::sin(static_cast<double>(x[lane]))));
+			outCosError = std::max(outCosError, std::fabs(c[lane] - std::cos(static_cast<double>(x[lane]))));
+		}
+	}
+}
+
+
+SIMD_TARGET_AVX2
+static double MeasureSinCos8Difference(double range, size_t samples)
+{
+	double difference = 0.0;
+
+	for (size_t i = 0; i < samples; i += 8)
+	{
+		alignas(32) float x[8], s8[8], c8[8];
+		alignas(16) float s4[8], c4[8];
+		for (int lane = 0; lane < 8; lane++)
+			x[lane] = static_cast<float>(-range + 2.0 * range * (i + lane) / samples);
+
+		__m256 sinValues, cosValues;
+		SinCos(_mm256_load_ps(x), sinValues, cosValues);
+		_mm256_store_ps(s8, sinValues);
+		_mm256_store_ps(c8, cosValues);
+
+		for (int half = 0; half < 2; half++)
+		{
+			__m128 sin4, cos4;
+			SinCos(_mm_load_ps(x + half * 4), sin4, cos4);
+			_mm_store_ps(s4 + half * 4, sin4);
+			_mm_store_ps(c4 + half * 4, cos4);
+		}
+
+		for (int lane = 0; lane < 8; lane++)
+			difference = std::max(difference, static_cast<double>(std::max(std::fabs(s8[lane] - s4[lane]), std::fabs(c8[lane] - c4[lane]))));
+	}
+
+	return difference;
+}
+
+
+int main()
+{
+	bool passed = true;
+	const size_t samples = 1 << 24;
+
+	double sinError, cosError;
+	MeasureSinCos4(3.14159265358979, samples, sinError, cosError);
+	passed &= Report("sin, |x| <= pi", sinError, SIN_COS_MAX_ABS_ERROR);
+	passed &= Report("cos, |x| <= pi", cosError, SIN_COS_MAX_ABS_ERROR);
+
+	MeasureSinCos4(SIN_COS_RANGE, samples, sinError, cosError);
+	passed &= Report("sin, |x| <= 8192", sinError, SIN_COS_MAX_ABS_ERROR);
+	passed &= Report("cos, |x| <= 8192", cosError, SIN_COS_MAX_ABS_ERROR);
+
+	if (HasAvx2Fma())
+		passed &= Report("8 lanes vs 4 lanes", MeasureSinCos8Difference(SIN_COS_RANGE, samples), 0.0);
+	else
+		printf("%-36s skipped, no AVX2/FMA\n", "8 lanes vs 4 lanes");
+
+	// Reciprocal square root, log-uniform over normal floats.
+	std::mt19937 random(7);
+	std::uniform_real_distribution<double> exponent(-120.0, 120.0);
+	double rsqrtError = 0.0;
+
+	for (size_t i = 0; i < samples / 4; i++)
+	{
+		alignas(16) float x[4], y[4];
+		for (int lane = 0; lane < 4; lane++)
+			x[lane] = static_cast<float>(std::pow(2.0, exponent(random)));
+
+		_mm_store_ps(y, ReciprocalSqrt(_mm_load_ps(x)));
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			double expected = 1.0 / std::sqrt(static_cast<double>(x[lane]));
+			rsqrtError = std::max(rsqrtError, std::fabs(y[lane] - expected) / expected);
+		}
+	}
+	passed &= Report("reciprocal sqrt, relative", rsqrtError, RECIPROCAL_SQRT_MAX_REL_ERROR);
+
+	// Normalize, dot and cross against glm.
+	std::uniform_real_distribution<float> coordinate(-1000.0f, 1000.0f);
+	double lengthError = 0.0, dotDifference = 0.0, crossDifference = 0.0;
+
+	for (size_t i = 0; i < samples / 16; i++)
+	{
+		glm::vec3 a[4], b[4];
+		alignas(16) float ax[4], ay[4], az[4], bx[4], by[4], bz[4];
+		for (int lane = 0; lane < 4; lane++)
+		{
+			a[lane] = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+			b[lane] = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+			ax[lane] = a[lane].x; ay[lane] = a[lane].y; az[lane] = a[lane].z;
+			bx[lane] = b[lane].x; by[lane] = b[lane].y; bz[lane] = b[lane].z;
+		}
+
+		Vec3x4 va = { _mm_load_ps(ax), _mm_load_ps(ay), _mm_load_ps(az) };
+		Vec3x4 vb = { _mm_load_ps(bx), _mm_load_ps(by), _mm_load_ps(bz) };
+
+		alignas(16) float nx[4], ny[4], nz[4], d[4], cx[4], cy[4], cz[4];
+		Vec3x4 n = Normalize(va);
+		_mm_store_ps(nx, n.X); _mm_store_ps(ny, n.Y); _mm_store_ps(nz, n.Z);
+		_mm_store_ps(d, Dot(va, vb));
+		Vec3x4 c = Cross(va, vb);
+		_mm_store_ps(cx, c.X); _mm_store_ps(cy, c.Y); _mm_store_ps(cz, c.Z);
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			double length = std::sqrt(static_cast<double>(nx[lane]) * nx[lane] + static_cast<double>(ny[lane]) * ny[lane] + static_cast<double>(nz[lane]) * nz[lane]);
+			lengthError = std::max(lengthError, std::fabs(length - 1.0));
+
+			double scale = glm::length(a[lane]) * glm::length(b[lane]);
+			dotDifference = std::max(dotDifference, std::fabs(d[lane] - glm::dot(a[lane], b[lane])) / scale);
+
+			glm::vec3 cross = glm::cross(a[lane], b[lane]);
+			crossDifference = std::max(crossDifference, static_cast<double>(glm::length(glm::vec3(cx[lane], cy[lane], cz[lane]) - cross)) / scale);
+		}
+	}
+	passed &= Report("normalize, |length - 1|", lengthError, NORMALIZE_MAX_LENGTH_ERROR);
+	passed &= Report("dot vs glm, relative to |a||b|", dotDifference, 1e-6);
+	passed &= Report("cross vs glm, relative to |a||b|", crossDifference, 1e-6);
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+/* Scene transform update benchmark.
+
+   Compares building model matrices one at a time with glm::translate (what the
+   draw loop used to do) against TransformHierarchy updates for 1M nodes.
+
+   Build (from the repository root):
+     g++ -O2 -std=c++17 -pthread -IDependencies/includes -Isrc benchmarks/TransformHierarchyBenchmark.cpp
+         src/Scene/TransformHierarchy.cpp src/Jobs/JobSystem.cpp -o transform_benchmark
+*/
+
+#include "Scene/TransformHierarchy.h"
+
+#include "BenchmarkTiming.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <random>
+
+const size_t NODE_COUNT = 1000000;
+const int REPETITIONS = 10;
+
+
+int main()
+{
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+	std::vector<glm::vec3> positions(NODE_COUNT);
+	for (glm::vec3& position : positions)
+		position = glm::vec3(distribution(random), distribution(random), distribution(random));
+
+	// Baseline: one glm::translate per object.
+	std::vector<glm::mat4> matrices(NODE_COUNT);
+	double translateMs = Measure(REPETITIONS, [&]
+	{
+		for (size_t i = 0; i < NODE_COUNT; i++)
+			matrices[i] = glm::translate(glm::mat4(1.0f), positions[i]);
+	});
+
+	// Hierarchy: 1000 roots, every other node parented to a random earlier node.
+	TransformHierarchy hierarchy;
+	hierarchy.Reserve(NODE_COUNT);
+
+	for (size_t i = 0; i < NODE_COUNT; i++)
+	{
+		int32_t parent = i < 1000 ? -1 : static_cast<int32_t>(random() % i);
+		hierarchy.AddNode(parent, positions[i]);
+	}
+	hierarchy.SortByDepth();
+
+	auto markAllDirty = [&]
+	{
+		for (size_t i = 0; i < NODE_COUNT; i++)
+			hierarchy.SetLocalPosition(static_cast<int32_t>(i), positions[i]);
+	};
+
+	JobSystem singleThread(1);
+	JobSystem allThreads;
+
+	double serialMs = Measure(REPETITIONS, [&] { markAllDirty(); hierarchy.Update(singleThread); });
+	double markMs = Measure(REPETITIONS, markAllDirty);
+	double parallelMs = Measure(REPETITIONS, [&] { markAllDirty(); hierarchy.Update(allThreads); });
+
+	// 1% of the nodes move per frame.
+	double partialMs = Measure(REPETITIONS, [&]
+	{
+		for (size_t i = 0; i < NODE_COUNT; i += 100)
+			hierarchy.SetLocalPosition(static_cast<int32_t>(i), positions[i]);
+		hierarchy.Update(allThreads);
+	});
+
+	double idleMs = Measure(REPETITIONS, [&] { hierarchy.Update(allThreads); });
+
+	std::cout << "Nodes: " << NODE_COUNT << "\n";
+	std::cout << "glm::translate per object:       " << translateMs << " ms\n";
+	std::cout << "Hierarchy, all dirty, " << singleThread.GetThreadCount() << " threads:  " << serialMs - markMs << " ms\n";
+	std::cout << "Hierarchy, all dirty, " << allThreads.GetThreadCount() << " threads:  " << parallelMs - markMs << " ms\n";
+	std::cout << "Hierarchy, 1% dirty:             " << partialMs << " ms\n";
+	std::cout << "Hierarchy, nothing dirty:        " << idleMs << " ms\n";
+
+	return 0;
+}
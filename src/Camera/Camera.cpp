@@ -1,8 +1,12 @@
 #include "Camera.h"
 
+#include "../Math/SimdMath.h"
+
+#include <cmath>
+
 Camera::Camera(vec3 position, vec3 up, float yaw, float pitch)
 {
-	Position = position;
+	Position = dvec3(position);
 	WorldUp = up;
 	Yaw = yaw;
 	Pitch = pitch;
@@ -11,6 +15,7 @@ Camera::Camera(vec3 position, vec3 up, float yaw, float pitch)
 	MovementSpeed = MOVEMENT_SPEED;
 	MouseSensitivity = MOUSE_SENSITIVITY;
 	MouseZoomFOV = DEFAULT_FOV;
+	Generation = 0;
 
 	UpdateCameraVectors();
 }
@@ -18,7 +23,7 @@ Camera::Camera(vec3 position, vec3 up, float yaw, float pitch)
 
 Camera::Camera(float posX, float posY, float posZ, float upX, float upY, float upZ, float yaw, float pitch)
 {
-	Position = vec3(posX, posY, posZ);
+	Position = dvec3(posX, posY, posZ);
 	WorldUp = vec3(upX, upY, upZ);
 	Yaw = yaw;
 	Pitch = pitch;
@@ -27,13 +32,14 @@ Camera::Camera(float posX, float posY, float posZ, float upX, float upY, float u
 	MovementSpeed = MOVEMENT_SPEED;
 	MouseSensitivity = MOUSE_SENSITIVITY;
 	MouseZoomFOV = DEFAULT_FOV;
+	Generation = 0;
 
 	UpdateCameraVectors();
 }
 
 Camera::Camera()
 {
-	Position = vec3(0.0f, 0.0f, 3.0f);
+	Position = dvec3(0.0, 0.0, 3.0);
 	WorldUp = DEFAULT_WORLD_UP;
 	Yaw = YAW;
 	Pitch = PITCH;
@@ -42,6 +48,7 @@ Camera::Camera()
 	MovementSpeed = MOVEMENT_SPEED;
 	MouseSensitivity = MOUSE_SENSITIVITY;
 	MouseZoomFOV = DEFAULT_FOV;
+	Generation = 0;
 
 	UpdateCameraVectors();
 }
@@ -49,7 +56,39 @@ Camera::Camera()
 
 glm::mat4 Camera::GetViewMatrix() const
 {
-	return glm::lookAt(Position, Position + Front, Up);
+	vec3 position = vec3(Position);
+	return glm::lookAt(position, position + Front, Up);
+}
+
+
+glm::mat4 Camera::GetViewMatrixRelativeTo(const dvec3& origin) const
+{
+	vec3 position = vec3(Position - origin);
+	return glm::lookAt(position, position + Front, Up);
+}
+
+
+void Camera::SetState(const dvec3& position, float yaw, float pitch, float fov)
+{
+	if (position == Position && yaw == Yaw && pitch == Pitch && fov == MouseZoomFOV)
+		return;
+
+	Generation++;
+	Position = position;
+	Yaw = yaw;
+	Pitch = pitch;
+	MouseZoomFOV = fov;
+
+	UpdateCameraVectors();
+}
+
+
+void Camera::SetPosition(const dvec3& position)
+{
+	if (position != Position)
+		Generation++;
+
+	Position = position;
 }
 
 
@@ -58,24 +97,43 @@ void Camera::ProcessKeyboard(Camera_Movement direction, float deltaTime)
 	 
 	float movementSpeed = MovementSpeed * deltaTime;
 
+	if (movementSpeed != 0.0f && direction <= RIGHT)
+		Generation++;
+
 	if (direction == FORWARD)
-		Position += Front * movementSpeed;
+		Position += dvec3(Front * movementSpeed);
 
 	if (direction == BACKWARD)
-		Position -= Front * movementSpeed;
+		Position -= dvec3(Front * movementSpeed);
 
 	if (direction == LEFT)
-		Position -= Right * movementSpeed;
+		Position -= dvec3(Right * movementSpeed);
 
 	if (direction == RIGHT)
-		Position += Right * movementSpeed;
+		Position += dvec3(Right * movementSpeed);
+}
+
+
+void Camera::ProcessKeyboardMask(unsigned int directionMask, float deltaTime)
+{
+	const Camera_Movement directions[] = { FORWARD, BACKWARD, LEFT, RIGHT };
+
+	for (Camera_Movement direction : directions)
+	{
+		if (directionMask & MOVEMENT_BIT(direction))
+			ProcessKeyboard(direction, deltaTime);
+	}
 }
 
 
 void Camera::ProcessMouseInput(float xOffset, float yOffset, GLboolean constrainPitch)
 {
+	if (xOffset == 0.0f && yOffset == 0.0f)
+		return;
+
 	xOffset *= MouseSensitivity;
 	yOffset *= MouseSensitivity;
+	Generation++;
 
 	Yaw += xOffset;
 	Pitch += yOffset;
@@ -96,6 +154,8 @@ void Camera::ProcessMouseInput(float xOffset, float yOffset, GLboolean constrain
 
 void Camera::ProcessMouseScroll(const float yOffset)
 {
+	float previousFOV = MouseZoomFOV;
+
 	MouseZoomFOV -= yOffset;
 
 	if (MouseZoomFOV < 1.0f)
@@ -103,15 +163,28 @@ void Camera::ProcessMouseScroll(const float yOffset)
 
 	if (MouseZoomFOV > 45.0f)
 		MouseZoomFOV = 45.0f;
+
+	// Scrolling against a limit doesn't change the view.
+	if (MouseZoomFOV != previousFOV)
+		Generation++;
 }
 
 
 void Camera::UpdateCameraVectors()
 {
+	// Sine and cosine of yaw and pitch in one call. Yaw is wrapped first, it
+	// grows without bound and SinCos is only accurate for moderate angles.
+	alignas(16) float sines[4];
+	alignas(16) float cosines[4];
+	__m128 sinValues, cosValues;
+	SinCos(_mm_setr_ps(glm::radians(std::fmod(Yaw, 360.0f)), glm::radians(Pitch), 0.0f, 0.0f), sinValues, cosValues);
+	_mm_store_ps(sines, sinValues);
+	_mm_store_ps(cosines, cosValues);
+
 	vec3 newFront;
-	newFront.x = cos(glm::radians(Yaw)) * cos(glm::radians(Pitch));
-	newFront.y = sin(glm::radians(Pitch));
-	newFront.z = sin(glm::radians(Yaw)) * cos(glm::radians(Pitch));
+	newFront.x = cosines[0] * cosines[1];
+	newFront.y = sines[1];
+	newFront.z = sines[0] * cosines[1];
 
 	Front = glm::normalize(newFront);
 
@@ -7,6 +7,7 @@
 #include <vector>
 
 using glm::vec3;
+using glm::dvec3;
 
 /* Define several possible options for camera movement.
    Used as abstraction to stay away form window-system specific input methods
@@ -16,9 +17,16 @@ enum Camera_Movement
 	FORWARD,
 	BACKWARD,
 	LEFT, 
-	RIGHT
+	RIGHT,
+
+	// Only used by controllers that move along the camera's up axis.
+	UP,
+	DOWN
 };
 
+// Bit of a direction in a movement mask.
+#define MOVEMENT_BIT(direction) (1u << (direction))
+
 // Default Camera values.
 #define YAW -90.0f
 #define PITCH 0.0f
@@ -37,7 +45,8 @@ class Camera
 private:
 
 	// Camera attributes.
-	vec3 Position;
+	// Position is kept in double so large worlds can be rendered camera-relative.
+	dvec3 Position;
 	vec3 Front;
 	vec3 Up;
 	vec3 Right;
@@ -52,6 +61,9 @@ private:
 	float MouseSensitivity;
 	float MouseZoomFOV;
 
+	// Bumped whenever position, orientation or zoom change.
+	unsigned long long Generation;
+
 public:
 
 	/* Constructor with vectors. */
@@ -66,12 +78,40 @@ public:
 	// Get View Matrix
 	glm::mat4 GetViewMatrix() const;
 
+	// Get View Matrix for a world shifted so that origin is at (0, 0, 0).
+	// Used with model transforms made relative to origin in double precision.
+	glm::mat4 GetViewMatrixRelativeTo(const dvec3& origin) const;
+
+	// Get World Position (double precision).
+	dvec3 GetPosition() const { return Position; }
+
+	// Get Camera basis.
+	vec3 GetFront() const { return Front; }
+	vec3 GetRight() const { return Right; }
+	vec3 GetUp() const { return Up; }
+
 	// Get Current FOV
 	float GetCurrentFOV() const { return MouseZoomFOV; }
 
+	// Get Euler angles.
+	float GetYaw() const { return Yaw; }
+	float GetPitch() const { return Pitch; }
+
+	// Restore position, orientation and zoom (used by replay).
+	void SetState(const dvec3& position, float yaw, float pitch, float fov);
+
+	// Move without turning; the camera basis stays valid.
+	void SetPosition(const dvec3& position);
+
+	// Changes when the view changes; equal generations mean an identical view.
+	unsigned long long GetGeneration() const { return Generation; }
+
 	// Process Keyboard Input.
 	void ProcessKeyboard(Camera_Movement direction, float deltaTime);
 
+	// Process all pressed directions of a MOVEMENT_BIT mask.
+	void ProcessKeyboardMask(unsigned int directionMask, float deltaTime);
+
 	// Handle Mouse Input
 	void ProcessMouseInput(float xOffset, float yOffset, GLboolean constrainPitch = true);
 
@@ -0,0 +1,298 @@
+#include "CameraBatch.h"
+
+#include "../Math/SimdMath.h"
+
+#include <cmath>
+
+#pragma region CameraSlot
+
+glm::mat4 CameraSlot::GetViewMatrix() const
+{
+	return GetViewMatrixRelativeTo(dvec3(0.0));
+}
+
+
+glm::mat4 CameraSlot::GetViewMatrixRelativeTo(const dvec3& origin) const
+{
+	vec3 position = vec3(GetPosition() - origin);
+	return glm::lookAt(position, position + GetFront(), GetUp());
+}
+
+
+dvec3 CameraSlot::GetPosition() const
+{
+	return dvec3(Batch->PositionX[Index], Batch->PositionY[Index], Batch->PositionZ[Index]);
+}
+
+
+vec3 CameraSlot::GetFront() const
+{
+	return vec3(Batch->FrontX[Index], Batch->FrontY[Index], Batch->FrontZ[Index]);
+}
+
+
+vec3 CameraSlot::GetRight() const
+{
+	return vec3(Batch->RightX[Index], Batch->RightY[Index], Batch->RightZ[Index]);
+}
+
+
+vec3 CameraSlot::GetUp() const
+{
+	return vec3(Batch->UpX[Index], Batch->UpY[Index], Batch->UpZ[Index]);
+}
+
+
+float CameraSlot::GetCurrentFOV() const
+{
+	return Batch->FOV[Index];
+}
+
+
+float CameraSlot::GetYaw() const
+{
+	return Batch->Yaw[Index];
+}
+
+
+float CameraSlot::GetPitch() const
+{
+	return Batch->Pitch[Index];
+}
+
+
+void CameraSlot::SetState(const dvec3& position, float yaw, float pitch, float fov)
+{
+	Batch->PositionX[Index] = position.x;
+	Batch->PositionY[Index] = position.y;
+	Batch->PositionZ[Index] = position.z;
+	Batch->Yaw[Index] = yaw;
+	Batch->Pitch[Index] = pitch;
+	Batch->FOV[Index] = fov;
+}
+
+
+void CameraSlot::ProcessKeyboard(Camera_Movement direction, float deltaTime)
+{
+	ProcessKeyboardMask(MOVEMENT_BIT(direction), deltaTime);
+}
+
+
+void CameraSlot::ProcessKeyboardMask(unsigned int directionMask, float deltaTime)
+{
+	float movementSpeed = Batch->MovementSpeed * deltaTime;
+	vec3 movement(0.0f);
+
+	if (directionMask & MOVEMENT_BIT(FORWARD))
+		movement += GetFront();
+
+	if (directionMask & MOVEMENT_BIT(BACKWARD))
+		movement -= GetFront();
+
+	if (directionMask & MOVEMENT_BIT(LEFT))
+		movement -= GetRight();
+
+	if (directionMask & MOVEMENT_BIT(RIGHT))
+		movement += GetRight();
+
+	movement *= movementSpeed;
+	Batch->PositionX[Index] += movement.x;
+	Batch->PositionY[Index] += movement.y;
+	Batch->PositionZ[Index] += movement.z;
+}
+
+
+void CameraSlot::ProcessMouseInput(float xOffset, float yOffset, bool constrainPitch)
+{
+	float& yaw = Batch->Yaw[Index];
+	float& pitch = Batch->Pitch[Index];
+
+	yaw += xOffset * Batch->MouseSensitivity;
+	pitch += yOffset * Batch->MouseSensitivity;
+
+	if (constrainPitch)
+	{
+		if (pitch > 89.0f)
+			pitch = 89.0f;
+
+		if (pitch < -89.0f)
+			pitch = -89.0f;
+	}
+}
+
+
+void CameraSlot::ProcessMouseScroll(float yOffset)
+{
+	float& fov = Batch->FOV[Index];
+	fov -= yOffset;
+
+	if (fov < 1.0f)
+		fov = 1.0f;
+
+	if (fov > 45.0f)
+		fov = 45.0f;
+}
+
+
+void CameraSlot::CopyTo(Camera& camera) const
+{
+	camera.SetState(GetPosition(), GetYaw(), GetPitch(), GetCurrentFOV());
+}
+
+#pragma endregion
+
+
+#pragma region CameraBatch
+
+CameraBatch::CameraBatch(const ProjectionSettings& projection, vec3 worldUp)
+{
+	Count = 0;
+	WorldUp = worldUp;
+	MovementSpeed = MOVEMENT_SPEED;
+	MouseSensitivity = MOUSE_SENSITIVITY;
+	Projection = projection;
+}
+
+
+void CameraBatch::Reserve(size_t count)
+{
+	count = (count + CAMERA_BATCH_SIMD_WIDTH - 1) / CAMERA_BATCH_SIMD_WIDTH * CAMERA_BATCH_SIMD_WIDTH;
+
+	for (std::vector<double>* values : { &PositionX, &PositionY, &PositionZ })
+		values->reserve(count);
+
+	for (std::vector<float>* values : { &Yaw, &Pitch, &FOV, &Aspect, &FrontX, &FrontY, &FrontZ, &RightX, &RightY, &RightZ, &UpX, &UpY, &UpZ })
+		values->reserve(count);
+
+	ViewMatrices.reserve(count);
+	ProjectionMatrices.reserve(count);
+}
+
+
+size_t CameraBatch::Add(const dvec3& position, float yaw, float pitch, float fov, float aspect)
+{
+	size_t index = Count++;
+
+	// Grow by a whole SIMD group, padding lanes hold a valid default camera.
+	if (index % CAMERA_BATCH_SIMD_WIDTH == 0)
+	{
+		size_t padded = index + CAMERA_BATCH_SIMD_WIDTH;
+
+		for (std::vector<double>* values : { &PositionX, &PositionY, &PositionZ })
+			values->resize(padded, 0.0);
+
+		Yaw.resize(padded, YAW);
+		Pitch.resize(padded, PITCH);
+		FOV.resize(padded, DEFAULT_FOV);
+		Aspect.resize(padded, 1.0f);
+
+		for (std::vector<float>* values : { &FrontX, &FrontY, &FrontZ, &RightX, &RightY, &RightZ, &UpX, &UpY, &UpZ })
+			values->resize(padded, 0.0f);
+
+		ViewMatrices.resize(padded, glm::mat4(1.0f));
+		ProjectionMatrices.resize(padded, glm::mat4(1.0f));
+	}
+
+	PositionX[index] = position.x;
+	PositionY[index] = position.y;
+	PositionZ[index] = position.z;
+	Yaw[index] = yaw;
+	Pitch[index] = pitch;
+	FOV[index] = fov;
+	Aspect[index] = aspect;
+
+	UpdateLanes(index - index % CAMERA_BATCH_SIMD_WIDTH, dvec3(0.0));
+	return index;
+}
+
+
+size_t CameraBatch::Add(const Camera& camera, float aspect)
+{
+	return Add(camera.GetPosition(), camera.GetYaw(), camera.GetPitch(), camera.GetCurrentFOV(), aspect);
+}
+
+
+void CameraBatch::Update(const dvec3& origin)
+{
+	for (size_t base = 0; base < Count; base += CAMERA_BATCH_SIMD_WIDTH)
+		UpdateLanes(base, origin);
+}
+
+
+void CameraBatch::UpdateLanes(size_t base, const dvec3& origin)
+{
+	const __m128 degreesToRadians = _mm_set1_ps(0.01745329251994329577f);
+	const __m128 zero = _mm_setzero_ps();
+
+	// Front from yaw and pitch, as Camera::UpdateCameraVectors.
+	// Yaw grows without bound, whole turns are removed before SinCos.
+	__m128 yaw = _mm_loadu_ps(&Yaw[base]);
+	yaw = _mm_sub_ps(yaw, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(yaw, _mm_set1_ps(1.0f / 360.0f)))), _mm_set1_ps(360.0f)));
+
+	__m128 sinYaw, cosYaw, sinPitch, cosPitch;
+	SinCos(_mm_mul_ps(yaw, degreesToRadians), sinYaw, cosYaw);
+	SinCos(_mm_mul_ps(_mm_loadu_ps(&Pitch[base]), degreesToRadians), sinPitch, cosPitch);
+
+	Vec3x4 front = { _mm_mul_ps(cosYaw, cosPitch), sinPitch, _mm_mul_ps(sinYaw, cosPitch) };
+	front = Normalize(front);
+
+	Vec3x4 right = Normalize(Cross(front, Broadcast4(WorldUp.x, WorldUp.y, WorldUp.z)));
+
+	// Orthonormal already, no normalization needed.
+	Vec3x4 up = Cross(right, front);
+
+	_mm_storeu_ps(&FrontX[base], front.X); _mm_storeu_ps(&FrontY[base], front.Y); _mm_storeu_ps(&FrontZ[base], front.Z);
+	_mm_storeu_ps(&RightX[base], right.X); _mm_storeu_ps(&RightY[base], right.Y); _mm_storeu_ps(&RightZ[base], right.Z);
+	_mm_storeu_ps(&UpX[base], up.X); _mm_storeu_ps(&UpY[base], up.Y); _mm_storeu_ps(&UpZ[base], up.Z);
+
+	// Eye relative to origin, subtracted in double precision.
+	Vec3x4 eye;
+	eye.X = _mm_movelh_ps(_mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(&PositionX[base]), _mm_set1_pd(origin.x))),
+		_mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(&PositionX[base + 2]), _mm_set1_pd(origin.x))));
+	eye.Y = _mm_movelh_ps(_mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(&PositionY[base]), _mm_set1_pd(origin.y))),
+		_mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(&PositionY[base + 2]), _mm_set1_pd(origin.y))));
+	eye.Z = _mm_movelh_ps(_mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(&PositionZ[base]), _mm_set1_pd(origin.z))),
+		_mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(&PositionZ[base + 2]), _mm_set1_pd(origin.z))));
+
+	// glm::lookAt rows: side (= Right), up, -front; translation from the eye.
+	__m128 tx = _mm_sub_ps(zero, Dot(right, eye));
+	__m128 ty = _mm_sub_ps(zero, Dot(up, eye));
+	__m128 tz = Dot(front, eye);
+
+	// Transposing (row values x 4 lanes) gives one matrix column per lane.
+	__m128 columns[4][4] = {
+		{ right.X, up.X, _mm_sub_ps(zero, front.X), zero },
+		{ right.Y, up.Y, _mm_sub_ps(zero, front.Y), zero },
+		{ right.Z, up.Z, _mm_sub_ps(zero, front.Z), zero },
+		{ tx, ty, tz, _mm_set1_ps(1.0f) }
+	};
+
+	for (int column = 0; column < 4; column++)
+	{
+		__m128* lanes = columns[column];
+		_MM_TRANSPOSE4_PS(lanes[0], lanes[1], lanes[2], lanes[3]);
+
+		for (int lane = 0; lane < CAMERA_BATCH_SIMD_WIDTH; lane++)
+			_mm_storeu_ps(&ViewMatrices[base + lane][column][0], lanes[lane]);
+	}
+
+	// Projection: only the focal lengths differ between cameras.
+	__m128 sinHalfFov, cosHalfFov;
+	SinCos(_mm_mul_ps(_mm_loadu_ps(&FOV[base]), _mm_set1_ps(0.5f * 0.01745329251994329577f)), sinHalfFov, cosHalfFov);
+
+	alignas(16) float focalY[CAMERA_BATCH_SIMD_WIDTH];
+	alignas(16) float focalX[CAMERA_BATCH_SIMD_WIDTH];
+	__m128 focal = _mm_div_ps(cosHalfFov, sinHalfFov);
+	_mm_store_ps(focalY, focal);
+	_mm_store_ps(focalX, _mm_div_ps(focal, _mm_loadu_ps(&Aspect[base])));
+
+	glm::mat4 projection = BuildProjectionMatrix(Projection, DEFAULT_FOV, 1.0f);
+	for (int lane = 0; lane < CAMERA_BATCH_SIMD_WIDTH; lane++)
+	{
+		projection[0][0] = focalX[lane];
+		projection[1][1] = focalY[lane];
+		ProjectionMatrices[base + lane] = projection;
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Camera.h"
+#include "Projection.h"
+
+#include <cstddef>
+#include <vector>
+
+// Cameras updated together in SIMD lanes. Arrays are padded to a multiple.
+#define CAMERA_BATCH_SIMD_WIDTH 4
+
+class CameraBatch;
+
+/* One camera of a CameraBatch, with the Camera API.
+
+   Changes to orientation and zoom are stored right away, the basis vectors
+   (and the matrices derived from them) follow with the next CameraBatch::Update().
+*/
+class CameraSlot
+{
+private:
+
+	CameraBatch* Batch;
+	size_t Index;
+
+public:
+
+	CameraSlot(CameraBatch& batch, size_t index) : Batch(&batch), Index(index) {}
+
+	glm::mat4 GetViewMatrix() const;
+	glm::mat4 GetViewMatrixRelativeTo(const dvec3& origin) const;
+
+	dvec3 GetPosition() const;
+	vec3 GetFront() const;
+	vec3 GetRight() const;
+	vec3 GetUp() const;
+	float GetCurrentFOV() const;
+	float GetYaw() const;
+	float GetPitch() const;
+
+	void SetState(const dvec3& position, float yaw, float pitch, float fov);
+
+	void ProcessKeyboard(Camera_Movement direction, float deltaTime);
+	void ProcessKeyboardMask(unsigned int directionMask, float deltaTime);
+	void ProcessMouseInput(float xOffset, float yOffset, bool constrainPitch = true);
+	void ProcessMouseScroll(float yOffset);
+
+	// Copy the slot's state into a standalone camera.
+	void CopyTo(Camera& camera) const;
+
+	size_t GetIndex() const { return Index; }
+};
+
+/* Many cameras stored as structure of arrays (shadow cascades, probe captures,
+   agent view frusta, ...).
+
+   Update() recomputes the basis vectors, view and projection matrices of all
+   cameras in one pass, CAMERA_BATCH_SIMD_WIDTH cameras at a time with the
+   SimdMath kernels. Positions are double precision like Camera's; view
+   matrices are built relative to an origin as with GetViewMatrixRelativeTo.
+*/
+class CameraBatch
+{
+private:
+
+	friend class CameraSlot;
+
+	size_t Count;
+
+	// Camera state.
+	std::vector<double> PositionX, PositionY, PositionZ;
+	std::vector<float> Yaw, Pitch, FOV, Aspect;
+
+	// Derived basis, valid after Update().
+	std::vector<float> FrontX, FrontY, FrontZ;
+	std::vector<float> RightX, RightY, RightZ;
+	std::vector<float> UpX, UpY, UpZ;
+
+	std::vector<glm::mat4> ViewMatrices;
+	std::vector<glm::mat4> ProjectionMatrices;
+
+	// Shared by all cameras.
+	vec3 WorldUp;
+	float MovementSpeed;
+	float MouseSensitivity;
+	ProjectionSettings Projection;
+
+public:
+
+	explicit CameraBatch(const ProjectionSettings& projection = ProjectionSettings(), vec3 worldUp = DEFAULT_WORLD_UP);
+
+	void Reserve(size_t count);
+
+	// Append a camera and return its index. Its vectors are computed right away.
+	size_t Add(const dvec3& position, float yaw = YAW, float pitch = PITCH, float fov = DEFAULT_FOV, float aspect = 1.0f);
+	size_t Add(const Camera& camera, float aspect = 1.0f);
+
+	void SetAspect(size_t index, float aspect) { Aspect[index] = aspect; }
+	void SetProjectionSettings(const ProjectionSettings& projection) { Projection = projection; }
+
+	// Recompute vectors and matrices of all cameras. View matrices are relative to origin.
+	void Update(const dvec3& origin = dvec3(0.0));
+
+	CameraSlot operator[](size_t index) { return CameraSlot(*this, index); }
+
+	// Results of the last Update(), one per camera.
+	const glm::mat4* GetViewMatrices() const { return ViewMatrices.data(); }
+	const glm::mat4* GetProjectionMatrices() const { return ProjectionMatrices.data(); }
+
+	size_t Size() const { return Count; }
+
+private:
+
+	// Update cameras [base, base + CAMERA_BATCH_SIMD_WIDTH).
+	void UpdateLanes(size_t base, const dvec3& origin);
+};
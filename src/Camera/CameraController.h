@@ -0,0 +1,185 @@
+#pragma once
+
+#include "Camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+/* Camera controllers assembled from compile-time policies.
+
+   CameraController<Movement, Constraint, Smoothing> drives a Camera from a
+   MOVEMENT_BIT mask and mouse offsets, without virtual calls or per-key
+   branches:
+
+   Movement    turns the movement axes (right, up, forward in [-1, 1]) into a
+               change of position and orientation.
+   Constraint  limits the resulting state (pitch limit, ground lock).
+   Smoothing   filters the movement axes over time.
+
+   Policies can hold state (smoothed velocity); they are members of the
+   controller, so stateless ones cost nothing.
+
+   Orbiting a target, with inertia and zoom to the cursor, is OrbitCamera
+   (--orbit), not a movement policy.
+*/
+
+// Camera state a controller works on, written back with Camera::SetState.
+struct ControllerState
+{
+	dvec3 Position;
+	float Yaw;
+	float Pitch;
+};
+
+// Movement axes of a MOVEMENT_BIT mask: x = right, y = up, z = forward.
+inline vec3 GetMovementAxes(unsigned int directionMask)
+{
+	return vec3(
+		static_cast<float>((directionMask >> RIGHT) & 1u) - static_cast<float>((directionMask >> LEFT) & 1u),
+		static_cast<float>((directionMask >> UP) & 1u) - static_cast<float>((directionMask >> DOWN) & 1u),
+		static_cast<float>((directionMask >> FORWARD) & 1u) - static_cast<float>((directionMask >> BACKWARD) & 1u));
+}
+
+
+#pragma region Movement
+
+// Free flight along the view direction, like Camera::ProcessKeyboardMask.
+struct FlyMovement
+{
+	void Move(ControllerState& state, const vec3& axes, float distance, const Camera& camera) const
+	{
+		state.Position += dvec3((camera.GetFront() * axes.z + camera.GetRight() * axes.x) * distance);
+	}
+};
+
+// Walking: forward and strafing stay in the ground plane wherever the camera looks.
+struct GroundMovement
+{
+	void Move(ControllerState& state, const vec3& axes, float distance, const Camera& camera) const
+	{
+		vec3 front = camera.GetFront();
+		vec3 forward = glm::normalize(vec3(front.x, 0.0f, front.z));
+		vec3 right = glm::normalize(vec3(camera.GetRight().x, 0.0f, camera.GetRight().z));
+
+		state.Position += dvec3((forward * axes.z + right * axes.x) * distance);
+	}
+};
+
+// Translation along all three camera axes. Camera has no roll, so rotation
+// stays yaw and pitch.
+struct SixDofMovement
+{
+	void Move(ControllerState& state, const vec3& axes, float distance, const Camera& camera) const
+	{
+		state.Position += dvec3((camera.GetFront() * axes.z + camera.GetRight() * axes.x + camera.GetUp() * axes.y) * distance);
+	}
+};
+
+#pragma endregion
+
+
+#pragma region Constraint
+
+struct PitchLimit
+{
+	float MaxPitch = 89.0f;
+
+	void Apply(ControllerState& state) const
+	{
+		state.Pitch = std::min(std::max(state.Pitch, -MaxPitch), MaxPitch);
+	}
+};
+
+// First person: pitch limited and the eye kept at a fixed height.
+struct GroundLock
+{
+	double EyeHeight = 1.7;
+	float MaxPitch = 89.0f;
+
+	void Apply(ControllerState& state) const
+	{
+		state.Pitch = std::min(std::max(state.Pitch, -MaxPitch), MaxPitch);
+		state.Position.y = EyeHeight;
+	}
+};
+
+#pragma endregion
+
+
+#pragma region Smoothing
+
+struct NoSmoothing
+{
+	vec3 Filter(const vec3& axes, float) { return axes; }
+};
+
+// Axes approach the pressed directions exponentially, so starts and stops ease.
+struct ExponentialSmoothing
+{
+	// Per second; higher is snappier.
+	float Sharpness = 12.0f;
+	vec3 Current = vec3(0.0f);
+
+	vec3 Filter(const vec3& axes, float deltaTime)
+	{
+		Current += (axes - Current) * (1.0f - std::exp(-Sharpness * deltaTime));
+		return Current;
+	}
+};
+
+#pragma endregion
+
+
+template <typename Movement, typename Constraint, typename Smoothing>
+class CameraController
+{
+private:
+
+	Movement MovementModel;
+	Constraint Constraints;
+	Smoothing Smoother;
+
+	float MovementSpeed;
+	float MouseSensitivity;
+
+public:
+
+	explicit CameraController(float movementSpeed = MOVEMENT_SPEED, float mouseSensitivity = MOUSE_SENSITIVITY)
+		: MovementSpeed(movementSpeed), MouseSensitivity(mouseSensitivity)
+	{
+	}
+
+	// Move by all pressed directions of a MOVEMENT_BIT mask in one step.
+	void ProcessMovement(Camera& camera, unsigned int directionMask, float deltaTime)
+	{
+		ControllerState state = { camera.GetPosition(), camera.GetYaw(), camera.GetPitch() };
+
+		vec3 axes = Smoother.Filter(GetMovementAxes(directionMask), deltaTime);
+		MovementModel.Move(state, axes, MovementSpeed * deltaTime, camera);
+		Constraints.Apply(state);
+
+		// Translation only keeps the basis; skip recomputing it.
+		if (state.Yaw == camera.GetYaw() && state.Pitch == camera.GetPitch())
+			camera.SetPosition(state.Position);
+		else
+			camera.SetState(state.Position, state.Yaw, state.Pitch, camera.GetCurrentFOV());
+	}
+
+	// Turn by mouse offsets. Const, so it can be applied to a copy of the camera (late latching).
+	void ProcessMouseInput(Camera& camera, float xOffset, float yOffset) const
+	{
+		ControllerState state = { camera.GetPosition(), camera.GetYaw() + xOffset * MouseSensitivity, camera.GetPitch() + yOffset * MouseSensitivity };
+
+		Constraints.Apply(state);
+
+		camera.SetState(state.Position, state.Yaw, state.Pitch, camera.GetCurrentFOV());
+	}
+
+	Movement& GetMovement() { return MovementModel; }
+	Constraint& GetConstraint() { return Constraints; }
+	Smoothing& GetSmoothing() { return Smoother; }
+};
+
+typedef CameraController<FlyMovement, PitchLimit, NoSmoothing> FlyController;
+typedef CameraController<GroundMovement, GroundLock, ExponentialSmoothing> FpsController;
+typedef CameraController<SixDofMovement, PitchLimit, ExponentialSmoothing> SixDofController;
@@ -0,0 +1,200 @@
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Pitch limit of the sampled path, the same as mouse look.
+#define CAMERA_PATH_MAX_PITCH 89.0
+
+// Uniform Catmull-Rom between p1 and p2.
+template <typename T>
+static T CatmullRom(const T& p0, const T& p1, const T& p2, const T& p3, double t)
+{
+	double t2 = t * t;
+	double t3 = t2 * t;
+
+	return 0.5 * ((2.0 * p1)
+		+ (p2 - p0) * t
+		+ (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3) * t2
+		+ (3.0 * p1 - p0 - 3.0 * p2 + p3) * t3);
+}
+
+
+CameraPath::CameraPath()
+{
+	TotalLength = 0.0;
+}
+
+
+bool CameraPath::LoadFromFile(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::CAMERA_PATH::FILE_NOT_FOUND: " << path << std::endl;
+		return false;
+	}
+
+	Keyframes.clear();
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		line = line.substr(0, line.find('#'));
+
+		std::stringstream row(line);
+		CameraKeyframe keyframe;
+
+		if (row >> keyframe.Position.x >> keyframe.Position.y >> keyframe.Position.z >> keyframe.Yaw >> keyframe.Pitch)
+			AddKeyframe(keyframe);
+	}
+
+	if (Keyframes.size() < 2)
+	{
+		std::cout << "ERROR::CAMERA_PATH::NOT_ENOUGH_KEYFRAMES: " << path << std::endl;
+		return false;
+	}
+
+	Build();
+	return true;
+}
+
+
+void CameraPath::AddKeyframe(const CameraKeyframe& keyframe)
+{
+	CameraKeyframe unwrapped = keyframe;
+
+	if (!Keyframes.empty())
+	{
+		float previousYaw = Keyframes.back().Yaw;
+
+		while (unwrapped.Yaw - previousYaw > 180.0f)
+			unwrapped.Yaw -= 360.0f;
+
+		while (unwrapped.Yaw - previousYaw < -180.0f)
+			unwrapped.Yaw += 360.0f;
+	}
+
+	Keyframes.push_back(unwrapped);
+}
+
+
+void CameraPath::Build()
+{
+	SampleLengths.clear();
+	SampleParameters.clear();
+	TotalLength = 0.0;
+
+	if (Keyframes.size() < 2)
+		return;
+
+	size_t segments = Keyframes.size() - 1;
+	SampleLengths.reserve(segments * SAMPLES_PER_SEGMENT + 1);
+	SampleParameters.reserve(segments * SAMPLES_PER_SEGMENT + 1);
+
+	dvec3 previous = Keyframes[0].Position;
+	SampleLengths.push_back(0.0);
+	SampleParameters.push_back(0.0f);
+
+	for (size_t segment = 0; segment < segments; segment++)
+	{
+		for (int i = 1; i <= SAMPLES_PER_SEGMENT; i++)
+		{
+			float u = static_cast<float>(segment) + static_cast<float>(i) / SAMPLES_PER_SEGMENT;
+			dvec3 position = EvaluateAtParameter(u).Position;
+
+			TotalLength += glm::length(position - previous);
+			previous = position;
+
+			SampleLengths.push_back(TotalLength);
+			SampleParameters.push_back(u);
+		}
+	}
+}
+
+
+CameraKeyframe CameraPath::EvaluateAtParameter(float u) const
+{
+	// No segment to interpolate.
+	if (Keyframes.size() < 2)
+		return Keyframes.empty() ? CameraKeyframe() : Keyframes.front();
+
+	int last = static_cast<int>(Keyframes.size()) - 1;
+	u = std::min(std::max(u, 0.0f), static_cast<float>(last));
+
+	int segment = std::min(static_cast<int>(u), last - 1);
+	double t = u - segment;
+
+	// End points are duplicated so the curve passes through the first and last keyframe.
+	const CameraKeyframe& k0 = Keyframes[std::max(segment - 1, 0)];
+	const CameraKeyframe& k1 = Keyframes[segment];
+	const CameraKeyframe& k2 = Keyframes[segment + 1];
+	const CameraKeyframe& k3 = Keyframes[std::min(segment + 2, last)];
+
+	CameraKeyframe result;
+	result.Position = CatmullRom(k0.Position, k1.Position, k2.Position, k3.Position, t);
+	result.Yaw = static_cast<float>(CatmullRom<double>(k0.Yaw, k1.Yaw, k2.Yaw, k3.Yaw, t));
+
+	// The spline overshoots between keyframes, which could flip the view past straight up or down.
+	double pitch = CatmullRom<double>(k0.Pitch, k1.Pitch, k2.Pitch, k3.Pitch, t);
+	result.Pitch = static_cast<float>(std::min(std::max(pitch, -CAMERA_PATH_MAX_PITCH), CAMERA_PATH_MAX_PITCH));
+
+	return result;
+}
+
+
+CameraKeyframe CameraPath::EvaluateAtDistance(double distance) const
+{
+	if (SampleLengths.empty())
+		return Keyframes.empty() ? CameraKeyframe() : Keyframes.front();
+
+	distance = std::min(std::max(distance, 0.0), TotalLength);
+
+	// First sample at or past the distance, then interpolate the parameter linearly
+	// between it and the previous sample.
+	size_t upper = std::lower_bound(SampleLengths.begin(), SampleLengths.end(), distance) - SampleLengths.begin();
+	if (upper == 0)
+		return EvaluateAtParameter(0.0f);
+
+	size_t lower = upper - 1;
+	double span = SampleLengths[upper] - SampleLengths[lower];
+	double fraction = span > 0.0 ? (distance - SampleLengths[lower]) / span : 0.0;
+
+	float u = SampleParameters[lower] + static_cast<float>(fraction) * (SampleParameters[upper] - SampleParameters[lower]);
+	return EvaluateAtParameter(u);
+}
+
+
+CameraFlythrough::CameraFlythrough(const CameraPath& path, float speed, bool loop)
+{
+	Path = &path;
+	Distance = 0.0;
+	Speed = speed;
+	Loop = loop;
+}
+
+
+bool CameraFlythrough::Update(float deltaTime, Camera& camera)
+{
+	bool running = true;
+	Distance += static_cast<double>(Speed) * deltaTime;
+
+	if (Distance > Path->GetLength())
+	{
+		if (Loop && Path->GetLength() > 0.0)
+			Distance = fmod(Distance, Path->GetLength());
+		else
+		{
+			Distance = Path->GetLength();
+			running = false;
+		}
+	}
+
+	CameraKeyframe sample = Path->EvaluateAtDistance(Distance);
+	camera.SetState(sample.Position, sample.Yaw, sample.Pitch, camera.GetCurrentFOV());
+
+	return running;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Camera.h"
+
+#include <string>
+#include <vector>
+
+struct CameraKeyframe
+{
+	dvec3 Position;
+	float Yaw;
+	float Pitch;
+};
+
+/* Catmull-Rom spline through camera keyframes (position, yaw and pitch).
+
+   Build() precomputes an arc-length table, so sampling at a distance along the
+   path is a binary search over the table plus one spline evaluation, and the
+   camera moves at constant speed regardless of keyframe spacing.
+*/
+class CameraPath
+{
+private:
+
+	std::vector<CameraKeyframe> Keyframes;
+
+	// Arc-length table: cumulative length at every sample, and the spline
+	// parameter (segment index + local t) of that sample.
+	std::vector<double> SampleLengths;
+	std::vector<float> SampleParameters;
+
+	double TotalLength;
+
+public:
+
+	// Table samples per keyframe segment.
+	static const int SAMPLES_PER_SEGMENT = 32;
+
+	CameraPath();
+
+	// Load keyframes ("x y z yaw pitch" per line, '#' starts a comment) and build the table.
+	bool LoadFromFile(const std::string& path);
+
+	// Append a keyframe. Yaw is unwrapped to stay within 180 degrees of the previous one.
+	void AddKeyframe(const CameraKeyframe& keyframe);
+
+	// Precompute the arc-length table. Call after adding keyframes.
+	void Build();
+
+	double GetLength() const { return TotalLength; }
+	size_t GetKeyframeCount() const { return Keyframes.size(); }
+
+	// Evaluate at spline parameter u in [0, keyframes - 1]. With fewer than two
+	// keyframes, the keyframe (or a default one) for any u.
+	CameraKeyframe EvaluateAtParameter(float u) const;
+
+	// Evaluate at distance along the path in [0, GetLength()].
+	CameraKeyframe EvaluateAtDistance(double distance) const;
+};
+
+
+/* Moves a Camera along a CameraPath at constant speed. */
+class CameraFlythrough
+{
+private:
+
+	const CameraPath* Path;
+	double Distance;
+	float Speed;
+	bool Loop;
+
+public:
+
+	CameraFlythrough(const CameraPath& path, float speed, bool loop = false);
+
+	// Advance by deltaTime and set the camera. Returns false once the end is reached (never when looping).
+	bool Update(float deltaTime, Camera& camera);
+
+	void Restart() { Distance = 0.0; }
+
+	double GetDistance() const { return Distance; }
+};
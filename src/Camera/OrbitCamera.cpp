@@ -0,0 +1,178 @@
+#include "OrbitCamera.h"
+
+#include <algorithm>
+#include <cmath>
+
+OrbitCamera::OrbitCamera(const dvec3& target, double distance, float yaw, float pitch)
+{
+	Target = target;
+	DesiredTarget = target;
+	Distance = std::min(std::max(distance, ORBIT_MIN_DISTANCE), ORBIT_MAX_DISTANCE);
+	DesiredDistance = Distance;
+
+	Yaw = yaw;
+	Pitch = std::min(std::max(pitch, -ORBIT_MAX_PITCH), ORBIT_MAX_PITCH);
+
+	YawVelocity = 0.0f;
+	PitchVelocity = 0.0f;
+	PendingYaw = 0.0f;
+	PendingPitch = 0.0f;
+
+	MouseSensitivity = MOUSE_SENSITIVITY;
+	Damping = ORBIT_DAMPING;
+
+	// The first Update places the camera.
+	Settled = false;
+}
+
+
+void OrbitCamera::LookFrom(const Camera& camera, const dvec3& target)
+{
+	dvec3 offset = target - camera.GetPosition();
+	double length = glm::length(offset);
+
+	Target = target;
+	DesiredTarget = target;
+	Distance = std::min(std::max(length, ORBIT_MIN_DISTANCE), ORBIT_MAX_DISTANCE);
+	DesiredDistance = Distance;
+
+	if (length > 0.0)
+	{
+		dvec3 front = offset / length;
+		Yaw = static_cast<float>(glm::degrees(std::atan2(front.z, front.x)));
+		Pitch = std::min(std::max(static_cast<float>(glm::degrees(std::asin(front.y))), -ORBIT_MAX_PITCH), ORBIT_MAX_PITCH);
+	}
+
+	YawVelocity = 0.0f;
+	PitchVelocity = 0.0f;
+	Settled = false;
+}
+
+
+void OrbitCamera::SetTarget(const dvec3& target)
+{
+	DesiredTarget = target;
+	Settled = false;
+}
+
+
+void OrbitCamera::Rotate(float xOffset, float yOffset)
+{
+	// Dragging right turns the scene right, so the camera goes the other way.
+	PendingYaw -= xOffset * MouseSensitivity;
+	PendingPitch -= yOffset * MouseSensitivity;
+	Settled = false;
+}
+
+
+void OrbitCamera::GetBasis(vec3& front, vec3& right, vec3& up) const
+{
+	float yaw = glm::radians(Yaw);
+	float pitch = glm::radians(Pitch);
+
+	front = vec3(std::cos(yaw) * std::cos(pitch), std::sin(pitch), std::sin(yaw) * std::cos(pitch));
+	right = glm::normalize(glm::cross(front, DEFAULT_WORLD_UP));
+	up = glm::cross(right, front);
+}
+
+
+vec3 OrbitCamera::GetCursorRay(float cursorX, float cursorY, float fov, float aspect) const
+{
+	vec3 front, right, up;
+	GetBasis(front, right, up);
+
+	float tanHalfFov = std::tan(glm::radians(fov) * 0.5f);
+	return glm::normalize(front + right * (cursorX * tanHalfFov * aspect) + up * (cursorY * tanHalfFov));
+}
+
+
+void OrbitCamera::Zoom(float scroll, float cursorX, float cursorY, float fov, float aspect)
+{
+	vec3 front, right, up;
+	GetBasis(front, right, up);
+
+	// Point under the cursor on the plane through the target, facing the camera.
+	float tanHalfFov = std::tan(glm::radians(fov) * 0.5f);
+	dvec3 cursorPoint = DesiredTarget + dvec3(right * (cursorX * tanHalfFov * aspect) + up * (cursorY * tanHalfFov)) * DesiredDistance;
+
+	double distance = DesiredDistance * std::pow(static_cast<double>(ORBIT_ZOOM_STEP), static_cast<double>(scroll));
+	distance = std::min(std::max(distance, ORBIT_MIN_DISTANCE), ORBIT_MAX_DISTANCE);
+
+	// Moving the target toward the cursor point by the same fraction as the
+	// distance shrinks keeps that point fixed on screen. Target and distance
+	// ease with the same factor, so it stays fixed during the easing too.
+	DesiredTarget += (cursorPoint - DesiredTarget) * (1.0 - distance / DesiredDistance);
+	DesiredDistance = distance;
+	Settled = false;
+}
+
+
+bool OrbitCamera::Update(float deltaTime, bool dragging)
+{
+	// Nothing moves until the next drag, zoom or retarget.
+	if (Settled)
+		return false;
+
+	if (dragging)
+	{
+		// Follow the mouse exactly, and track its velocity for the release.
+		float follow = 1.0f - std::exp(-ORBIT_VELOCITY_SHARPNESS * deltaTime);
+		YawVelocity += (PendingYaw / deltaTime - YawVelocity) * follow;
+		PitchVelocity += (PendingPitch / deltaTime - PitchVelocity) * follow;
+
+		Yaw += PendingYaw;
+		Pitch += PendingPitch;
+	}
+	else
+	{
+		Yaw += YawVelocity * deltaTime;
+		Pitch += PitchVelocity * deltaTime;
+
+		float decay = std::exp(-Damping * deltaTime);
+		YawVelocity *= decay;
+		PitchVelocity *= decay;
+	}
+
+	PendingYaw = 0.0f;
+	PendingPitch = 0.0f;
+
+	Yaw = std::fmod(Yaw, 360.0f);
+	if (std::abs(Pitch) >= ORBIT_MAX_PITCH)
+	{
+		Pitch = std::min(std::max(Pitch, -ORBIT_MAX_PITCH), ORBIT_MAX_PITCH);
+		PitchVelocity = 0.0f;
+	}
+
+	float ease = 1.0f - std::exp(-ORBIT_ZOOM_SHARPNESS * deltaTime);
+	Distance += (DesiredDistance - Distance) * ease;
+	Target += (DesiredTarget - Target) * static_cast<double>(ease);
+
+	// Snap once the remaining motion is too small to see.
+	double tolerance = ORBIT_SETTLE_EPSILON * Distance;
+	if (std::abs(YawVelocity) < ORBIT_SETTLE_EPSILON && std::abs(PitchVelocity) < ORBIT_SETTLE_EPSILON
+		&& std::abs(DesiredDistance - Distance) < tolerance && glm::length(DesiredTarget - Target) < tolerance)
+	{
+		YawVelocity = 0.0f;
+		PitchVelocity = 0.0f;
+		Distance = DesiredDistance;
+		Target = DesiredTarget;
+		Settled = true;
+	}
+
+	return true;
+}
+
+
+dvec3 OrbitCamera::GetPosition() const
+{
+	vec3 front, right, up;
+	GetBasis(front, right, up);
+
+	return Target - dvec3(front) * Distance;
+}
+
+
+void OrbitCamera::Apply(Camera& camera) const
+{
+	camera.SetState(GetPosition(), Yaw, Pitch, camera.GetCurrentFOV());
+}
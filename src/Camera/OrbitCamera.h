@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Camera.h"
+
+/* Orbit (arcball) camera around a target point.
+
+   Dragging turns the camera around the target; scrolling zooms toward the
+   point under the cursor. After the drag ends the camera keeps turning with
+   the velocity of the drag, which decays exponentially. Zoom and retargeting
+   ease in the same way.
+
+   Update runs at the fixed timestep and returns false once all motion has
+   settled, so idle ticks leave the Camera (and its basis) alone.
+*/
+
+// Inertia decay per second after the drag ends.
+#define ORBIT_DAMPING 5.0f
+// How fast the drag velocity follows the mouse, per second. Holding the
+// mouse still before releasing stops the orbit.
+#define ORBIT_VELOCITY_SHARPNESS 30.0f
+// Distance and target easing per second.
+#define ORBIT_ZOOM_SHARPNESS 15.0f
+// Distance factor per scroll step.
+#define ORBIT_ZOOM_STEP 0.85f
+#define ORBIT_MIN_DISTANCE 0.1
+#define ORBIT_MAX_DISTANCE 1.0e6
+#define ORBIT_MAX_PITCH 89.0f
+// Below this (degrees per second, or fraction of the distance) motion stops.
+#define ORBIT_SETTLE_EPSILON 1.0e-3f
+
+class OrbitCamera
+{
+private:
+
+	dvec3 Target;
+	dvec3 DesiredTarget;
+	double Distance;
+	double DesiredDistance;
+
+	float Yaw;
+	float Pitch;
+
+	// Degrees per second.
+	float YawVelocity;
+	float PitchVelocity;
+
+	// Drag offsets (degrees) since the last Update.
+	float PendingYaw;
+	float PendingPitch;
+
+	float MouseSensitivity;
+	float Damping;
+
+	bool Settled;
+
+	// View basis at the current yaw and pitch.
+	void GetBasis(vec3& front, vec3& right, vec3& up) const;
+
+public:
+
+	OrbitCamera(const dvec3& target = dvec3(0.0), double distance = 5.0, float yaw = YAW, float pitch = PITCH);
+
+	// Orbit target from where camera stands, looking at it.
+	void LookFrom(const Camera& camera, const dvec3& target);
+
+	// Ease over to a new target, keeping the distance.
+	void SetTarget(const dvec3& target);
+
+	// Mouse offsets of a drag (Camera::ProcessMouseInput convention).
+	void Rotate(float xOffset, float yOffset);
+
+	// Zoom by scroll steps toward the cursor, given in NDC (y up), for a view
+	// with fov (degrees) and aspect.
+	void Zoom(float scroll, float cursorX, float cursorY, float fov, float aspect);
+
+	// World direction through the cursor (NDC) for the current view.
+	vec3 GetCursorRay(float cursorX, float cursorY, float fov, float aspect) const;
+
+	// Advance one tick. dragging: the mouse button is held, so offsets apply
+	// directly and set the velocity instead of coasting. Returns true if the
+	// view changed and Apply is needed.
+	bool Update(float deltaTime, bool dragging);
+
+	// Write position and orientation to camera.
+	void Apply(Camera& camera) const;
+
+	void SetDamping(float damping) { Damping = damping; }
+
+	bool IsSettled() const { return Settled; }
+	dvec3 GetTarget() const { return Target; }
+	dvec3 GetPosition() const;
+	double GetDistance() const { return Distance; }
+	float GetYaw() const { return Yaw; }
+	float GetPitch() const { return Pitch; }
+};
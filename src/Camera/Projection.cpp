@@ -0,0 +1,49 @@
+#include "Projection.h"
+
+#include <cmath>
+
+glm::mat4 BuildProjectionMatrix(const ProjectionSettings& settings, float fovY, float aspect)
+{
+	if (settings.Mode == REVERSE_Z_INFINITE)
+		return PerspectiveReverseZInfinite(glm::radians(fovY), aspect, settings.zNear, settings.ZeroToOneDepth);
+
+	glm::mat4 projection = glm::perspective(glm::radians(fovY), aspect, settings.zNear, settings.zFar);
+
+	if (settings.ZeroToOneDepth)
+	{
+		// Remap clip depth from [-w, w] to [0, w].
+		projection[2][2] = settings.zFar / (settings.zNear - settings.zFar);
+		projection[3][2] = -(settings.zFar * settings.zNear) / (settings.zFar - settings.zNear);
+	}
+
+	return projection;
+}
+
+
+glm::mat4 PerspectiveReverseZInfinite(float fovYRadians, float aspect, float zNear, bool zeroToOneDepth)
+{
+	const float f = 1.0f / std::tan(fovYRadians * 0.5f);
+
+	glm::mat4 projection(0.0f);
+	projection[0][0] = f / aspect;
+	projection[1][1] = f;
+	projection[2][3] = -1.0f;	// w = -z(view)
+
+	if (zeroToOneDepth)
+	{
+		// z(ndc) = zNear / -z(view): 1 at the near plane, 0 at infinity.
+		projection[2][2] = 0.0f;
+		projection[3][2] = zNear;
+	}
+	else
+	{
+		// Emulated for contexts without glClipControl.
+		// z(ndc) = 2 * zNear / -z(view) - 1: 1 at the near plane, -1 at infinity.
+		// The [-1, 1] -> [0, 1] window transform loses some of the precision gain,
+		// but ordering and the GL_GREATER test still behave the same.
+		projection[2][2] = 1.0f;
+		projection[3][2] = 2.0f * zNear;
+	}
+
+	return projection;
+}
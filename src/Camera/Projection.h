@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+/* Depth conventions a projection matrix can be built for.
+   REVERSE_Z_INFINITE maps the near plane to depth 1 and infinity to depth 0,
+   which spreads float depth precision evenly over the view distance.
+*/
+enum Projection_Mode
+{
+	STANDARD_DEPTH,
+	REVERSE_Z_INFINITE
+};
+
+// Default projection values.
+#define DEFAULT_Z_NEAR 0.1f
+#define DEFAULT_Z_FAR 100.0f
+
+struct ProjectionSettings
+{
+	Projection_Mode Mode = STANDARD_DEPTH;
+
+	// Clip space depth is [0, 1] (glClipControl) instead of OpenGL's default [-1, 1].
+	bool ZeroToOneDepth = false;
+
+	float zNear = DEFAULT_Z_NEAR;
+
+	// Ignored by REVERSE_Z_INFINITE.
+	float zFar = DEFAULT_Z_FAR;
+};
+
+// Build the projection matrix for the given settings. fovY is in degrees.
+glm::mat4 BuildProjectionMatrix(const ProjectionSettings& settings, float fovY, float aspect);
+
+// Reverse-Z, infinite far plane perspective projection.
+glm::mat4 PerspectiveReverseZInfinite(float fovYRadians, float aspect, float zNear, bool zeroToOneDepth);
+
+// Depth value the depth buffer has to be cleared to ("farthest" value).
+inline float GetClearDepth(const ProjectionSettings& settings)
+{
+	return settings.Mode == REVERSE_Z_INFINITE ? 0.0f : 1.0f;
+}
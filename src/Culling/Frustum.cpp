@@ -0,0 +1,74 @@
+#include "Frustum.h"
+
+Frustum::Frustum()
+{
+	PlaneCount = 0;
+}
+
+
+void Frustum::ExtractPlanes(const glm::mat4& viewProjection, bool zeroToOneDepth)
+{
+	// Rows of the matrix (glm is column major).
+	vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	PlaneCount = 0;
+
+	AddPlane(row3 + row0);	// Left.
+	AddPlane(row3 - row0);	// Right.
+	AddPlane(row3 + row1);	// Bottom.
+	AddPlane(row3 - row1);	// Top.
+
+	// Depth planes. Which one is near and which is far depends on whether the
+	// projection is reversed, but culling only needs both bounds.
+	if (zeroToOneDepth)
+		AddPlane(row2);			// z >= 0
+	else
+		AddPlane(row3 + row2);	// z >= -w
+
+	AddPlane(row3 - row2);		// z <= w
+}
+
+
+bool Frustum::IsSphereVisible(const vec3& center, float radius) const
+{
+	for (int i = 0; i < PlaneCount; i++)
+	{
+		if (glm::dot(vec3(Planes[i]), center) + Planes[i].w < -radius)
+			return false;
+	}
+
+	return true;
+}
+
+
+bool Frustum::IsBoxVisible(const vec3& minCorner, const vec3& maxCorner) const
+{
+	for (int i = 0; i < PlaneCount; i++)
+	{
+		// Corner farthest along the plane normal.
+		vec3 positive(
+			Planes[i].x >= 0.0f ? maxCorner.x : minCorner.x,
+			Planes[i].y >= 0.0f ? maxCorner.y : minCorner.y,
+			Planes[i].z >= 0.0f ? maxCorner.z : minCorner.z);
+
+		if (glm::dot(vec3(Planes[i]), positive) + Planes[i].w < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+
+void Frustum::AddPlane(const vec4& plane)
+{
+	float length = glm::length(vec3(plane));
+
+	// The far plane of an infinite projection collapses to (0, 0, 0, w).
+	if (length < 1e-6f)
+		return;
+
+	Planes[PlaneCount++] = plane / length;
+}
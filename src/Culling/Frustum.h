@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+using glm::vec3;
+using glm::vec4;
+
+/* View frustum as a set of inward facing planes (xyz = normal, w = distance).
+   Works for standard, [0, 1] and reverse-Z projections. Planes that degenerate
+   (the far plane of an infinite projection) are dropped, so only the planes
+   that actually bound the volume are tested.
+*/
+class Frustum
+{
+private:
+
+	vec4 Planes[6];
+	int PlaneCount;
+
+public:
+
+	Frustum();
+
+	// Extract planes from a combined projection * view matrix.
+	// zeroToOneDepth has to match the clip depth range the projection was built for.
+	void ExtractPlanes(const glm::mat4& viewProjection, bool zeroToOneDepth);
+
+	// Sphere vs frustum test. Conservative (may report hidden spheres as visible).
+	bool IsSphereVisible(const vec3& center, float radius) const;
+
+	// Axis aligned box vs frustum test.
+	bool IsBoxVisible(const vec3& minCorner, const vec3& maxCorner) const;
+
+	int GetPlaneCount() const { return PlaneCount; }
+	const vec4& GetPlane(int index) const { return Planes[index]; }
+
+private:
+
+	// Normalize and store a plane, unless its normal is degenerate.
+	void AddPlane(const vec4& plane);
+};
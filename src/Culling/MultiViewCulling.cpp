@@ -0,0 +1,92 @@
+#include "MultiViewCulling.h"
+#include "../Math/SimdMath.h"
+#include "../Memory/MemoryTracker.h"
+
+void MultiViewCuller::Cull(const Frustum* frustums, int viewCount, const float* x, const float* y, const float* z, float radius, size_t count, JobSystem& jobs)
+{
+	MemoryScope memory(MEMORY_CATEGORY_CULLING);
+
+	if (viewCount > MAX_VIEWS)
+		viewCount = MAX_VIEWS;
+
+	ViewMasks.resize(count);
+
+	jobs.ParallelFor(count, CULL_BATCH_SIZE, [&](size_t begin, size_t end)
+	{
+		// Planes broadcast to all lanes once per batch.
+		Vec3x4 planeNormals[MAX_VIEWS][6];
+		__m128 planeDistances[MAX_VIEWS][6];
+
+		for (int view = 0; view < viewCount; view++)
+		{
+			for (int plane = 0; plane < frustums[view].GetPlaneCount(); plane++)
+			{
+				const vec4& p = frustums[view].GetPlane(plane);
+				planeNormals[view][plane] = Broadcast4(p.x, p.y, p.z);
+				planeDistances[view][plane] = _mm_set1_ps(p.w);
+			}
+		}
+
+		const __m128 minimumDistance = _mm_set1_ps(-radius);
+		size_t i = begin;
+
+		// 4 objects at a time, same test as Frustum::IsSphereVisible.
+		for (; i + 4 <= end; i += 4)
+		{
+			Vec3x4 center = { _mm_loadu_ps(x + i), _mm_loadu_ps(y + i), _mm_loadu_ps(z + i) };
+			__m128i masks = _mm_setzero_si128();
+
+			for (int view = 0; view < viewCount; view++)
+			{
+				__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+				for (int plane = 0; plane < frustums[view].GetPlaneCount(); plane++)
+				{
+					__m128 distance = _mm_add_ps(Dot(planeNormals[view][plane], center), planeDistances[view][plane]);
+					visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, minimumDistance));
+				}
+
+				masks = _mm_or_si128(masks, _mm_and_si128(_mm_castps_si128(visible), _mm_set1_epi32(static_cast<int>(1u << view))));
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&ViewMasks[i]), masks);
+		}
+
+		for (; i < end; i++)
+		{
+			vec3 center(x[i], y[i], z[i]);
+			uint32_t mask = 0;
+
+			for (int view = 0; view < viewCount; view++)
+			{
+				if (frustums[view].IsSphereVisible(center, radius))
+					mask |= 1u << view;
+			}
+
+			ViewMasks[i] = mask;
+		}
+	});
+
+	// Compact into the shared list and the per-view index lists.
+	SharedInstances.clear();
+	ViewInstances.resize(viewCount);
+
+	for (int view = 0; view < viewCount; view++)
+		ViewInstances[view].clear();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t mask = ViewMasks[i];
+		if (mask == 0)
+			continue;
+
+		uint32_t sharedIndex = static_cast<uint32_t>(SharedInstances.size());
+		SharedInstances.push_back(static_cast<uint32_t>(i));
+
+		for (int view = 0; view < viewCount; view++)
+		{
+			if (mask & (1u << view))
+				ViewInstances[view].push_back(sharedIndex);
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Frustum.h"
+#include "../Jobs/JobSystem.h"
+
+#include <cstdint>
+#include <vector>
+
+/* Culls a set of bounding spheres against several view frusta at once.
+
+   Every object is tested against all views in one pass (parallel over object
+   batches), producing a per-object view mask. Objects visible in any view are
+   compacted into one shared instance list that is uploaded once, and each view
+   gets a list of indices into that shared list.
+*/
+class MultiViewCuller
+{
+private:
+
+	// Bit v set if the object is visible in view v.
+	std::vector<uint32_t> ViewMasks;
+
+	// Objects visible in at least one view.
+	std::vector<uint32_t> SharedInstances;
+
+	// Per view: indices into SharedInstances.
+	std::vector<std::vector<uint32_t>> ViewInstances;
+
+public:
+
+	static const int MAX_VIEWS = 32;
+
+	// Objects per job batch.
+	static const size_t CULL_BATCH_SIZE = 4096;
+
+	// Cull count spheres (SoA centers, shared radius) against viewCount frusta.
+	void Cull(const Frustum* frustums, int viewCount, const float* x, const float* y, const float* z, float radius, size_t count, JobSystem& jobs);
+
+	// Object indices visible in any view.
+	const std::vector<uint32_t>& GetSharedInstances() const { return SharedInstances; }
+
+	// Indices into GetSharedInstances() visible in the given view.
+	const std::vector<uint32_t>& GetViewInstances(int view) const { return ViewInstances[view]; }
+};
@@ -0,0 +1,313 @@
+#include "ImageEncoders.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static void AppendBigEndian32(std::vector<uint8_t>& out, uint32_t value)
+{
+	out.push_back(static_cast<uint8_t>(value >> 24));
+	out.push_back(static_cast<uint8_t>(value >> 16));
+	out.push_back(static_cast<uint8_t>(value >> 8));
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+
+struct Crc32Table
+{
+	uint32_t Entries[256];
+
+	Crc32Table()
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t c = i;
+			for (int bit = 0; bit < 8; bit++)
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			Entries[i] = c;
+		}
+	}
+};
+
+
+static uint32_t Crc32(const uint8_t* data, size_t size)
+{
+	static const Crc32Table table;
+
+	uint32_t crc = 0xFFFFFFFFu;
+	for (size_t i = 0; i < size; i++)
+		crc = table.Entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+	return crc ^ 0xFFFFFFFFu;
+}
+
+
+// Chunk length, type and data, followed by the CRC of type and data.
+static void BeginPngChunk(std::vector<uint8_t>& out, uint32_t length, const char* type, size_t& outStart)
+{
+	AppendBigEndian32(out, length);
+	outStart = out.size();
+	out.insert(out.end(), type, type + 4);
+}
+
+
+static void EndPngChunk(std::vector<uint8_t>& out, size_t start)
+{
+	AppendBigEndian32(out, Crc32(out.data() + start, out.size() - start));
+}
+
+
+void EncodePng(const uint8_t* rgba, int width, int height, std::vector<uint8_t>& out)
+{
+	static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	out.insert(out.end(), signature, signature + 8);
+
+	size_t chunk;
+	BeginPngChunk(out, 13, "IHDR", chunk);
+	AppendBigEndian32(out, static_cast<uint32_t>(width));
+	AppendBigEndian32(out, static_cast<uint32_t>(height));
+	out.push_back(8);	// bit depth
+	out.push_back(6);	// RGBA
+	out.push_back(0);	// deflate
+	out.push_back(0);	// adaptive filtering
+	out.push_back(0);	// no interlace
+	EndPngChunk(out, chunk);
+
+	// Scanlines with filter type 0, in stored deflate blocks of at most 65535 bytes.
+	size_t rowSize = static_cast<size_t>(width) * 4;
+	size_t rawSize = (rowSize + 1) * height;
+	size_t blockCount = std::max<size_t>(1, (rawSize + 65534) / 65535);
+	size_t dataSize = 2 + blockCount * 5 + rawSize + 4;
+
+	BeginPngChunk(out, static_cast<uint32_t>(dataSize), "IDAT", chunk);
+	out.push_back(0x78);
+	out.push_back(0x01);
+
+	uint32_t adlerA = 1, adlerB = 0;
+	size_t rawOffset = 0;
+	size_t row = 0, column = 0;
+
+	for (size_t block = 0; block < blockCount; block++)
+	{
+		uint16_t blockSize = static_cast<uint16_t>(std::min<size_t>(65535, rawSize - rawOffset));
+		out.push_back(block + 1 == blockCount ? 1 : 0);
+		out.push_back(static_cast<uint8_t>(blockSize));
+		out.push_back(static_cast<uint8_t>(blockSize >> 8));
+		out.push_back(static_cast<uint8_t>(~blockSize));
+		out.push_back(static_cast<uint8_t>(~blockSize >> 8));
+
+		size_t blockStart = out.size();
+		out.resize(blockStart + blockSize);
+		uint8_t* destination = out.data() + blockStart;
+
+		for (size_t i = 0; i < blockSize; i++)
+		{
+			uint8_t value = column == 0 ? 0 : rgba[row * rowSize + column - 1];
+			if (++column > rowSize)
+			{
+				column = 0;
+				row++;
+			}
+
+			destination[i] = value;
+			adlerA += value;
+			adlerB += adlerA;
+
+			// Reduce well before the sums can overflow.
+			if ((i & 4095) == 4095)
+			{
+				adlerA %= 65521;
+				adlerB %= 65521;
+			}
+		}
+
+		rawOffset += blockSize;
+		adlerA %= 65521;
+		adlerB %= 65521;
+	}
+
+	AppendBigEndian32(out, (adlerB << 16) | adlerA);
+	EndPngChunk(out, chunk);
+
+	BeginPngChunk(out, 0, "IEND", chunk);
+	EndPngChunk(out, chunk);
+}
+
+
+void EncodeQoi(const uint8_t* rgba, int width, int height, std::vector<uint8_t>& out)
+{
+	out.push_back('q');
+	out.push_back('o');
+	out.push_back('i');
+	out.push_back('f');
+	AppendBigEndian32(out, static_cast<uint32_t>(width));
+	AppendBigEndian32(out, static_cast<uint32_t>(height));
+	out.push_back(4);	// RGBA
+	out.push_back(0);	// sRGB with linear alpha
+
+	uint8_t index[64][4] = {};
+	uint8_t previous[4] = { 0, 0, 0, 255 };
+	int run = 0;
+
+	size_t pixelCount = static_cast<size_t>(width) * height;
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		const uint8_t* pixel = rgba + i * 4;
+
+		if (memcmp(pixel, previous, 4) == 0)
+		{
+			run++;
+			if (run == 62 || i + 1 == pixelCount)
+			{
+				out.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+				run = 0;
+			}
+			continue;
+		}
+
+		if (run > 0)
+		{
+			out.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+			run = 0;
+		}
+
+		int hash = (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64;
+
+		if (memcmp(index[hash], pixel, 4) == 0)
+			out.push_back(static_cast<uint8_t>(hash));
+		else
+		{
+			memcpy(index[hash], pixel, 4);
+
+			if (pixel[3] == previous[3])
+			{
+				int dr = static_cast<int8_t>(pixel[0] - previous[0]);
+				int dg = static_cast<int8_t>(pixel[1] - previous[1]);
+				int db = static_cast<int8_t>(pixel[2] - previous[2]);
+				int drdg = dr - dg;
+				int dbdg = db - dg;
+
+				if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+					out.push_back(static_cast<uint8_t>(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+				else if (dg >= -32 && dg <= 31 && drdg >= -8 && drdg <= 7 && dbdg >= -8 && dbdg <= 7)
+				{
+					out.push_back(static_cast<uint8_t>(0x80 | (dg + 32)));
+					out.push_back(static_cast<uint8_t>(((drdg + 8) << 4) | (dbdg + 8)));
+				}
+				else
+				{
+					out.push_back(0xFE);
+					out.insert(out.end(), pixel, pixel + 3);
+				}
+			}
+			else
+			{
+				out.push_back(0xFF);
+				out.insert(out.end(), pixel, pixel + 4);
+			}
+		}
+
+		memcpy(previous, pixel, 4);
+	}
+
+	static const uint8_t padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+	out.insert(out.end(), padding, padding + 8);
+}
+
+
+bool WriteEncodedFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "ERROR::IMAGE_ENCODERS::FAILED_TO_OPEN: " << path << std::endl;
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+	return static_cast<bool>(file);
+}
+
+
+Y4mWriter::Y4mWriter()
+{
+	Width = 0;
+	Height = 0;
+}
+
+
+bool Y4mWriter::Open(const std::string& path, int width, int height, int framesPerSecond)
+{
+	File.open(path, std::ios::binary);
+	if (!File)
+	{
+		std::cout << "ERROR::IMAGE_ENCODERS::FAILED_TO_OPEN: " << path << std::endl;
+		return false;
+	}
+
+	Width = width;
+	Height = height;
+
+	File << "YUV4MPEG2 W" << width << " H" << height << " F" << framesPerSecond << ":1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n";
+	return true;
+}
+
+
+void Y4mWriter::WriteFrame(const uint8_t* rgba)
+{
+	int chromaWidth = (Width + 1) / 2;
+	int chromaHeight = (Height + 1) / 2;
+	size_t lumaSize = static_cast<size_t>(Width) * Height;
+	size_t chromaSize = static_cast<size_t>(chromaWidth) * chromaHeight;
+
+	Planes.resize(lumaSize + 2 * chromaSize);
+	uint8_t* luma = Planes.data();
+	uint8_t* cb = luma + lumaSize;
+	uint8_t* cr = cb + chromaSize;
+
+	for (size_t i = 0; i < lumaSize; i++)
+	{
+		const uint8_t* pixel = rgba + i * 4;
+		luma[i] = static_cast<uint8_t>((19595 * pixel[0] + 38470 * pixel[1] + 7471 * pixel[2] + 32768) >> 16);
+	}
+
+	// Chroma of each 2x2 block's average colour.
+	for (int y = 0; y < chromaHeight; y++)
+	{
+		for (int x = 0; x < chromaWidth; x++)
+		{
+			int r = 0, g = 0, b = 0, count = 0;
+
+			for (int sy = 2 * y; sy < std::min(2 * y + 2, Height); sy++)
+			{
+				for (int sx = 2 * x; sx < std::min(2 * x + 2, Width); sx++)
+				{
+					const uint8_t* pixel = rgba + (static_cast<size_t>(sy) * Width + sx) * 4;
+					r += pixel[0];
+					g += pixel[1];
+					b += pixel[2];
+					count++;
+				}
+			}
+
+			r /= count;
+			g /= count;
+			b /= count;
+
+			int u = ((-11059 * r - 21709 * g + 32768 * b + 32768) >> 16) + 128;
+			int v = ((32768 * r - 27439 * g - 5329 * b + 32768) >> 16) + 128;
+			cb[y * chromaWidth + x] = static_cast<uint8_t>(std::min(std::max(u, 0), 255));
+			cr[y * chromaWidth + x] = static_cast<uint8_t>(std::min(std::max(v, 0), 255));
+		}
+	}
+
+	File << "FRAME\n";
+	File.write(reinterpret_cast<const char*>(Planes.data()), Planes.size());
+}
+
+
+void Y4mWriter::Close()
+{
+	if (File.is_open())
+		File.close();
+}
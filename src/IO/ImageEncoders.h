@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* Encoders for captured RGBA8 frames, rows top to bottom.
+
+   PNG is written with stored (uncompressed) deflate blocks: valid everywhere,
+   fast, but as large as the raw pixels. QOI is the compact lossless format.
+   Y4M streams 4:2:0 YUV frames (BT.601, full range) into one video file.
+*/
+
+// Append a PNG of the image to out.
+void EncodePng(const uint8_t* rgba, int width, int height, std::vector<uint8_t>& out);
+
+// Append a QOI image of the image to out.
+void EncodeQoi(const uint8_t* rgba, int width, int height, std::vector<uint8_t>& out);
+
+// Write an encoded image. Returns false on failure.
+bool WriteEncodedFile(const std::string& path, const std::vector<uint8_t>& data);
+
+/* Uncompressed YUV4MPEG2 stream. Every frame must have the stream's size. */
+class Y4mWriter
+{
+private:
+
+	std::ofstream File;
+	int Width;
+	int Height;
+
+	// Planes of one frame, reused.
+	std::vector<uint8_t> Planes;
+
+public:
+
+	Y4mWriter();
+
+	// Create the file and write the stream header. Returns false on failure.
+	bool Open(const std::string& path, int width, int height, int framesPerSecond);
+
+	void WriteFrame(const uint8_t* rgba);
+
+	void Close();
+
+	bool IsOpen() const { return File.is_open(); }
+	int GetWidth() const { return Width; }
+	int GetHeight() const { return Height; }
+};
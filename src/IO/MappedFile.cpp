@@ -0,0 +1,118 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+	Data = nullptr;
+	Size = 0;
+
+#ifdef _WIN32
+	FileHandle = INVALID_HANDLE_VALUE;
+	MappingHandle = nullptr;
+#else
+	FileDescriptor = -1;
+#endif
+}
+
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+
+#ifdef _WIN32
+	FileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (FileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(FileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!MappingHandle)
+	{
+		Close();
+		return false;
+	}
+
+	Data = static_cast<const uint8_t*>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0));
+	Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	FileDescriptor = open(path.c_str(), O_RDONLY);
+	if (FileDescriptor < 0)
+		return false;
+
+	struct stat fileInfo;
+	if (fstat(FileDescriptor, &fileInfo) != 0 || fileInfo.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+
+	void* mapping = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+	if (mapping == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	Data = static_cast<const uint8_t*>(mapping);
+	Size = static_cast<size_t>(fileInfo.st_size);
+#endif
+
+	if (!Data)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (Data)
+		UnmapViewOfFile(Data);
+
+	if (MappingHandle)
+		CloseHandle(MappingHandle);
+
+	if (FileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(FileHandle);
+
+	FileHandle = INVALID_HANDLE_VALUE;
+	MappingHandle = nullptr;
+#else
+	if (Data)
+		munmap(const_cast<uint8_t*>(Data), Size);
+
+	if (FileDescriptor >= 0)
+		close(FileDescriptor);
+
+	FileDescriptor = -1;
+#endif
+
+	Data = nullptr;
+	Size = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* Read-only memory mapping of a whole file. */
+class MappedFile
+{
+private:
+
+	const uint8_t* Data;
+	size_t Size;
+
+#ifdef _WIN32
+	void* FileHandle;
+	void* MappingHandle;
+#else
+	int FileDescriptor;
+#endif
+
+public:
+
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Map the file. Returns false on failure.
+	bool Open(const std::string& path);
+
+	// Unmap and close.
+	void Close();
+
+	bool IsOpen() const { return Data != nullptr; }
+
+	const uint8_t* GetData() const { return Data; }
+	size_t GetSize() const { return Size; }
+};
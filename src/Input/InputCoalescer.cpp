@@ -0,0 +1,52 @@
+#include "InputCoalescer.h"
+
+InputCoalescer::InputCoalescer()
+{
+	HasCursor = false;
+	LastX = 0.0f;
+	LastY = 0.0f;
+}
+
+
+size_t InputCoalescer::Drain(InputEventQueue& queue)
+{
+	InputEvent event;
+	size_t count = 0;
+
+	while (queue.Pop(event))
+	{
+		count++;
+
+		if (event.Type == INPUT_CURSOR_MOVED)
+		{
+			if (HasCursor)
+			{
+				Pending.MouseX += event.X - LastX;
+				Pending.MouseY += LastY - event.Y;
+				Pending.CursorEvents++;
+			}
+
+			LastX = event.X;
+			LastY = event.Y;
+			HasCursor = true;
+		}
+		else if (event.Type == INPUT_SCROLLED)
+		{
+			Pending.Scroll += event.Y;
+			Pending.ScrollEvents++;
+		}
+
+		Pending.LatestTime = event.Time;
+	}
+
+	return count;
+}
+
+
+CoalescedInput InputCoalescer::Take()
+{
+	CoalescedInput input = Pending;
+	Pending = CoalescedInput();
+
+	return input;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "InputEventQueue.h"
+
+/* Consumer stage of the input queue.
+
+   Drains the queue every frame and sums cursor deltas and scroll offsets, so
+   the camera runs one mouse update per fixed tick however fast the mouse
+   polls.
+*/
+
+// Input summed since the last Take().
+struct CoalescedInput
+{
+	// Cursor delta, Y up.
+	float MouseX = 0.0f;
+	float MouseY = 0.0f;
+	float Scroll = 0.0f;
+
+	unsigned int CursorEvents = 0;
+	unsigned int ScrollEvents = 0;
+
+	// Time of the newest event.
+	double LatestTime = 0.0;
+};
+
+class InputCoalescer
+{
+private:
+
+	CoalescedInput Pending;
+
+	// Last cursor position, deltas start at the first event.
+	bool HasCursor;
+	float LastX;
+	float LastY;
+
+public:
+
+	InputCoalescer();
+
+	// Pop every queued event into the pending input. Returns the number of events.
+	size_t Drain(InputEventQueue& queue);
+
+	// Pending input, then start over.
+	CoalescedInput Take();
+
+	// Pending input, kept for the next Take().
+	const CoalescedInput& Peek() const { return Pending; }
+};
@@ -0,0 +1,48 @@
+#include "InputEventQueue.h"
+
+InputEventQueue::InputEventQueue(size_t capacity)
+{
+	size_t size = 1;
+	while (size < capacity)
+		size *= 2;
+
+	Events.resize(size);
+	Mask = size - 1;
+
+	Tail = 0;
+	Head = 0;
+	DroppedEvents = 0;
+}
+
+
+bool InputEventQueue::Push(const InputEvent& event)
+{
+	size_t tail = Tail.load(std::memory_order_relaxed);
+
+	if (tail - Head.load(std::memory_order_acquire) > Mask)
+	{
+		DroppedEvents.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	Events[tail & Mask] = event;
+
+	// Publish the slot to the consumer.
+	Tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+
+bool InputEventQueue::Pop(InputEvent& event)
+{
+	size_t head = Head.load(std::memory_order_relaxed);
+
+	if (head == Tail.load(std::memory_order_acquire))
+		return false;
+
+	event = Events[head & Mask];
+
+	// Hand the slot back to the producer.
+	Head.store(head + 1, std::memory_order_release);
+	return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Single producer / single consumer ring of raw input events.
+
+   Window callbacks push events and return immediately; the render loop pops
+   them once per frame (InputCoalescer). Neither side locks, so the callbacks
+   can later move to an input thread without touching the consumer.
+
+   When the ring is full new events are dropped and counted. Cursor events
+   carry absolute positions, so a dropped one loses no motion.
+*/
+
+// Events the ring holds, a power of two. About half a second of 8 kHz polling.
+#define INPUT_EVENT_QUEUE_CAPACITY 4096
+
+enum Input_Queue_Event : uint32_t
+{
+	// X, Y: cursor position in screen coordinates.
+	INPUT_CURSOR_MOVED,
+
+	// X, Y: scroll offsets.
+	INPUT_SCROLLED
+};
+
+struct InputEvent
+{
+	// Seconds, same clock as glfwGetTime().
+	double Time;
+	Input_Queue_Event Type;
+	float X;
+	float Y;
+};
+
+class InputEventQueue
+{
+private:
+
+	std::vector<InputEvent> Events;
+	size_t Mask;
+
+	// Producer and consumer positions on separate cache lines.
+	alignas(64) std::atomic<size_t> Tail;
+	alignas(64) std::atomic<size_t> Head;
+
+	std::atomic<size_t> DroppedEvents;
+
+public:
+
+	// capacity is rounded up to a power of two.
+	explicit InputEventQueue(size_t capacity = INPUT_EVENT_QUEUE_CAPACITY);
+
+	InputEventQueue(const InputEventQueue&) = delete;
+	InputEventQueue& operator=(const InputEventQueue&) = delete;
+
+	// Producer side. Returns false (and counts the event) if the ring is full.
+	bool Push(const InputEvent& event);
+
+	// Consumer side. Returns false if the ring is empty.
+	bool Pop(InputEvent& event);
+
+	size_t GetDroppedCount() const { return DroppedEvents.load(std::memory_order_relaxed); }
+};
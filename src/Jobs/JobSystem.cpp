@@ -0,0 +1,119 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// Set while a thread is running batches, so nested ParallelFor calls don't deadlock.
+static thread_local bool insideJob = false;
+
+
+JobSystem::JobSystem(unsigned int threadCount)
+{
+	JobCount = 0;
+	BatchSize = 1;
+	NextIndex = 0;
+	ActiveWorkers = 0;
+	Generation = 0;
+	Stopping = false;
+
+	if (threadCount == 0)
+	{
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++)
+		Workers.emplace_back(&JobSystem::WorkerLoop, this);
+}
+
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Stopping = true;
+	}
+
+	WorkAvailable.notify_all();
+
+	for (std::thread& worker : Workers)
+		worker.join();
+}
+
+
+void JobSystem::ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& job)
+{
+	if (count == 0)
+		return;
+
+	batchSize = std::max<size_t>(batchSize, 1);
+
+	// Small loops, nested loops and pools without workers run inline.
+	if (Workers.empty() || insideJob || count <= batchSize)
+	{
+		job(0, count);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Job = job;
+		JobCount = count;
+		BatchSize = batchSize;
+		NextIndex = 0;
+		ActiveWorkers = Workers.size();
+		Generation++;
+	}
+
+	WorkAvailable.notify_all();
+
+	RunBatches();
+
+	// Wait for workers still finishing their last batch.
+	std::unique_lock<std::mutex> lock(Mutex);
+	WorkFinished.wait(lock, [this] { return ActiveWorkers == 0; });
+	Job = nullptr;
+}
+
+
+void JobSystem::WorkerLoop()
+{
+	unsigned long long seenGeneration = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			WorkAvailable.wait(lock, [&] { return Stopping || Generation != seenGeneration; });
+
+			if (Stopping)
+				return;
+
+			seenGeneration = Generation;
+		}
+
+		RunBatches();
+
+		if (--ActiveWorkers == 0)
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			WorkFinished.notify_one();
+		}
+	}
+}
+
+
+void JobSystem::RunBatches()
+{
+	insideJob = true;
+
+	while (true)
+	{
+		size_t begin = NextIndex.fetch_add(BatchSize);
+		if (begin >= JobCount)
+			break;
+
+		Job(begin, std::min(begin + BatchSize, JobCount));
+	}
+
+	insideJob = false;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Fixed pool of worker threads that run ranges of a parallel loop.
+   The calling thread takes part in the work, so ParallelFor returns only after
+   every batch has finished.
+*/
+class JobSystem
+{
+private:
+
+	std::vector<std::thread> Workers;
+
+	std::mutex Mutex;
+	std::condition_variable WorkAvailable;
+	std::condition_variable WorkFinished;
+
+	// Current loop.
+	std::function<void(size_t, size_t)> Job;
+	size_t JobCount;
+	size_t BatchSize;
+	std::atomic<size_t> NextIndex;
+	std::atomic<size_t> ActiveWorkers;
+	unsigned long long Generation;
+
+	bool Stopping;
+
+public:
+
+	// threadCount = 0 uses one worker per hardware thread (minus the caller).
+	explicit JobSystem(unsigned int threadCount = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Call job(begin, end) for batches covering [0, count). Blocks until done.
+	// Calls from inside a job run serially on the calling thread.
+	void ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& job);
+
+	// Worker threads plus the calling thread.
+	unsigned int GetThreadCount() const { return static_cast<unsigned int>(Workers.size()) + 1; }
+
+private:
+
+	void WorkerLoop();
+
+	// Take batches until the loop is exhausted.
+	void RunBatches();
+};
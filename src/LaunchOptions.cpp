@@ -0,0 +1,95 @@
+#include "LaunchOptions.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+LaunchOptions ParseLaunchOptions(int argc, char** argv)
+{
+	LaunchOptions options;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argument, "--record") == 0 && hasValue)
+			options.RecordPath = argv[++i];
+		else if (strcmp(argument, "--replay") == 0 && hasValue)
+			options.ReplayPath = argv[++i];
+		else if (strcmp(argument, "--flythrough") == 0 && hasValue)
+			options.FlythroughPath = argv[++i];
+		else if (strcmp(argument, "--flythrough-speed") == 0 && hasValue)
+			options.FlythroughSpeed = static_cast<float>(atof(argv[++i]));
+		else if (strcmp(argument, "--timings") == 0 && hasValue)
+			options.TimingsPath = argv[++i];
+		else if (strcmp(argument, "--baseline") == 0 && hasValue)
+			options.BaselinePath = argv[++i];
+		else if (strcmp(argument, "--scene") == 0 && hasValue)
+			options.ScenePath = argv[++i];
+		else if (strcmp(argument, "--texture-budget") == 0 && hasValue)
+		{
+			// A negative count would wrap to an unlimited budget.
+			const char* budget = argv[++i];
+			long long budgetMB = atoll(budget);
+			if (budgetMB > 0)
+				options.TextureBudgetMB = static_cast<size_t>(budgetMB);
+			else
+				std::cout << "ERROR::LAUNCH_OPTIONS::INVALID_TEXTURE_BUDGET: " << budget << " MB, keeping " << options.TextureBudgetMB << " MB" << std::endl;
+		}
+		else if (strcmp(argument, "--memory-report") == 0 && hasValue)
+			options.MemoryReportPath = argv[++i];
+		else if (strcmp(argument, "--memory-budgets") == 0 && hasValue)
+			options.MemoryBudgetsPath = argv[++i];
+		else if (strcmp(argument, "--dynamic-resolution") == 0 && hasValue)
+			options.DynamicResolutionTargetMs = static_cast<float>(atof(argv[++i]));
+		else if (strcmp(argument, "--resolution-gains") == 0 && hasValue)
+		{
+			const char* gains = argv[++i];
+			options.HasResolutionGains = sscanf(gains, "%f,%f,%f", &options.ResolutionGains[0], &options.ResolutionGains[1], &options.ResolutionGains[2]) == 3;
+			if (!options.HasResolutionGains)
+				std::cout << "WARNING::LAUNCH_OPTIONS: expected --resolution-gains <kp,ki,kd>, got " << gains << std::endl;
+		}
+		else if (strcmp(argument, "--resolution-log") == 0 && hasValue)
+			options.ResolutionLogPath = argv[++i];
+		else if (strcmp(argument, "--capture") == 0 && hasValue)
+			options.CapturePath = argv[++i];
+		else if (strcmp(argument, "--capture-format") == 0 && hasValue)
+			options.CaptureFormat = argv[++i];
+		else if (strcmp(argument, "--controller") == 0 && hasValue)
+		{
+			// There is one orbit mode, the orbit camera.
+			options.Controller = argv[++i];
+			if (options.Controller == "orbit")
+			{
+				options.Orbit = true;
+				options.Controller.clear();
+			}
+		}
+		else if (strcmp(argument, "--idle-run") == 0 && hasValue)
+			options.IdleRunSeconds = static_cast<float>(atof(argv[++i]));
+		else if (strcmp(argument, "--frame-limit") == 0 && hasValue)
+			options.FrameLimit = static_cast<float>(atof(argv[++i]));
+		else if (strcmp(argument, "--frame-stats") == 0 && hasValue)
+			options.FrameStatsPath = argv[++i];
+		else if (strcmp(argument, "--prepass-depth-test") == 0 && hasValue)
+			options.PrepassDepthTest = argv[++i];
+		else if (strcmp(argument, "--depth-prepass") == 0)
+			options.DepthPrepass = true;
+		else if (strcmp(argument, "--smooth-delta") == 0)
+			options.SmoothDeltaTime = true;
+		else if (strcmp(argument, "--on-demand") == 0)
+			options.OnDemand = true;
+		else if (strcmp(argument, "--orbit") == 0)
+			options.Orbit = true;
+		else if (strcmp(argument, "--late-latch") == 0)
+			options.LateLatch = true;
+		else if (strcmp(argument, "--hidden") == 0)
+			options.Hidden = true;
+		else
+			std::cout << "WARNING::LAUNCH_OPTIONS: ignoring argument " << argument << std::endl;
+	}
+
+	return options;
+}
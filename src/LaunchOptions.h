@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/* Command line options.
+
+   --record <file>      record camera input to a binary recording.
+   --replay <file>      drive the camera from a recording, one tick per frame.
+   --flythrough <file>  fly the camera along a keyframe spline, one tick per frame.
+   --flythrough-speed <units per second>
+   --timings <file>     write per-frame CPU/GPU timings (CSV) of a replay or flythrough.
+   --baseline <file>    compare timings against an earlier timings file.
+   --hidden             don't show the window (headless benchmark runs).
+   --scene <file>       load a binary scene file instead of the default cubes.
+   --texture-budget <MB> GPU memory for streamed texture mips.
+   --memory-report <file>  write CPU/GPU memory per subsystem (CSV) on exit.
+   --memory-budgets <file> fail the run if a subsystem's peak memory exceeds its budget.
+   --late-latch         write the main camera's matrices with the newest mouse input just before drawing.
+   --dynamic-resolution <target ms> scale the render resolution to hold the frame time.
+   --resolution-gains <kp,ki,kd>    PID gains of the resolution controller.
+   --resolution-log <file>          write the frame times and chosen scales (CSV).
+   --capture <path>     capture every frame: numbered images in directory path, or a video file for y4m.
+   --capture-format png|qoi|y4m
+   --controller fly|fps|sixdof  drive the live camera with a policy controller (Space/Ctrl move up/down).
+                        --controller orbit is the same as --orbit.
+   --on-demand          only render when input, the camera, the scene or resources change; sleep otherwise.
+   --idle-run <seconds> close after seconds and report CPU time (compare idle cost with and without --on-demand).
+   --frame-limit <fps>  pace frames with a sleep-plus-spin limiter.
+   --smooth-delta       advance the simulation by the smoothed frame time instead of the raw one.
+   --frame-stats <file> write the frame time histogram (CSV) on exit.
+   --depth-prepass      fill depth first with a position-only pass, then shade only visible fragments (toggle with P).
+   --prepass-depth-test equal|or-equal  depth test of the shading pass after the pre-pass.
+   --orbit              orbit the scene: drag with the left button, scroll zooms to the cursor, F focuses the instance under it.
+*/
+struct LaunchOptions
+{
+	std::string RecordPath;
+	std::string ReplayPath;
+	std::string FlythroughPath;
+	float FlythroughSpeed = 4.0f;
+	std::string TimingsPath;
+	std::string BaselinePath;
+	bool Hidden = false;
+	std::string ScenePath;
+	size_t TextureBudgetMB = 256;
+	std::string MemoryReportPath;
+	std::string MemoryBudgetsPath;
+	bool LateLatch = false;
+	float DynamicResolutionTargetMs = 0.0f;
+	bool HasResolutionGains = false;
+	float ResolutionGains[3] = {};
+	std::string ResolutionLogPath;
+	std::string CapturePath;
+	std::string CaptureFormat = "png";
+	std::string Controller;
+	bool Orbit = false;
+	bool OnDemand = false;
+	float IdleRunSeconds = 0.0f;
+	float FrameLimit = 0.0f;
+	bool SmoothDeltaTime = false;
+	std::string FrameStatsPath;
+	bool DepthPrepass = false;
+	std::string PrepassDepthTest = "equal";
+
+	// Allowed p95 slowdown against the baseline before a replay run fails.
+	double RegressionTolerance = 0.05;
+};
+
+// Parse argv. Unknown arguments are reported and ignored.
+LaunchOptions ParseLaunchOptions(int argc, char** argv);
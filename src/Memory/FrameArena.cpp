@@ -0,0 +1,105 @@
+#include "FrameArena.h"
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+FrameArena::FrameArena(size_t capacity)
+{
+	MemoryScope memory(MEMORY_CATEGORY_FRAME_ARENA);
+
+	Capacity = capacity;
+	CurrentFrame = 0;
+	Offset = 0;
+	FrameNumber = 0;
+	OverflowReported = false;
+	Stats.Capacity = capacity;
+
+	for (FrameBuffer& frame : Frames)
+	{
+		frame.Memory.reset(new uint8_t[capacity]);
+
+#ifdef FRAME_ARENA_DEBUG
+		memset(frame.Memory.get(), FRAME_ARENA_POISON, capacity);
+#endif
+	}
+}
+
+
+void FrameArena::BeginFrame()
+{
+	// Totals of the frame that just ended.
+	FrameBuffer& finished = Frames[CurrentFrame];
+	size_t used = Offset.load();
+
+	Stats.LastFrameBytes = used + finished.OverflowBytes;
+	Stats.OverflowBytes = finished.OverflowBytes;
+
+#ifdef FRAME_ARENA_DEBUG
+	if (Stats.LastFrameBytes > Stats.HighWaterBytes)
+	{
+		std::cout << "FRAME_ARENA::HIGH_WATER_MARK: frame " << FrameNumber << ", " << Stats.LastFrameBytes / 1024 << " KB of "
+			<< Capacity / 1024 << " KB" << (Stats.OverflowBytes ? " (overflowed to the heap)" : "") << std::endl;
+	}
+#endif
+
+	Stats.HighWaterBytes = std::max(Stats.HighWaterBytes, Stats.LastFrameBytes);
+
+	if (Stats.OverflowBytes > 0 && !OverflowReported)
+	{
+		std::cout << "WARNING::FRAME_ARENA::OVERFLOW: " << Stats.OverflowBytes / 1024 << " KB allocated from the heap, capacity " << Capacity / 1024 << " KB" << std::endl;
+		OverflowReported = true;
+	}
+
+	// The oldest buffer is no longer in flight.
+	CurrentFrame = (CurrentFrame + 1) % FRAME_ARENA_FRAME_COUNT;
+	FrameBuffer& frame = Frames[CurrentFrame];
+
+#ifdef FRAME_ARENA_DEBUG
+	// Stale pointers into the released frame read the poison pattern.
+	memset(frame.Memory.get(), FRAME_ARENA_POISON, Capacity);
+#endif
+
+	frame.Overflow.clear();
+	frame.OverflowBytes = 0;
+	Offset = 0;
+	FrameNumber++;
+}
+
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	uint8_t* base = Frames[CurrentFrame].Memory.get();
+	size_t offset = Offset.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		// Align the address, not the offset, the buffer is only new[] aligned.
+		uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+		size_t aligned = offset + ((alignment - address % alignment) % alignment);
+
+		if (aligned + size > Capacity)
+			break;
+
+		if (Offset.compare_exchange_weak(offset, aligned + size, std::memory_order_relaxed))
+			return base + aligned;
+	}
+
+	// Full: this frame takes the rest from the heap.
+	std::lock_guard<std::mutex> lock(OverflowMutex);
+	MemoryScope memory(MEMORY_CATEGORY_FRAME_ARENA);
+	FrameBuffer& frame = Frames[CurrentFrame];
+
+	frame.Overflow.emplace_back(new uint8_t[size + alignment]);
+	frame.OverflowBytes += size;
+
+	uintptr_t address = reinterpret_cast<uintptr_t>(frame.Overflow.back().get());
+	return reinterpret_cast<void*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+}
+
+
+size_t FrameArena::GetUsedBytes() const
+{
+	return Offset.load() + Frames[CurrentFrame].OverflowBytes;
+}
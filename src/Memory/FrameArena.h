@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/* Linear allocator for data that lives for one frame.
+
+   Allocations bump an offset into the current frame's buffer and are never
+   freed individually; BeginFrame() moves to the next buffer and
+   resets it. There is one buffer per frame in flight, so memory handed to the
+   GPU or to worker threads during frame N is only reused at frame
+   N + FRAME_ARENA_FRAME_COUNT.
+
+   Allocations past the capacity fall back to the heap and are released when
+   the buffer comes around again; the overflow shows up in the stats, so the
+   capacity can be raised.
+
+   With FRAME_ARENA_DEBUG (on in debug builds) released memory is poisoned and
+   every frame reports its high-water mark.
+*/
+
+#if defined(_DEBUG) && !defined(FRAME_ARENA_DEBUG)
+#define FRAME_ARENA_DEBUG
+#endif
+
+// Buffers, one per frame the GPU may still be working on.
+#define FRAME_ARENA_FRAME_COUNT 3
+
+// Default capacity of every buffer.
+#define FRAME_ARENA_DEFAULT_CAPACITY (16 * 1024 * 1024)
+
+// Written over released memory in debug builds.
+#define FRAME_ARENA_POISON 0xCD
+
+struct FrameArenaStats
+{
+	size_t Capacity = 0;
+
+	// Bytes allocated by the last finished frame, heap overflow included.
+	size_t LastFrameBytes = 0;
+
+	// Largest LastFrameBytes so far.
+	size_t HighWaterBytes = 0;
+
+	// Bytes the last finished frame had to take from the heap.
+	size_t OverflowBytes = 0;
+};
+
+class FrameArena
+{
+private:
+
+	struct FrameBuffer
+	{
+		std::unique_ptr<uint8_t[]> Memory;
+
+		// Heap allocations that didn't fit, freed when the buffer is reused.
+		std::vector<std::unique_ptr<uint8_t[]>> Overflow;
+		size_t OverflowBytes = 0;
+	};
+
+	FrameBuffer Frames[FRAME_ARENA_FRAME_COUNT];
+	size_t Capacity;
+	int CurrentFrame;
+
+	// Bump offset into the current buffer.
+	std::atomic<size_t> Offset;
+
+	std::mutex OverflowMutex;
+
+	FrameArenaStats Stats;
+	unsigned long long FrameNumber;
+	bool OverflowReported;
+
+public:
+
+	explicit FrameArena(size_t capacity = FRAME_ARENA_DEFAULT_CAPACITY);
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// Start a frame: the oldest buffer is released and becomes current.
+	void BeginFrame();
+
+	// Uninitialized memory valid until this buffer is reused. Safe to call
+	// from worker threads. alignment must be a power of two.
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	template<typename T>
+	T* AllocateArray(size_t count) { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T))); }
+
+	// Bytes allocated in the current frame so far (render thread).
+	size_t GetUsedBytes() const;
+
+	const FrameArenaStats& GetStats() const { return Stats; }
+};
+
+
+/* STL allocator over a FrameArena. deallocate() is a no-op, containers must
+   not outlive the frame they were created in.
+*/
+template<typename T>
+class FrameAllocator
+{
+public:
+
+	typedef T value_type;
+
+	FrameArena* Arena;
+
+	explicit FrameAllocator(FrameArena& arena) : Arena(&arena) {}
+
+	template<typename U>
+	FrameAllocator(const FrameAllocator<U>& other) : Arena(other.Arena) {}
+
+	T* allocate(size_t count) { return Arena->AllocateArray<T>(count); }
+	void deallocate(T*, size_t) {}
+
+	template<typename U>
+	bool operator==(const FrameAllocator<U>& other) const { return Arena == other.Arena; }
+
+	template<typename U>
+	bool operator!=(const FrameAllocator<U>& other) const { return Arena != other.Arena; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
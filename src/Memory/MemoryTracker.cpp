@@ -0,0 +1,349 @@
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <tuple>
+
+// Stored in front of every allocation, keeps the 16 byte alignment of malloc.
+#define ALLOCATION_HEADER_SIZE 16
+
+static const char* categoryNames[MEMORY_CATEGORY_COUNT] = { "general", "scene", "culling", "textures", "renderer", "frame_arena" };
+
+struct AllocationHeader
+{
+	size_t Size;
+	uint32_t Category;
+};
+
+// Zero-initialized before any dynamic initializer runs, so allocations of
+// other static constructors are counted too.
+struct CpuCounters
+{
+	std::atomic<long long> LiveBytes;
+	std::atomic<long long> PeakBytes;
+	std::atomic<long long> Allocations;
+};
+
+static CpuCounters cpuCounters[MEMORY_CATEGORY_COUNT];
+
+static thread_local Memory_Category currentCategory = MEMORY_CATEGORY_GENERAL;
+
+// Allocation counts at the start of the current frame (render thread only).
+struct FrameCounters
+{
+	long long FrameStartAllocations = 0;
+	long long FrameAllocations = 0;
+	long long PeakFrameAllocations = 0;
+};
+
+static FrameCounters frameCounters[MEMORY_CATEGORY_COUNT];
+
+
+#pragma region GpuResources
+
+struct GpuAllocation
+{
+	Memory_Category Category = MEMORY_CATEGORY_GENERAL;
+	size_t Bytes = 0;
+};
+
+typedef std::tuple<int, unsigned int, unsigned int> GpuResourceKey;
+
+struct GpuResources
+{
+	std::mutex Mutex;
+	std::map<GpuResourceKey, GpuAllocation> Allocations;
+	long long LiveBytes[MEMORY_CATEGORY_COUNT] = {};
+	long long PeakBytes[MEMORY_CATEGORY_COUNT] = {};
+};
+
+static GpuResources& GetGpuResources()
+{
+	static GpuResources resources;
+	return resources;
+}
+
+
+void TrackGpuMemory(Gpu_Resource resource, unsigned int name, Memory_Category category, size_t bytes, unsigned int part)
+{
+	GpuResources& gpu = GetGpuResources();
+	std::lock_guard<std::mutex> lock(gpu.Mutex);
+
+	GpuAllocation& allocation = gpu.Allocations[GpuResourceKey(resource, name, part)];
+
+	gpu.LiveBytes[allocation.Category] -= static_cast<long long>(allocation.Bytes);
+	allocation.Category = category;
+	allocation.Bytes = bytes;
+	gpu.LiveBytes[category] += static_cast<long long>(bytes);
+
+	gpu.PeakBytes[category] = std::max(gpu.PeakBytes[category], gpu.LiveBytes[category]);
+}
+
+
+void ReleaseGpuMemory(Gpu_Resource resource, unsigned int name)
+{
+	GpuResources& gpu = GetGpuResources();
+	std::lock_guard<std::mutex> lock(gpu.Mutex);
+
+	auto first = gpu.Allocations.lower_bound(GpuResourceKey(resource, name, 0));
+	auto last = first;
+
+	while (last != gpu.Allocations.end() && std::get<0>(last->first) == resource && std::get<1>(last->first) == name)
+	{
+		gpu.LiveBytes[last->second.Category] -= static_cast<long long>(last->second.Bytes);
+		++last;
+	}
+
+	gpu.Allocations.erase(first, last);
+}
+
+#pragma endregion
+
+
+MemoryScope::MemoryScope(Memory_Category category)
+{
+	Previous = currentCategory;
+	currentCategory = category;
+}
+
+
+MemoryScope::~MemoryScope()
+{
+	currentCategory = Previous;
+}
+
+
+const char* GetMemoryCategoryName(Memory_Category category)
+{
+	return categoryNames[category];
+}
+
+
+void BeginMemoryFrame()
+{
+	for (int category = 0; category < MEMORY_CATEGORY_COUNT; category++)
+	{
+		FrameCounters& frame = frameCounters[category];
+		long long allocations = cpuCounters[category].Allocations.load(std::memory_order_relaxed);
+
+		frame.FrameAllocations = allocations - frame.FrameStartAllocations;
+		frame.PeakFrameAllocations = std::max(frame.PeakFrameAllocations, frame.FrameAllocations);
+		frame.FrameStartAllocations = allocations;
+	}
+}
+
+
+MemoryCategoryStats GetMemoryStats(Memory_Category category)
+{
+	MemoryCategoryStats stats;
+	stats.CpuLiveBytes = cpuCounters[category].LiveBytes.load(std::memory_order_relaxed);
+	stats.CpuPeakBytes = cpuCounters[category].PeakBytes.load(std::memory_order_relaxed);
+	stats.Allocations = cpuCounters[category].Allocations.load(std::memory_order_relaxed);
+	stats.FrameAllocations = frameCounters[category].FrameAllocations;
+	stats.PeakFrameAllocations = frameCounters[category].PeakFrameAllocations;
+
+	GpuResources& gpu = GetGpuResources();
+	std::lock_guard<std::mutex> lock(gpu.Mutex);
+	stats.GpuLiveBytes = gpu.LiveBytes[category];
+	stats.GpuPeakBytes = gpu.PeakBytes[category];
+
+	return stats;
+}
+
+
+MemoryCategoryStats GetTotalMemoryStats()
+{
+	MemoryCategoryStats total;
+
+	for (int category = 0; category < MEMORY_CATEGORY_COUNT; category++)
+	{
+		MemoryCategoryStats stats = GetMemoryStats(static_cast<Memory_Category>(category));
+		total.CpuLiveBytes += stats.CpuLiveBytes;
+		total.CpuPeakBytes += stats.CpuPeakBytes;
+		total.Allocations += stats.Allocations;
+		total.FrameAllocations += stats.FrameAllocations;
+		total.PeakFrameAllocations += stats.PeakFrameAllocations;
+		total.GpuLiveBytes += stats.GpuLiveBytes;
+		total.GpuPeakBytes += stats.GpuPeakBytes;
+	}
+
+	return total;
+}
+
+
+void PrintMemoryReport()
+{
+	const double MB = 1024.0 * 1024.0;
+
+	std::cout << "Memory (MB)      CPU live   CPU peak   GPU live   GPU peak   allocs/frame (peak)\n";
+	std::cout << std::fixed << std::setprecision(2);
+
+	for (int category = 0; category < MEMORY_CATEGORY_COUNT; category++)
+	{
+		MemoryCategoryStats stats = GetMemoryStats(static_cast<Memory_Category>(category));
+
+		std::cout << std::left << std::setw(14) << categoryNames[category] << std::right
+			<< std::setw(11) << stats.CpuLiveBytes / MB << std::setw(11) << stats.CpuPeakBytes / MB
+			<< std::setw(11) << stats.GpuLiveBytes / MB << std::setw(11) << stats.GpuPeakBytes / MB
+			<< std::setw(10) << stats.FrameAllocations << " (" << stats.PeakFrameAllocations << ")\n";
+	}
+
+	std::cout << std::defaultfloat;
+}
+
+
+bool WriteMemoryReport(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cout << "ERROR::MEMORY_TRACKER::FAILED_TO_OPEN: " << path << std::endl;
+		return false;
+	}
+
+	file << "category,cpu_live_bytes,cpu_peak_bytes,allocations,peak_frame_allocations,gpu_live_bytes,gpu_peak_bytes\n";
+
+	for (int category = 0; category < MEMORY_CATEGORY_COUNT; category++)
+	{
+		MemoryCategoryStats stats = GetMemoryStats(static_cast<Memory_Category>(category));
+
+		file << categoryNames[category] << "," << stats.CpuLiveBytes << "," << stats.CpuPeakBytes << "," << stats.Allocations << ","
+			<< stats.PeakFrameAllocations << "," << stats.GpuLiveBytes << "," << stats.GpuPeakBytes << "\n";
+	}
+
+	return static_cast<bool>(file);
+}
+
+
+bool CheckMemoryBudgets(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cout << "ERROR::MEMORY_TRACKER::FAILED_TO_OPEN: " << path << std::endl;
+		return false;
+	}
+
+	const double MB = 1024.0 * 1024.0;
+	bool withinBudget = true;
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		std::replace(line.begin(), line.end(), ',', ' ');
+		std::istringstream fields(line);
+
+		std::string name;
+		double cpuBudgetMB, gpuBudgetMB;
+
+		// Skips the header.
+		if (!(fields >> name >> cpuBudgetMB >> gpuBudgetMB))
+			continue;
+
+		const char** found = std::find(categoryNames, categoryNames + MEMORY_CATEGORY_COUNT, name);
+		if (found == categoryNames + MEMORY_CATEGORY_COUNT)
+		{
+			std::cout << "WARNING::MEMORY_TRACKER::UNKNOWN_CATEGORY: " << name << std::endl;
+			continue;
+		}
+
+		MemoryCategoryStats stats = GetMemoryStats(static_cast<Memory_Category>(found - categoryNames));
+
+		if (cpuBudgetMB >= 0.0 && stats.CpuPeakBytes > cpuBudgetMB * MB)
+		{
+			std::cout << "Memory budget exceeded: " << name << " CPU peak " << stats.CpuPeakBytes / MB << " MB > " << cpuBudgetMB << " MB\n";
+			withinBudget = false;
+		}
+
+		if (gpuBudgetMB >= 0.0 && stats.GpuPeakBytes > gpuBudgetMB * MB)
+		{
+			std::cout << "Memory budget exceeded: " << name << " GPU peak " << stats.GpuPeakBytes / MB << " MB > " << gpuBudgetMB << " MB\n";
+			withinBudget = false;
+		}
+	}
+
+	return withinBudget;
+}
+
+
+#pragma region GlobalNewDelete
+
+#ifndef MEMORY_TRACKING_DISABLED
+
+static void* TrackedAllocate(size_t size)
+{
+	void* memory = malloc(size + ALLOCATION_HEADER_SIZE);
+	if (!memory)
+		return nullptr;
+
+	AllocationHeader* header = static_cast<AllocationHeader*>(memory);
+	header->Size = size;
+	header->Category = currentCategory;
+
+	CpuCounters& counters = cpuCounters[currentCategory];
+	long long live = counters.LiveBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed) + static_cast<long long>(size);
+	counters.Allocations.fetch_add(1, std::memory_order_relaxed);
+
+	long long peak = counters.PeakBytes.load(std::memory_order_relaxed);
+	while (live > peak && !counters.PeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+	{
+	}
+
+	return static_cast<uint8_t*>(memory) + ALLOCATION_HEADER_SIZE;
+}
+
+
+static void TrackedFree(void* pointer)
+{
+	if (!pointer)
+		return;
+
+	AllocationHeader* header = reinterpret_cast<AllocationHeader*>(static_cast<uint8_t*>(pointer) - ALLOCATION_HEADER_SIZE);
+	cpuCounters[header->Category].LiveBytes.fetch_sub(static_cast<long long>(header->Size), std::memory_order_relaxed);
+
+	free(header);
+}
+
+
+static void* TrackedNew(size_t size)
+{
+	void* memory = TrackedAllocate(size);
+
+	while (!memory)
+	{
+		std::new_handler handler = std::get_new_handler();
+		if (!handler)
+			throw std::bad_alloc();
+
+		handler();
+		memory = TrackedAllocate(size);
+	}
+
+	return memory;
+}
+
+
+void* operator new(size_t size) { return TrackedNew(size); }
+void* operator new[](size_t size) { return TrackedNew(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size); }
+
+void operator delete(void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+
+#endif
+
+#pragma endregion
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/* CPU and GPU memory usage per subsystem.
+
+   CPU: the global operator new / delete are replaced (MemoryTracker.cpp) and
+   every allocation is charged to the category of the innermost MemoryScope on
+   the allocating thread, MEMORY_CATEGORY_GENERAL outside of any scope. Scopes
+   don't carry over to job system workers.
+
+   GPU: the GL wrappers report the size of every buffer, texture level and
+   renderbuffer they specify. Sizes are keyed by GL object (and part, e.g. the
+   mip level), so re-specifying a resource replaces its old size.
+
+   Define MEMORY_TRACKING_DISABLED to build without the operator new hooks.
+*/
+
+enum Memory_Category
+{
+	MEMORY_CATEGORY_GENERAL,
+	MEMORY_CATEGORY_SCENE,
+	MEMORY_CATEGORY_CULLING,
+	MEMORY_CATEGORY_TEXTURES,
+	MEMORY_CATEGORY_RENDERER,
+	MEMORY_CATEGORY_FRAME_ARENA,
+
+	MEMORY_CATEGORY_COUNT
+};
+
+enum Gpu_Resource
+{
+	GPU_RESOURCE_BUFFER,
+	GPU_RESOURCE_TEXTURE,
+	GPU_RESOURCE_RENDERBUFFER
+};
+
+struct MemoryCategoryStats
+{
+	long long CpuLiveBytes = 0;
+	long long CpuPeakBytes = 0;
+
+	// operator new calls since startup, in the last frame and in the busiest frame.
+	long long Allocations = 0;
+	long long FrameAllocations = 0;
+	long long PeakFrameAllocations = 0;
+
+	long long GpuLiveBytes = 0;
+	long long GpuPeakBytes = 0;
+};
+
+// Charges CPU allocations of this thread to category while in scope.
+class MemoryScope
+{
+private:
+
+	Memory_Category Previous;
+
+public:
+
+	explicit MemoryScope(Memory_Category category);
+	~MemoryScope();
+
+	MemoryScope(const MemoryScope&) = delete;
+	MemoryScope& operator=(const MemoryScope&) = delete;
+};
+
+const char* GetMemoryCategoryName(Memory_Category category);
+
+// Size of a GL object (or one part of it), replacing the size reported before.
+void TrackGpuMemory(Gpu_Resource resource, unsigned int name, Memory_Category category, size_t bytes, unsigned int part = 0);
+
+// Drop every part of a deleted GL object.
+void ReleaseGpuMemory(Gpu_Resource resource, unsigned int name);
+
+// Close the allocation counts of the last frame. Call once per frame.
+void BeginMemoryFrame();
+
+MemoryCategoryStats GetMemoryStats(Memory_Category category);
+
+// Sum over all categories (peaks are the sum of per-category peaks).
+MemoryCategoryStats GetTotalMemoryStats();
+
+// Table of every category on stdout.
+void PrintMemoryReport();
+
+// Write "category,cpu_live_bytes,cpu_peak_bytes,allocations,peak_frame_allocations,gpu_live_bytes,gpu_peak_bytes"
+// rows. Returns false on failure.
+bool WriteMemoryReport(const std::string& path);
+
+// Read "category,cpu_peak_mb,gpu_peak_mb" budgets (negative: no limit) and
+// report every category whose peak exceeds them. Returns false if any does
+// or the file can't be read.
+bool CheckMemoryBudgets(const std::string& path);
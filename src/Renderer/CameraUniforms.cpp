@@ -0,0 +1,52 @@
+#include "CameraUniforms.h"
+#include "../Memory/MemoryTracker.h"
+
+#include <cstring>
+
+CameraUniforms::CameraUniforms(int viewCount)
+{
+	GLint alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+	slotSize = (sizeof(CameraBlock) + alignment - 1) / alignment * alignment;
+	staging.resize(slotSize * viewCount);
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferData(GL_UNIFORM_BUFFER, staging.size(), nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	TrackGpuMemory(GPU_RESOURCE_BUFFER, buffer, MEMORY_CATEGORY_RENDERER, staging.size());
+}
+
+
+void CameraUniforms::setView(int view, const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix)
+{
+	CameraBlock block;
+	block.ProjectionMatrix = projectionMatrix;
+	block.ViewMatrix = viewMatrix;
+
+	memcpy(staging.data() + view * slotSize, &block, sizeof(block));
+}
+
+
+void CameraUniforms::upload()
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferData(GL_UNIFORM_BUFFER, staging.size(), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, staging.size(), staging.data());
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+
+void CameraUniforms::bind(int view) const
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, BINDING_POINT, buffer, view * slotSize, sizeof(CameraBlock));
+}
+
+
+void CameraUniforms::deleteBuffers()
+{
+	glDeleteBuffers(1, &buffer);
+	ReleaseGpuMemory(GPU_RESOURCE_BUFFER, buffer);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/* Camera matrices of every view in one uniform buffer (std140 "CameraBlock").
+
+   Matrices are staged on the CPU and uploaded with a single call, so the
+   upload can happen as late as possible in the frame (late latching). Each
+   view reads its own slot, bound with glBindBufferRange.
+*/
+
+// Layout of CameraBlock in the vertex shader.
+struct CameraBlock
+{
+	glm::mat4 ProjectionMatrix;
+	glm::mat4 ViewMatrix;
+};
+
+class CameraUniforms
+{
+private:
+
+	unsigned int buffer;
+
+	// sizeof(CameraBlock) rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+	size_t slotSize;
+
+	std::vector<uint8_t> staging;
+
+public:
+
+	// Uniform buffer binding point of CameraBlock.
+	static const unsigned int BINDING_POINT = 0;
+
+	// constructor creates the buffer. Needs a current GL context.
+	explicit CameraUniforms(int viewCount);
+
+	// Stage the matrices of a view.
+	void setView(int view, const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix);
+
+	// Upload every staged view (orphans the previous storage).
+	void upload();
+
+	// Bind the slot of a view to BINDING_POINT.
+	void bind(int view) const;
+
+	void deleteBuffers();
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../Camera/Camera.h"
+#include "RenderTarget.h"
+
+/* One camera rendered into its own target and composited into a rectangle
+   of the window (split-screen, picture-in-picture, debug views).
+*/
+struct CameraView
+{
+	Camera ViewCamera;
+
+	// Window rectangle in normalized coordinates (origin bottom-left).
+	float X;
+	float Y;
+	float Width;
+	float Height;
+
+	RenderTarget Target;
+
+	// Per-frame matrices.
+	glm::mat4 ProjectionMatrix;
+	glm::mat4 ViewMatrix;
+
+	CameraView(const Camera& camera, float x, float y, float width, float height, int windowWidth, int windowHeight)
+		: ViewCamera(camera), X(x), Y(y), Width(width), Height(height),
+		  Target(GetPixelWidth(width, windowWidth), GetPixelHeight(height, windowHeight)),
+		  ProjectionMatrix(1.0f), ViewMatrix(1.0f)
+	{
+	}
+
+	// Size of the view in pixels for a window size.
+	static int GetPixelWidth(float width, int windowWidth) { return glm::max(1, static_cast<int>(width * windowWidth)); }
+	static int GetPixelHeight(float height, int windowHeight) { return glm::max(1, static_cast<int>(height * windowHeight)); }
+};
@@ -0,0 +1,88 @@
+#include "DepthPrepass.h"
+
+#include "CameraUniforms.h"
+#include "../Memory/MemoryTracker.h"
+
+#include <cstring>
+#include <vector>
+
+DepthPrepass::DepthPrepass(const void* vertexData, size_t vertexDataSize, size_t vertexStride, const DepthState& depthState,
+	Prepass_Depth_Test depthTest, int instanceTransformUnit)
+	: depthShader("src/Shader/DepthVertex.shader", "src/Shader/DepthFragment.shader")
+{
+	depthFunc = depthState.getDepthFunc();
+	shadingDepthFunc = depthTest == PREPASS_DEPTH_EQUAL ? GL_EQUAL : depthState.getDepthFuncOrEqual();
+
+	// Same vertex indices as the interleaved buffer, 12 bytes per vertex instead of vertexStride.
+	size_t vertexCount = vertexDataSize / vertexStride;
+	std::vector<float> positions(vertexCount * 3);
+
+	const unsigned char* source = static_cast<const unsigned char*>(vertexData);
+	for (size_t i = 0; i < vertexCount; i++)
+		std::memcpy(&positions[i * 3], source + i * vertexStride, 3 * sizeof(float));
+
+	glGenVertexArrays(1, &vertexArray);
+	glBindVertexArray(vertexArray);
+
+	glGenBuffers(1, &positionBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, positionBuffer);
+	glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float), positions.data(), GL_STATIC_DRAW);
+	TrackGpuMemory(GPU_RESOURCE_BUFFER, positionBuffer, MEMORY_CATEGORY_SCENE, positions.size() * sizeof(float));
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	glBindVertexArray(0);
+
+	depthShader.useShaderProgram();
+	glUniform1i(glGetUniformLocation(depthShader.getShaderID(), "instanceTransforms"), instanceTransformUnit);
+	glUniformBlockBinding(depthShader.getShaderID(), glGetUniformBlockIndex(depthShader.getShaderID(), "CameraBlock"), CameraUniforms::BINDING_POINT);
+}
+
+
+void DepthPrepass::beginDepthPass() const
+{
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glDepthMask(GL_TRUE);
+	glDepthFunc(depthFunc);
+
+	depthShader.useShaderProgram();
+	glBindVertexArray(vertexArray);
+}
+
+
+void DepthPrepass::beginShadingPass() const
+{
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glDepthMask(GL_FALSE);
+	glDepthFunc(shadingDepthFunc);
+}
+
+
+void DepthPrepass::end() const
+{
+	glDepthMask(GL_TRUE);
+	glDepthFunc(depthFunc);
+}
+
+
+void DepthPrepass::deleteBuffers()
+{
+	glDeleteVertexArrays(1, &vertexArray);
+	glDeleteBuffers(1, &positionBuffer);
+	ReleaseGpuMemory(GPU_RESOURCE_BUFFER, positionBuffer);
+	glDeleteProgram(depthShader.getShaderID());
+}
+
+
+bool DepthPrepass::ParseDepthTest(const std::string& name, Prepass_Depth_Test& outTest)
+{
+	if (name == "equal")
+		outTest = PREPASS_DEPTH_EQUAL;
+	else if (name == "or-equal")
+		outTest = PREPASS_DEPTH_OR_EQUAL;
+	else
+		return false;
+
+	return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "DepthState.h"
+#include "../Shader/Shader.h"
+
+#include <cstddef>
+#include <string>
+
+/* Depth-only pre-pass.
+
+   The depth pass draws a position-only copy of the vertex data with an empty
+   fragment shader and color writes off, so it only fills the depth buffer.
+   The shading pass then draws with depth writes off and a test that passes
+   only the surface already in the depth buffer, so each pixel runs the
+   material shader once instead of once per overlapping instance.
+
+   Both vertex shaders declare gl_Position invariant, which lets the shading
+   pass test GL_EQUAL. The or-equal form of the projection's depth test
+   (GL_LEQUAL, GL_GEQUAL for reverse-Z) is there for drivers where that
+   doesn't hold.
+*/
+
+enum Prepass_Depth_Test
+{
+	PREPASS_DEPTH_EQUAL,
+	PREPASS_DEPTH_OR_EQUAL
+};
+
+class DepthPrepass
+{
+private:
+
+	Shader depthShader;
+
+	unsigned int vertexArray;
+	unsigned int positionBuffer;
+
+	GLenum depthFunc;
+	GLenum shadingDepthFunc;
+
+public:
+
+	// constructor copies the positions (first 3 floats of every vertexStride
+	// bytes) out of the interleaved vertex data and builds the depth shader.
+	// Needs a current GL context.
+	DepthPrepass(const void* vertexData, size_t vertexDataSize, size_t vertexStride, const DepthState& depthState,
+		Prepass_Depth_Test depthTest, int instanceTransformUnit);
+
+	// Depth writes with color writes off. Binds the depth shader and the position
+	// vertex array; instance indices are bound to it per draw like the main one.
+	void beginDepthPass() const;
+
+	// Color writes on, depth writes off, shading depth test. The caller binds the material shader.
+	void beginShadingPass() const;
+
+	// Restore depth writes and the projection's depth test.
+	void end() const;
+
+	// Delete the buffers and the shader. Call before the context is destroyed.
+	void deleteBuffers();
+
+	// "equal" or "or-equal". Returns false for anything else.
+	static bool ParseDepthTest(const std::string& name, Prepass_Depth_Test& outTest);
+};
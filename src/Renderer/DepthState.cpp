@@ -0,0 +1,56 @@
+#include "DepthState.h"
+
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+
+// glad is generated for GL 3.3 core, so glClipControl is loaded by hand.
+#define GL_NEGATIVE_ONE_TO_ONE 0x935E
+#define GL_ZERO_TO_ONE 0x935F
+
+typedef void (APIENTRYP PFNGLCLIPCONTROLPROC)(GLenum origin, GLenum depth);
+static PFNGLCLIPCONTROLPROC glClipControlPtr = nullptr;
+
+
+DepthState::DepthState(Projection_Mode mode, float zNear, float zFar)
+{
+	settings.Mode = mode;
+	settings.zNear = zNear;
+	settings.zFar = zFar;
+
+	bool hasCoreClipControl = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 5);
+
+	if (hasCoreClipControl || glfwExtensionSupported("GL_ARB_clip_control"))
+		glClipControlPtr = (PFNGLCLIPCONTROLPROC)glfwGetProcAddress("glClipControl");
+
+	clipControlSupported = glClipControlPtr != nullptr;
+
+	// Only reverse-Z needs [0, 1] clip depth, leave standard projections untouched.
+	settings.ZeroToOneDepth = (mode == REVERSE_Z_INFINITE) && clipControlSupported;
+
+	if (mode == REVERSE_Z_INFINITE && !clipControlSupported)
+		std::cout << "WARNING::DEPTH_STATE: glClipControl not available, emulating reverse-Z.\n";
+}
+
+
+void DepthState::apply() const
+{
+	if (clipControlSupported)
+		glClipControlPtr(GL_LOWER_LEFT, settings.ZeroToOneDepth ? GL_ZERO_TO_ONE : GL_NEGATIVE_ONE_TO_ONE);
+
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(getDepthFunc());
+	glClearDepth(GetClearDepth(settings));
+}
+
+
+GLenum DepthState::getDepthFunc() const
+{
+	return settings.Mode == REVERSE_Z_INFINITE ? GL_GREATER : GL_LESS;
+}
+
+
+GLenum DepthState::getDepthFuncOrEqual() const
+{
+	return settings.Mode == REVERSE_Z_INFINITE ? GL_GEQUAL : GL_LEQUAL;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "../Camera/Projection.h"
+
+/* Owns the global depth configuration (clip control, depth func, clear depth)
+   that has to agree with the projection matrix.
+*/
+class DepthState
+{
+private:
+
+	ProjectionSettings settings;
+
+	// glClipControl is core in 4.5, otherwise GL_ARB_clip_control.
+	bool clipControlSupported;
+
+public:
+
+	// constructor queries clip control support. Needs a current GL context.
+	DepthState(Projection_Mode mode, float zNear = DEFAULT_Z_NEAR, float zFar = DEFAULT_Z_FAR);
+
+	// Set clip control, depth func and clear depth for the current context.
+	void apply() const;
+
+	// Depth test of the projection: GL_GREATER for reverse-Z, GL_LESS otherwise.
+	GLenum getDepthFunc() const;
+
+	// The same test, also passing equal depth (GL_GEQUAL / GL_LEQUAL).
+	GLenum getDepthFuncOrEqual() const;
+
+	// Projection settings matching the applied depth state.
+	const ProjectionSettings& getProjectionSettings() const { return settings; }
+
+	// True if reverse-Z runs on real [0, 1] clip depth, false if it is emulated.
+	bool hasClipControl() const { return clipControlSupported; }
+};
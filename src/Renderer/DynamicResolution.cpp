@@ -0,0 +1,72 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+DynamicResolution::DynamicResolution(float targetMs)
+{
+	TargetMs = targetMs;
+	Kp = DYNAMIC_RESOLUTION_KP;
+	Ki = DYNAMIC_RESOLUTION_KI;
+	Kd = DYNAMIC_RESOLUTION_KD;
+
+	Scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+	AppliedScale = DYNAMIC_RESOLUTION_MAX_SCALE;
+
+	Integral = 0.0f;
+	PreviousError = 0.0f;
+	Frame = 0;
+}
+
+
+void DynamicResolution::SetGains(float kp, float ki, float kd)
+{
+	Kp = kp;
+	Ki = ki;
+	Kd = kd;
+}
+
+
+bool DynamicResolution::OpenLog(const std::string& path)
+{
+	Log.open(path);
+	if (!Log)
+	{
+		std::cout << "ERROR::DYNAMIC_RESOLUTION::FAILED_TO_OPEN: " << path << std::endl;
+		return false;
+	}
+
+	Log << "frame,frame_ms,error,scale,applied_scale\n";
+	return true;
+}
+
+
+float DynamicResolution::Update(float frameMs)
+{
+	// Relative error, positive when the frame was too slow.
+	float error = (frameMs - TargetMs) / TargetMs;
+	if (std::fabs(error) < DYNAMIC_RESOLUTION_DEADBAND)
+		error = 0.0f;
+
+	float derivative = error - PreviousError;
+	PreviousError = error;
+
+	// The integral holds the steady-state offset from full scale. Clamped so a
+	// long stretch at the limits doesn't wind it up.
+	float maxIntegral = (DYNAMIC_RESOLUTION_MAX_SCALE - DYNAMIC_RESOLUTION_MIN_SCALE) / std::max(Ki, 1e-6f);
+	Integral = std::min(std::max(Integral + error, 0.0f), maxIntegral);
+
+	Scale = DYNAMIC_RESOLUTION_MAX_SCALE - (Kp * error + Ki * Integral + Kd * derivative);
+	Scale = std::min(std::max(Scale, DYNAMIC_RESOLUTION_MIN_SCALE), DYNAMIC_RESOLUTION_MAX_SCALE);
+
+	// Hysteresis: move the applied scale only by whole steps.
+	if (std::fabs(Scale - AppliedScale) >= DYNAMIC_RESOLUTION_STEP)
+		AppliedScale = std::round(Scale / DYNAMIC_RESOLUTION_STEP) * DYNAMIC_RESOLUTION_STEP;
+
+	if (Log.is_open())
+		Log << Frame << "," << frameMs << "," << error << "," << Scale << "," << AppliedScale << "\n";
+
+	Frame++;
+	return AppliedScale;
+}
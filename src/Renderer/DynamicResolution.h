@@ -0,0 +1,60 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+/* Render resolution controller.
+
+   A PID controller drives the render scale from frame times against a target
+   frame time: positive error (frame too slow) lowers the scale. Errors within
+   a small deadband count as on target, and the scale handed to the render
+   targets only moves in DYNAMIC_RESOLUTION_STEP increments, so targets aren't
+   reallocated for noise. Optionally logs every frame as CSV for tuning.
+*/
+
+#define DYNAMIC_RESOLUTION_MIN_SCALE 0.5f
+#define DYNAMIC_RESOLUTION_MAX_SCALE 1.0f
+
+// Applied scale granularity.
+#define DYNAMIC_RESOLUTION_STEP 0.05f
+
+// Relative frame time error treated as on target.
+#define DYNAMIC_RESOLUTION_DEADBAND 0.05f
+
+// Default gains, per frame.
+#define DYNAMIC_RESOLUTION_KP 0.1f
+#define DYNAMIC_RESOLUTION_KI 0.02f
+#define DYNAMIC_RESOLUTION_KD 0.05f
+
+class DynamicResolution
+{
+private:
+
+	float TargetMs;
+	float Kp, Ki, Kd;
+
+	// Controller output and the quantized scale in use.
+	float Scale;
+	float AppliedScale;
+
+	float Integral;
+	float PreviousError;
+
+	std::ofstream Log;
+	unsigned long long Frame;
+
+public:
+
+	explicit DynamicResolution(float targetMs);
+
+	void SetGains(float kp, float ki, float kd);
+
+	// Write "frame,frame_ms,error,scale,applied_scale" rows. Returns false on failure.
+	bool OpenLog(const std::string& path);
+
+	// Feed the time of the last frame. Returns the scale to render the next one at.
+	float Update(float frameMs);
+
+	float GetScale() const { return AppliedScale; }
+	float GetTargetMs() const { return TargetMs; }
+};
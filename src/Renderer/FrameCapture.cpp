@@ -0,0 +1,303 @@
+#include "FrameCapture.h"
+
+#include "../Memory/MemoryTracker.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+FrameCapture::FrameCapture(const std::string& path, Capture_Format format, int framesPerSecond)
+	: path(path), format(format), framesPerSecond(framesPerSecond)
+{
+	for (Readback& readback : readbacks)
+	{
+		glGenBuffers(1, &readback.buffer);
+		readback.size = 0;
+		readback.fence = nullptr;
+		readback.frame = 0;
+		readback.width = 0;
+		readback.height = 0;
+	}
+
+	nextReadback = 0;
+	frameIndex = 0;
+	stopping = false;
+
+	captureCalls = 0;
+	totalOverheadMs = 0.0;
+	totalEncodeMs = 0.0;
+	warnedSizeChange = false;
+
+	// A video is written in frame order, so it gets a single encoder.
+	int encoderCount = format == CAPTURE_FORMAT_Y4M ? 1 : CAPTURE_ENCODER_THREADS;
+	for (int i = 0; i < encoderCount; i++)
+		encoders.emplace_back(&FrameCapture::encoderLoop, this);
+}
+
+
+FrameCapture::~FrameCapture()
+{
+	stopEncoders();
+}
+
+
+void FrameCapture::capture(int width, int height)
+{
+	double startTime = glfwGetTime();
+	captureCalls++;
+
+	// Hand every readback the GPU has finished to the encoders, oldest first.
+	for (int i = 0; i < CAPTURE_READBACK_COUNT; i++)
+	{
+		Readback& readback = readbacks[(nextReadback + i) % CAPTURE_READBACK_COUNT];
+		if (!readback.fence)
+			continue;
+
+		if (glClientWaitSync(readback.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+			break;
+
+		collect(readback, false);
+	}
+
+	Readback& readback = readbacks[nextReadback];
+
+	if (readback.fence)
+		stats.DroppedReadback++;
+	else
+	{
+		size_t size = static_cast<size_t>(width) * height * 4;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+		if (readback.size != size)
+		{
+			glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+			TrackGpuMemory(GPU_RESOURCE_BUFFER, readback.buffer, MEMORY_CATEGORY_RENDERER, size);
+			readback.size = size;
+		}
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+		glReadBuffer(GL_BACK);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		readback.frame = frameIndex;
+		readback.width = width;
+		readback.height = height;
+
+		nextReadback = (nextReadback + 1) % CAPTURE_READBACK_COUNT;
+	}
+
+	frameIndex++;
+
+	double overheadMs = (glfwGetTime() - startTime) * 1000.0;
+	totalOverheadMs += overheadMs;
+	stats.MeanOverheadMs = totalOverheadMs / captureCalls;
+	stats.MaxOverheadMs = std::max(stats.MaxOverheadMs, overheadMs);
+}
+
+
+void FrameCapture::collect(Readback& readback, bool wait)
+{
+	if (wait)
+		glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+
+	glDeleteSync(readback.fence);
+	readback.fence = nullptr;
+
+	CapturedFrame* frame = nullptr;
+
+	{
+		std::unique_lock<std::mutex> lock(queueMutex);
+
+		if (wait)
+			queueChanged.wait(lock, [this] { return !freeFrames.empty() || frames.size() < CAPTURE_MAX_QUEUED_FRAMES; });
+
+		if (!freeFrames.empty())
+		{
+			frame = freeFrames.back();
+			freeFrames.pop_back();
+		}
+		else if (frames.size() < CAPTURE_MAX_QUEUED_FRAMES)
+		{
+			MemoryScope memory(MEMORY_CATEGORY_RENDERER);
+			frames.emplace_back(new CapturedFrame());
+			frame = frames.back().get();
+		}
+	}
+
+	// Encoders are behind: drop rather than wait.
+	if (!frame)
+	{
+		stats.DroppedEncoder++;
+		return;
+	}
+
+	frame->Frame = readback.frame;
+	frame->Width = readback.width;
+	frame->Height = readback.height;
+
+	{
+		MemoryScope memory(MEMORY_CATEGORY_RENDERER);
+		frame->Pixels.resize(readback.size);
+	}
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+	const uint8_t* pixels = static_cast<const uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, readback.size, GL_MAP_READ_BIT));
+
+	if (pixels)
+	{
+		// GL rows are bottom to top, the encoders want them top to bottom.
+		size_t rowSize = static_cast<size_t>(readback.width) * 4;
+		for (int y = 0; y < readback.height; y++)
+			memcpy(frame->Pixels.data() + y * rowSize, pixels + (readback.height - 1 - y) * rowSize, rowSize);
+
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	std::lock_guard<std::mutex> lock(queueMutex);
+
+	if (!pixels)
+	{
+		freeFrames.push_back(frame);
+		return;
+	}
+
+	encodeQueue.push_back(frame);
+	stats.Captured++;
+	queueChanged.notify_all();
+}
+
+
+void FrameCapture::encoderLoop()
+{
+	while (true)
+	{
+		CapturedFrame* frame;
+
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueChanged.wait(lock, [this] { return stopping || !encodeQueue.empty(); });
+
+			// Queued frames are written before stopping.
+			if (encodeQueue.empty())
+				return;
+
+			frame = encodeQueue.front();
+			encodeQueue.pop_front();
+		}
+
+		double startTime = glfwGetTime();
+		encode(*frame);
+		double encodeMs = (glfwGetTime() - startTime) * 1000.0;
+
+		std::lock_guard<std::mutex> lock(queueMutex);
+		freeFrames.push_back(frame);
+		stats.Encoded++;
+		totalEncodeMs += encodeMs;
+		queueChanged.notify_all();
+	}
+}
+
+
+void FrameCapture::encode(CapturedFrame& frame)
+{
+	if (format == CAPTURE_FORMAT_Y4M)
+	{
+		if (!video.IsOpen() && !video.Open(path, frame.Width, frame.Height, framesPerSecond))
+			return;
+
+		if (frame.Width != video.GetWidth() || frame.Height != video.GetHeight())
+		{
+			if (!warnedSizeChange)
+				std::cout << "WARNING::FRAME_CAPTURE: skipping frames that don't match the video size" << std::endl;
+			warnedSizeChange = true;
+			return;
+		}
+
+		video.WriteFrame(frame.Pixels.data());
+		return;
+	}
+
+	std::vector<uint8_t> encoded;
+	if (format == CAPTURE_FORMAT_PNG)
+		EncodePng(frame.Pixels.data(), frame.Width, frame.Height, encoded);
+	else
+		EncodeQoi(frame.Pixels.data(), frame.Width, frame.Height, encoded);
+
+	char name[32];
+	snprintf(name, sizeof(name), "/frame_%06llu.%s", frame.Frame, format == CAPTURE_FORMAT_PNG ? "png" : "qoi");
+	WriteEncodedFile(path + name, encoded);
+}
+
+
+void FrameCapture::finish()
+{
+	for (int i = 0; i < CAPTURE_READBACK_COUNT; i++)
+	{
+		Readback& readback = readbacks[(nextReadback + i) % CAPTURE_READBACK_COUNT];
+		if (readback.fence)
+			collect(readback, true);
+	}
+
+	stopEncoders();
+	video.Close();
+}
+
+
+void FrameCapture::stopEncoders()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopping = true;
+	}
+	queueChanged.notify_all();
+
+	for (std::thread& encoder : encoders)
+		encoder.join();
+	encoders.clear();
+}
+
+
+CaptureStats FrameCapture::getStats()
+{
+	std::lock_guard<std::mutex> lock(queueMutex);
+
+	CaptureStats result = stats;
+	if (stats.Encoded > 0)
+		result.MeanEncodeMs = totalEncodeMs / stats.Encoded;
+
+	return result;
+}
+
+
+void FrameCapture::deleteBuffers()
+{
+	finish();
+
+	for (Readback& readback : readbacks)
+	{
+		glDeleteBuffers(1, &readback.buffer);
+		ReleaseGpuMemory(GPU_RESOURCE_BUFFER, readback.buffer);
+	}
+}
+
+
+bool FrameCapture::ParseFormat(const std::string& name, Capture_Format& outFormat)
+{
+	if (name == "png")
+		outFormat = CAPTURE_FORMAT_PNG;
+	else if (name == "qoi")
+		outFormat = CAPTURE_FORMAT_QOI;
+	else if (name == "y4m")
+		outFormat = CAPTURE_FORMAT_Y4M;
+	else
+		return false;
+
+	return true;
+}
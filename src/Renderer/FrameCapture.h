@@ -0,0 +1,145 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "../IO/ImageEncoders.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Pixel buffers read back asynchronously. A frame is mapped this many frames
+// after it was read, so the GPU has finished the copy.
+#define CAPTURE_READBACK_COUNT 3
+
+// Frames copied out of the pixel buffers and waiting for an encoder. Bounds
+// the CPU memory of a capture; further frames are dropped.
+#define CAPTURE_MAX_QUEUED_FRAMES 8
+
+#define CAPTURE_ENCODER_THREADS 2
+
+enum Capture_Format
+{
+	CAPTURE_FORMAT_PNG,
+	CAPTURE_FORMAT_QOI,
+	CAPTURE_FORMAT_Y4M
+};
+
+struct CaptureStats
+{
+	unsigned long long Captured = 0;
+	unsigned long long Encoded = 0;
+
+	// Frames skipped because all pixel buffers were still in flight, or
+	// because the encoders were behind.
+	unsigned long long DroppedReadback = 0;
+	unsigned long long DroppedEncoder = 0;
+
+	// Render thread time spent in capture() per frame.
+	double MeanOverheadMs = 0.0;
+	double MaxOverheadMs = 0.0;
+
+	// Worker time per encoded frame.
+	double MeanEncodeMs = 0.0;
+};
+
+/* Screenshot and video capture of the default framebuffer.
+
+   capture() reads the back buffer into a ring of pixel pack buffers and
+   fences the read. Later frames map buffers whose fence has signalled, copy
+   the pixels into a bounded pool of frames and hand them to encoder threads,
+   which write numbered PNG or QOI images (path is a directory) or stream a
+   Y4M video (path is a file). The render thread never waits: when no buffer
+   or frame is free, the frame is dropped and counted.
+
+   Y4M streams have a fixed frame rate, given by the caller. Interactive
+   frame times vary, so only benchmark and replay captures play back at the
+   speed they were rendered.
+*/
+class FrameCapture
+{
+private:
+
+	struct Readback
+	{
+		unsigned int buffer;
+		size_t size;
+		GLsync fence;
+		unsigned long long frame;
+		int width;
+		int height;
+	};
+
+	struct CapturedFrame
+	{
+		unsigned long long Frame;
+		int Width;
+		int Height;
+		std::vector<uint8_t> Pixels;
+	};
+
+	std::string path;
+	Capture_Format format;
+	int framesPerSecond;
+
+	// Oldest readback first; the next capture reuses it.
+	Readback readbacks[CAPTURE_READBACK_COUNT];
+	int nextReadback;
+	unsigned long long frameIndex;
+
+	// Frames owned by nobody (free), waiting for or being encoded.
+	std::vector<std::unique_ptr<CapturedFrame>> frames;
+	std::vector<CapturedFrame*> freeFrames;
+	std::deque<CapturedFrame*> encodeQueue;
+
+	std::vector<std::thread> encoders;
+	std::mutex queueMutex;
+	std::condition_variable queueChanged;
+	bool stopping;
+
+	// Written by the encoders only once a Y4M stream is open.
+	Y4mWriter video;
+
+	CaptureStats stats;
+	unsigned long long captureCalls;
+	double totalOverheadMs;
+	double totalEncodeMs;
+	bool warnedSizeChange;
+
+public:
+
+	// constructor starts the encoders. Needs a current GL context.
+	FrameCapture(const std::string& path, Capture_Format format, int framesPerSecond);
+	~FrameCapture();
+
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+
+	// Read the back buffer of the default framebuffer. Call after the frame is
+	// drawn, before the swap.
+	void capture(int width, int height);
+
+	// Wait for the readbacks in flight and the encoders, then stop them.
+	void finish();
+
+	CaptureStats getStats();
+
+	// Finish and delete the pixel buffers. Call before the context is destroyed.
+	void deleteBuffers();
+
+	// "png", "qoi" or "y4m". Returns false for anything else.
+	static bool ParseFormat(const std::string& name, Capture_Format& outFormat);
+
+private:
+
+	// Copy a finished readback into a free frame and queue it.
+	void collect(Readback& readback, bool wait);
+
+	void encoderLoop();
+	void encode(CapturedFrame& frame);
+	void stopEncoders();
+};
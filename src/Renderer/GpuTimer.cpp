@@ -0,0 +1,67 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer()
+{
+	glGenQueries(QUERY_COUNT, queries);
+
+	for (int i = 0; i < QUERY_COUNT; i++)
+		queryFrames[i] = -1;
+
+	frameIndex = 0;
+}
+
+
+void GpuTimer::begin()
+{
+	int slot = static_cast<int>(frameIndex % QUERY_COUNT);
+
+	glBeginQuery(GL_TIME_ELAPSED, queries[slot]);
+	queryFrames[slot] = frameIndex;
+}
+
+
+void GpuTimer::end()
+{
+	glEndQuery(GL_TIME_ELAPSED);
+	frameIndex++;
+}
+
+
+bool GpuTimer::collect(long long& outFrame, double& outMs, bool wait)
+{
+	// Oldest first, starting at the slot the next begin() would reuse.
+	int slot = -1;
+	for (int i = 0; i < QUERY_COUNT && slot < 0; i++)
+	{
+		int candidate = static_cast<int>((frameIndex + i) % QUERY_COUNT);
+		if (queryFrames[candidate] >= 0)
+			slot = candidate;
+	}
+
+	if (slot < 0)
+		return false;
+
+	if (!wait)
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+	}
+
+	// Blocks until the result is available.
+	GLuint64 elapsed = 0;
+	glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &elapsed);
+
+	outFrame = queryFrames[slot];
+	outMs = static_cast<double>(elapsed) / 1.0e6;
+
+	queryFrames[slot] = -1;
+	return true;
+}
+
+
+void GpuTimer::deleteQueries()
+{
+	glDeleteQueries(QUERY_COUNT, queries);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glad/glad.h>
+
+/* GPU frame timer using a ring of GL_TIME_ELAPSED queries.
+   Results are read back QUERY_COUNT frames later, so querying never stalls.
+*/
+class GpuTimer
+{
+private:
+
+	static const int QUERY_COUNT = 4;
+
+	unsigned int queries[QUERY_COUNT];
+
+	// Frame each query was issued for, -1 if unused.
+	long long queryFrames[QUERY_COUNT];
+
+	long long frameIndex;
+
+public:
+
+	// constructor creates the queries. Needs a current GL context.
+	GpuTimer();
+
+	// Start timing a frame. Only one frame can be timed at a time.
+	void begin();
+
+	// Stop timing the current frame.
+	void end();
+
+	// Read back the oldest pending query. Returns false if there is none or it
+	// isn't ready; with wait it blocks until the result is (at exit).
+	bool collect(long long& outFrame, double& outMs, bool wait = false);
+
+	// Delete the queries. Call before the context is destroyed.
+	void deleteQueries();
+};
@@ -0,0 +1,131 @@
+#include "InstanceBuffer.h"
+
+#include "../Memory/MemoryTracker.h"
+
+#include <iostream>
+
+// Create an RGBA32F texture buffer and the buffer behind it.
+static void createTextureBuffer(unsigned int& buffer, unsigned int& texture, size_t initialSize)
+{
+	glGenBuffers(1, &buffer);
+	glGenTextures(1, &texture);
+
+	// Texture buffers need storage before they can be attached.
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, initialSize, nullptr, GL_STREAM_DRAW);
+	TrackGpuMemory(GPU_RESOURCE_BUFFER, buffer, MEMORY_CATEGORY_RENDERER, initialSize);
+
+	glBindTexture(GL_TEXTURE_BUFFER, texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+
+// Replace the contents of a texture buffer (orphans the previous storage).
+static void uploadTextureBuffer(unsigned int buffer, const void* data, size_t size)
+{
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	TrackGpuMemory(GPU_RESOURCE_BUFFER, buffer, MEMORY_CATEGORY_RENDERER, size);
+
+	if (size > 0)
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+
+InstanceBuffer::InstanceBuffer(int viewCount)
+{
+	createTextureBuffer(transformBuffer, transformTexture, sizeof(glm::mat4));
+	createTextureBuffer(materialBuffer, materialTexture, sizeof(glm::vec4));
+
+	indexBuffers.resize(viewCount);
+	glGenBuffers(viewCount, indexBuffers.data());
+
+	GLint maxTextureBufferSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTextureBufferSize);
+	maxTexels = static_cast<size_t>(maxTextureBufferSize);
+	clampWarned = false;
+}
+
+
+size_t InstanceBuffer::clampToLimit(size_t count, size_t texelsPerElement)
+{
+	if (count * texelsPerElement <= maxTexels)
+		return count;
+
+	if (!clampWarned)
+	{
+		std::cout << "WARNING::INSTANCE_BUFFER::TOO_MANY_INSTANCES: " << count << " uploaded, GL_MAX_TEXTURE_BUFFER_SIZE allows "
+			<< maxTexels / texelsPerElement << std::endl;
+		clampWarned = true;
+	}
+
+	return maxTexels / texelsPerElement;
+}
+
+
+void InstanceBuffer::uploadTransforms(const glm::mat4* transforms, size_t count)
+{
+	count = clampToLimit(count, 4);
+	uploadTextureBuffer(transformBuffer, transforms, count * sizeof(glm::mat4));
+}
+
+
+void InstanceBuffer::uploadMaterials(const glm::vec4* materials, size_t count)
+{
+	count = clampToLimit(count, 1);
+	uploadTextureBuffer(materialBuffer, materials, count * sizeof(glm::vec4));
+}
+
+
+void InstanceBuffer::uploadViewIndices(int view, const uint32_t* indices, size_t count)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, indexBuffers[view]);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+	TrackGpuMemory(GPU_RESOURCE_BUFFER, indexBuffers[view], MEMORY_CATEGORY_RENDERER, count * sizeof(uint32_t));
+
+	if (count > 0)
+		glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(uint32_t), indices);
+}
+
+
+void InstanceBuffer::bindTransforms(int textureUnit) const
+{
+	glActiveTexture(GL_TEXTURE0 + textureUnit);
+	glBindTexture(GL_TEXTURE_BUFFER, transformTexture);
+}
+
+
+void InstanceBuffer::bindMaterials(int textureUnit) const
+{
+	glActiveTexture(GL_TEXTURE0 + textureUnit);
+	glBindTexture(GL_TEXTURE_BUFFER, materialTexture);
+}
+
+
+void InstanceBuffer::bindViewIndices(int view, unsigned int attribLocation, size_t firstIndex) const
+{
+	glBindBuffer(GL_ARRAY_BUFFER, indexBuffers[view]);
+	glVertexAttribIPointer(attribLocation, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)(firstIndex * sizeof(uint32_t)));
+	glVertexAttribDivisor(attribLocation, 1);
+	glEnableVertexAttribArray(attribLocation);
+}
+
+
+void InstanceBuffer::deleteBuffers()
+{
+	glDeleteTextures(1, &transformTexture);
+	glDeleteBuffers(1, &transformBuffer);
+	glDeleteTextures(1, &materialTexture);
+	glDeleteBuffers(1, &materialBuffer);
+	glDeleteBuffers(static_cast<GLsizei>(indexBuffers.size()), indexBuffers.data());
+
+	ReleaseGpuMemory(GPU_RESOURCE_BUFFER, transformBuffer);
+	ReleaseGpuMemory(GPU_RESOURCE_BUFFER, materialBuffer);
+	for (unsigned int indexBuffer : indexBuffers)
+		ReleaseGpuMemory(GPU_RESOURCE_BUFFER, indexBuffer);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/* Per-instance data shared by several views.
+
+   Transforms of every instance visible in any view are uploaded once into a
+   texture buffer. Each view only uploads a list of uint indices into it, read
+   as an instanced vertex attribute, so instances seen by several cameras are
+   not uploaded once per view. Per-instance material data (texture array
+   layers) is stored the same way, in the same order as the transforms.
+
+   A transform takes four RGBA32F texels, so GL_MAX_TEXTURE_BUFFER_SIZE (at
+   least 65536 texels) bounds the instances per frame. Uploads past it are
+   clamped with a warning. Instances beyond it are still drawn and read
+   undefined transforms (texelFetch past the end of a buffer texture is only
+   defined with robust access), so the warning marks the frame as broken.
+*/
+class InstanceBuffer
+{
+private:
+
+	unsigned int transformBuffer;
+	unsigned int transformTexture;
+
+	unsigned int materialBuffer;
+	unsigned int materialTexture;
+
+	// Per view index buffers.
+	std::vector<unsigned int> indexBuffers;
+
+	// GL_MAX_TEXTURE_BUFFER_SIZE, in texels.
+	size_t maxTexels;
+	bool clampWarned;
+
+	// Clamp an upload of count elements of texelsPerElement to the texture buffer limit.
+	size_t clampToLimit(size_t count, size_t texelsPerElement);
+
+public:
+
+	// constructor creates the buffers. Needs a current GL context.
+	explicit InstanceBuffer(int viewCount);
+
+	// Most instances one transform upload can hold.
+	size_t getMaxInstances() const { return maxTexels / 4; }
+
+	// Upload this frame's transforms (orphans the previous storage).
+	void uploadTransforms(const glm::mat4* transforms, size_t count);
+
+	// Upload this frame's material data, one vec4 per transform.
+	void uploadMaterials(const glm::vec4* materials, size_t count);
+
+	// Upload the indices of the instances a view draws.
+	void uploadViewIndices(int view, const uint32_t* indices, size_t count);
+
+	// Bind the transform buffer texture to a texture unit.
+	void bindTransforms(int textureUnit) const;
+
+	// Bind the material buffer texture to a texture unit.
+	void bindMaterials(int textureUnit) const;
+
+	// Point an integer vertex attribute at a view's indices, starting at firstIndex
+	// (GL 3.3 has no base instance). The VAO must be bound.
+	void bindViewIndices(int view, unsigned int attribLocation, size_t firstIndex = 0) const;
+
+	// Delete the buffers. Call before the context is destroyed.
+	void deleteBuffers();
+};
@@ -0,0 +1,117 @@
+#include "LatencyTracker.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+
+LatencyTracker::LatencyTracker()
+{
+	GLint64 gpuTime = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+	clockOffset = gpuTime * 1.0e-9 - glfwGetTime();
+
+	nextSample = 0;
+	totalLatency = 0.0;
+}
+
+
+void LatencyTracker::endFrame(double inputTime, double latchTime)
+{
+	if (inputTime < 0.0)
+		return;
+
+	PendingFrame frame;
+	frame.InputTime = inputTime;
+	frame.LatchTime = latchTime;
+
+	if (freeQueries.empty())
+	{
+		freeQueries.push_back(0);
+		glGenQueries(1, &freeQueries.back());
+	}
+
+	frame.Query = freeQueries.back();
+	freeQueries.pop_back();
+
+	glQueryCounter(frame.Query, GL_TIMESTAMP);
+	frame.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	pending.push_back(frame);
+}
+
+
+void LatencyTracker::collect()
+{
+	// Frames complete in order.
+	while (!pending.empty())
+	{
+		PendingFrame& frame = pending.front();
+
+		if (glClientWaitSync(frame.Fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+			break;
+
+		GLuint64 gpuTime = 0;
+		glGetQueryObjectui64v(frame.Query, GL_QUERY_RESULT, &gpuTime);
+		double completeTime = gpuTime * 1.0e-9 - clockOffset;
+
+		addSample((completeTime - frame.InputTime) * 1000.0, (frame.LatchTime - frame.InputTime) * 1000.0);
+
+		glDeleteSync(frame.Fence);
+		freeQueries.push_back(frame.Query);
+		pending.pop_front();
+	}
+}
+
+
+void LatencyTracker::addSample(double latency, double inputToLatchLatency)
+{
+	if (latencies.size() < LATENCY_WINDOW_SIZE)
+	{
+		latencies.push_back(latency);
+		inputToLatch.push_back(inputToLatchLatency);
+	}
+	else
+	{
+		latencies[nextSample] = latency;
+		inputToLatch[nextSample] = inputToLatchLatency;
+	}
+
+	nextSample = (nextSample + 1) % LATENCY_WINDOW_SIZE;
+
+	totalLatency += latency;
+	stats.Samples++;
+	stats.TotalMeanMs = totalLatency / stats.Samples;
+
+	// Window statistics.
+	std::vector<double> sorted = latencies;
+	std::sort(sorted.begin(), sorted.end());
+
+	stats.MeanMs = 0.0;
+	stats.MeanInputToLatchMs = 0.0;
+	for (size_t i = 0; i < latencies.size(); i++)
+	{
+		stats.MeanMs += latencies[i];
+		stats.MeanInputToLatchMs += inputToLatch[i];
+	}
+
+	stats.MeanMs /= latencies.size();
+	stats.MeanInputToLatchMs /= latencies.size();
+	stats.P95Ms = sorted[sorted.size() * 95 / 100];
+}
+
+
+void LatencyTracker::deleteQueries()
+{
+	for (PendingFrame& frame : pending)
+	{
+		glDeleteSync(frame.Fence);
+		freeQueries.push_back(frame.Query);
+	}
+
+	pending.clear();
+
+	if (!freeQueries.empty())
+		glDeleteQueries(static_cast<GLsizei>(freeQueries.size()), freeQueries.data());
+
+	freeQueries.clear();
+}
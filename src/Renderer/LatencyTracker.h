@@ -0,0 +1,81 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+/* Input-to-present latency.
+
+   Every frame that shows new input records when the input event arrived,
+   when the camera matrices were latched and when the frame was submitted
+   (CPU clock, glfwGetTime). After the buffer swap a GL_TIMESTAMP query and a
+   fence are issued; once the fence has signaled, the query gives the time
+   the GPU finished the frame, converted to the CPU clock. Nothing waits on
+   the GPU.
+*/
+
+// Frames of the rolling statistics.
+#define LATENCY_WINDOW_SIZE 256
+
+struct LatencyStats
+{
+	// Rolling window, milliseconds.
+	double MeanMs = 0.0;
+	double P95Ms = 0.0;
+
+	// Share of the mean spent between the input event and latching the camera.
+	double MeanInputToLatchMs = 0.0;
+
+	// Since startup.
+	double TotalMeanMs = 0.0;
+	size_t Samples = 0;
+};
+
+class LatencyTracker
+{
+private:
+
+	struct PendingFrame
+	{
+		GLsync Fence;
+		unsigned int Query;
+		double InputTime;
+		double LatchTime;
+	};
+
+	std::deque<PendingFrame> pending;
+	std::vector<unsigned int> freeQueries;
+
+	// GPU timestamp seconds minus glfwGetTime() seconds.
+	double clockOffset;
+
+	std::vector<double> latencies;
+	std::vector<double> inputToLatch;
+	size_t nextSample;
+
+	double totalLatency;
+	LatencyStats stats;
+
+public:
+
+	// constructor calibrates the GPU clock. Needs a current GL context.
+	LatencyTracker();
+
+	// After the buffer swap. inputTime is the newest input event shown by the
+	// frame (negative if none), latchTime when the camera matrices were written.
+	void endFrame(double inputTime, double latchTime);
+
+	// Collect frames the GPU has finished.
+	void collect();
+
+	const LatencyStats& getStats() const { return stats; }
+
+	// Delete queries and fences. Call before the context is destroyed.
+	void deleteQueries();
+
+private:
+
+	void addSample(double latency, double inputToLatchLatency);
+};
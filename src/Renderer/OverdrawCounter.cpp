@@ -0,0 +1,62 @@
+#include "OverdrawCounter.h"
+
+OverdrawCounter::OverdrawCounter()
+{
+	glGenQueries(QUERY_COUNT, queries);
+
+	for (int i = 0; i < QUERY_COUNT; i++)
+		queryPixels[i] = 0;
+
+	frameIndex = 0;
+	fragmentsPerPixel = 0.0;
+	samples = 0;
+}
+
+
+void OverdrawCounter::begin(long long pixelCount)
+{
+	int slot = static_cast<int>(frameIndex % QUERY_COUNT);
+
+	// Still pending after QUERY_COUNT frames: overwrite it rather than wait.
+	glBeginQuery(GL_SAMPLES_PASSED, queries[slot]);
+	queryPixels[slot] = pixelCount > 0 ? pixelCount : 1;
+}
+
+
+void OverdrawCounter::end()
+{
+	glEndQuery(GL_SAMPLES_PASSED);
+	frameIndex++;
+}
+
+
+void OverdrawCounter::collect()
+{
+	// Oldest first, starting at the slot the next begin() would reuse.
+	for (int i = 0; i < QUERY_COUNT; i++)
+	{
+		int slot = static_cast<int>((frameIndex + i) % QUERY_COUNT);
+		if (queryPixels[slot] == 0)
+			continue;
+
+		GLint available = 0;
+		glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+
+		GLuint64 passed = 0;
+		glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &passed);
+
+		double perPixel = static_cast<double>(passed) / static_cast<double>(queryPixels[slot]);
+		fragmentsPerPixel = samples == 0 ? perPixel : fragmentsPerPixel + (perPixel - fragmentsPerPixel) * OVERDRAW_SMOOTHING;
+		samples++;
+
+		queryPixels[slot] = 0;
+	}
+}
+
+
+void OverdrawCounter::deleteQueries()
+{
+	glDeleteQueries(QUERY_COUNT, queries);
+}
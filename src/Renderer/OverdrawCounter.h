@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glad/glad.h>
+
+/* Fragments per pixel of a pass, from a ring of GL_SAMPLES_PASSED queries.
+
+   Counts fragments that pass the depth test. Without a depth pre-pass that
+   includes every fragment later covered by a closer one (overdraw); after a
+   pre-pass only the visible surface remains. Like GpuTimer, results are
+   read back QUERY_COUNT frames later, so querying never stalls.
+*/
+
+// Weight of the newest frame in the averaged fragments per pixel.
+#define OVERDRAW_SMOOTHING 0.1
+
+class OverdrawCounter
+{
+private:
+
+	static const int QUERY_COUNT = 4;
+
+	unsigned int queries[QUERY_COUNT];
+
+	// Pixels covered by each query's pass, 0 if unused.
+	long long queryPixels[QUERY_COUNT];
+
+	long long frameIndex;
+
+	double fragmentsPerPixel;
+	long long samples;
+
+public:
+
+	// constructor creates the queries. Needs a current GL context.
+	OverdrawCounter();
+
+	// Start counting a pass over pixelCount pixels. One pass per frame.
+	void begin(long long pixelCount);
+
+	void end();
+
+	// Read back every finished query.
+	void collect();
+
+	// Averaged over recent frames, 0 before the first result.
+	double getFragmentsPerPixel() const { return fragmentsPerPixel; }
+
+	// Frames with a result so far.
+	long long getSampleCount() const { return samples; }
+
+	// Delete the queries. Call before the context is destroyed.
+	void deleteQueries();
+};
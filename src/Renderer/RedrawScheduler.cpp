@@ -0,0 +1,86 @@
+#include "RedrawScheduler.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+double GetProcessCpuSeconds()
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+		return 0.0;
+
+	// 100 ns units.
+	ULARGE_INTEGER kernelTime, userTime;
+	kernelTime.LowPart = kernel.dwLowDateTime;
+	kernelTime.HighPart = kernel.dwHighDateTime;
+	userTime.LowPart = user.dwLowDateTime;
+	userTime.HighPart = user.dwHighDateTime;
+
+	return static_cast<double>(kernelTime.QuadPart + userTime.QuadPart) * 1.0e-7;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0.0;
+
+	return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+		+ static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1.0e-6;
+#endif
+}
+
+
+RedrawScheduler::RedrawScheduler(bool enabled, double startTime)
+{
+	Enabled = enabled;
+
+	// The first frame always draws.
+	Pending = REDRAW_SCENE | REDRAW_RESIZE;
+	AnimationActive = false;
+	CameraGeneration = 0;
+	CameraMovedTime = startTime;
+
+	StartWallSeconds = startTime;
+	StartCpuSeconds = GetProcessCpuSeconds();
+}
+
+
+void RedrawScheduler::Update(unsigned long long cameraGeneration, bool animating, double currentTime)
+{
+	if (cameraGeneration != CameraGeneration)
+	{
+		Pending |= REDRAW_CAMERA;
+		CameraGeneration = cameraGeneration;
+		CameraMovedTime = currentTime;
+	}
+
+	AnimationActive = animating || currentTime - CameraMovedTime < REDRAW_CAMERA_HOLD;
+}
+
+
+void RedrawScheduler::EndFrame(bool rendered)
+{
+	if (rendered)
+	{
+		Stats.RenderedFrames++;
+		Pending = 0;
+	}
+	else
+	{
+		Stats.SkippedFrames++;
+	}
+}
+
+
+RedrawStats RedrawScheduler::GetStats(double currentTime) const
+{
+	RedrawStats stats = Stats;
+	stats.WallSeconds = currentTime - StartWallSeconds;
+	stats.CpuSeconds = GetProcessCpuSeconds() - StartCpuSeconds;
+
+	return stats;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+/* On-demand rendering.
+
+   Decides per frame whether anything visible changed: input, the camera
+   (Camera::GetGeneration), the scene, streamed resources or the window size.
+   Requests pile up until the next rendered frame. While an animation is
+   active (camera still moving, orbit coasting, scripted runs, capture)
+   every frame renders.
+
+   When nothing is pending the render loop sleeps in glfwWaitEventsTimeout
+   instead of spinning; the timeout bounds how stale a missed change can get.
+   Disabled, every frame renders and the loop never waits, as before.
+*/
+
+// Longest sleep between two checks, in seconds.
+#define REDRAW_WAIT_TIMEOUT 0.25
+
+// Frames keep rendering this long (seconds) after the camera last moved, so
+// frames without a fixed tick don't stall eased motion.
+#define REDRAW_CAMERA_HOLD 0.1
+
+enum Redraw_Reason
+{
+	REDRAW_INPUT = 1 << 0,
+	REDRAW_CAMERA = 1 << 1,
+	REDRAW_SCENE = 1 << 2,
+	REDRAW_RESOURCES = 1 << 3,
+	REDRAW_RESIZE = 1 << 4
+};
+
+struct RedrawStats
+{
+	unsigned long long RenderedFrames = 0;
+
+	// Loop iterations that woke up but found nothing to draw.
+	unsigned long long SkippedFrames = 0;
+
+	double WaitSeconds = 0.0;
+
+	// Since construction.
+	double WallSeconds = 0.0;
+	double CpuSeconds = 0.0;
+};
+
+// User + kernel CPU time of the whole process (all threads), in seconds.
+double GetProcessCpuSeconds();
+
+class RedrawScheduler
+{
+private:
+
+	bool Enabled;
+
+	// Redraw_Reason bits since the last rendered frame.
+	unsigned int Pending;
+	bool AnimationActive;
+
+	unsigned long long CameraGeneration;
+	double CameraMovedTime;
+
+	RedrawStats Stats;
+	double StartWallSeconds;
+	double StartCpuSeconds;
+
+public:
+
+	// startTime: wall clock of the render loop (glfwGetTime) at startup.
+	RedrawScheduler(bool enabled, double startTime);
+
+	void Request(Redraw_Reason reason) { Pending |= reason; }
+
+	// Once per frame after the camera update. Requests a redraw if the camera
+	// generation changed. animating: motion in progress the camera may not show
+	// yet (held keys, a coasting orbit, scripted runs), which renders every frame.
+	void Update(unsigned long long cameraGeneration, bool animating, double currentTime);
+
+	bool ShouldRender() const { return !Enabled || Pending != 0 || AnimationActive; }
+
+	// True when the loop may sleep until the next event.
+	bool CanWait() const { return Enabled && Pending == 0 && !AnimationActive; }
+
+	void AddWaitTime(double seconds) { Stats.WaitSeconds += seconds; }
+
+	// Count the frame. A rendered frame clears the pending requests.
+	void EndFrame(bool rendered);
+
+	bool IsEnabled() const { return Enabled; }
+	unsigned int GetPending() const { return Pending; }
+
+	// Stats with wall and CPU time up to now.
+	RedrawStats GetStats(double currentTime) const;
+};
@@ -0,0 +1,92 @@
+#include "RenderTarget.h"
+
+#include "../Memory/MemoryTracker.h"
+
+#include <iostream>
+
+RenderTarget::RenderTarget(int width, int height, GLenum depthFormat)
+	: framebufferID(0), colorTexture(0), depthBuffer(0), depthFormat(depthFormat), width(width), height(height)
+{
+	glGenFramebuffers(1, &framebufferID);
+	glGenTextures(1, &colorTexture);
+	glGenRenderbuffers(1, &depthBuffer);
+
+	createAttachments();
+}
+
+
+void RenderTarget::deleteBuffers()
+{
+	glDeleteFramebuffers(1, &framebufferID);
+	glDeleteTextures(1, &colorTexture);
+	glDeleteRenderbuffers(1, &depthBuffer);
+
+	ReleaseGpuMemory(GPU_RESOURCE_TEXTURE, colorTexture);
+	ReleaseGpuMemory(GPU_RESOURCE_RENDERBUFFER, depthBuffer);
+}
+
+
+void RenderTarget::resize(int newWidth, int newHeight)
+{
+	if (newWidth == width && newHeight == height)
+		return;
+
+	// Minimized windows report a 0x0 framebuffer.
+	if (newWidth <= 0 || newHeight <= 0)
+		return;
+
+	width = newWidth;
+	height = newHeight;
+
+	createAttachments();
+}
+
+
+void RenderTarget::bind() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+	glViewport(0, 0, width, height);
+}
+
+
+void RenderTarget::blitToDefault(int dstX, int dstY, int dstWidth, int dstHeight) const
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebufferID);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+
+	GLenum filter = (dstWidth == width && dstHeight == height) ? GL_NEAREST : GL_LINEAR;
+	glBlitFramebuffer(0, 0, width, height, dstX, dstY, dstX + dstWidth, dstY + dstHeight, GL_COLOR_BUFFER_BIT, filter);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+
+void RenderTarget::createAttachments()
+{
+	// Color.
+	glBindTexture(GL_TEXTURE_2D, colorTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	TrackGpuMemory(GPU_RESOURCE_TEXTURE, colorTexture, MEMORY_CATEGORY_RENDERER, static_cast<size_t>(width) * height * 4);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// Depth. 24 bit formats are padded to 32.
+	size_t depthBytes = (depthFormat == GL_DEPTH_COMPONENT16) ? 2 : (depthFormat == GL_DEPTH32F_STENCIL8) ? 8 : 4;
+
+	glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, depthFormat, width, height);
+	TrackGpuMemory(GPU_RESOURCE_RENDERBUFFER, depthBuffer, MEMORY_CATEGORY_RENDERER, static_cast<size_t>(width) * height * depthBytes);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::RENDER_TARGET::FRAMEBUFFER_INCOMPLETE\n";
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glad/glad.h>
+
+/* Offscreen framebuffer with a color texture and a depth renderbuffer.
+   The default framebuffer can't be given a float depth buffer, so scenes are
+   rendered here and blitted to the window.
+*/
+class RenderTarget
+{
+private:
+
+	unsigned int framebufferID;
+	unsigned int colorTexture;
+	unsigned int depthBuffer;
+
+	GLenum depthFormat;
+
+	int width;
+	int height;
+
+public:
+
+	// constructor creates the framebuffer and its attachments.
+	RenderTarget(int width, int height, GLenum depthFormat = GL_DEPTH_COMPONENT32F);
+
+	// Delete the framebuffer and its attachments. Call before the context is destroyed.
+	void deleteBuffers();
+
+	// Recreate attachments if the size changed.
+	void resize(int newWidth, int newHeight);
+
+	// Bind as draw framebuffer and set the viewport to cover it.
+	void bind() const;
+
+	// Copy color into a rectangle of the default framebuffer, scaled to fit.
+	void blitToDefault(int dstX, int dstY, int dstWidth, int dstHeight) const;
+
+	unsigned int getFramebufferID() const { return framebufferID; }
+	unsigned int getColorTexture() const { return colorTexture; }
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+private:
+
+	// Allocate attachment storage for the current size.
+	void createAttachments();
+};
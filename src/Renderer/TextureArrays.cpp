@@ -0,0 +1,251 @@
+#include "TextureArrays.h"
+#include "../Memory/MemoryTracker.h"
+
+#include <GLFW/glfw3.h>
+
+#include "../stb_image.h"
+
+#include <algorithm>
+#include <iostream>
+
+// glad is generated for GL 3.3 core, S3TC formats come from GL_EXT_texture_compression_s3tc.
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+
+
+TextureArrays::TextureArrays()
+{
+	maxLayers = 0;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+
+	compressionSupported = glfwExtensionSupported("GL_EXT_texture_compression_s3tc") == GLFW_TRUE;
+}
+
+
+TextureSlot TextureArrays::addTexture(const std::string& imagePath)
+{
+	MemoryScope memory(MEMORY_CATEGORY_TEXTURES);
+
+	auto existing = slots.find(imagePath);
+	if (existing != slots.end())
+		return existing->second;
+
+	TextureSource source;
+	TextureSlot slot;
+
+	// Baked file with precomputed mips.
+	source.Baked.reset(new TextureFile());
+	bool baked = source.Baked->Open(GetBakedTexturePath(imagePath));
+
+	if (baked && source.Baked->GetFormat() != TEXTURE_FORMAT_RGBA8 && !compressionSupported)
+	{
+		std::cout << "WARNING::TEXTURE_ARRAYS: S3TC not supported, decoding " << imagePath << " instead." << std::endl;
+		baked = false;
+	}
+
+	if (baked)
+	{
+		const TextureFileHeader& header = source.Baked->GetHeader();
+		slot = allocateLayer(header.Width, header.Height, source.Baked->GetFormat(), header.LevelCount);
+	}
+	else
+	{
+		source.Baked.reset();
+
+		int width, height, nrChannels;
+		unsigned char* imageData = stbi_load(imagePath.c_str(), &width, &height, &nrChannels, 0);
+		if (!imageData)
+		{
+			std::cout << "ERROR::TEXTURE_ARRAYS::FAILED_TO_LOAD: " << imagePath << std::endl;
+			return TextureSlot();
+		}
+
+		// Level 0 only, build() generates the rest.
+		source.Levels.push_back(MakeTextureImage(imageData, static_cast<uint32_t>(width), static_cast<uint32_t>(height), nrChannels));
+		stbi_image_free(imageData);
+
+		uint32_t levelCount = GetMipLevelCount(source.Levels[0].Width, source.Levels[0].Height);
+		slot = allocateLayer(source.Levels[0].Width, source.Levels[0].Height, TEXTURE_FORMAT_RGBA8, levelCount);
+	}
+
+	arrays[slot.Array].Layers.push_back(sources.size());
+	sources.push_back(std::move(source));
+
+	slots[imagePath] = slot;
+	return slot;
+}
+
+
+TextureSlot TextureArrays::allocateLayer(uint32_t width, uint32_t height, Texture_Format format, uint32_t levelCount)
+{
+	TextureSlot slot;
+
+	for (size_t i = 0; i < arrays.size(); i++)
+	{
+		const ArrayInfo& info = arrays[i];
+
+		if (info.Width == width && info.Height == height && info.Format == format && info.LevelCount == levelCount
+			&& static_cast<int>(info.Layers.size()) < maxLayers)
+		{
+			slot.Array = static_cast<int>(i);
+			break;
+		}
+	}
+
+	if (slot.Array < 0)
+	{
+		ArrayInfo info = { width, height, format, levelCount, {}, 0 };
+		arrays.push_back(info);
+		slot.Array = static_cast<int>(arrays.size() - 1);
+	}
+
+	slot.Layer = static_cast<int>(arrays[slot.Array].Layers.size());
+	return slot;
+}
+
+
+void TextureArrays::build(JobSystem& jobs)
+{
+	MemoryScope memory(MEMORY_CATEGORY_TEXTURES);
+
+	// Decoded images need their mips on the CPU to stream them.
+	for (TextureSource& source : sources)
+	{
+		if (!source.Baked)
+			source.Levels = GenerateMipChain(source.Levels[0], jobs);
+	}
+
+	for (int array = 0; array < getArrayCount(); array++)
+	{
+		ArrayInfo& info = arrays[array];
+		uint32_t tailLevel = getMipTailLevel(array);
+
+		glGenTextures(1, &info.TextureID);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, info.TextureID);
+
+		// Texture Wrapping.
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		// Texture Filtering. Trilinear, so minified textures sample the mip chain
+		// from the current base level down.
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(info.LevelCount - 1));
+
+		// Only the mip tail is resident at first.
+		std::vector<uint8_t> levelData;
+
+		for (uint32_t level = tailLevel; level < info.LevelCount; level++)
+		{
+			size_t layerSize = getLayerLevelSize(array, level);
+			levelData.resize(layerSize * info.Layers.size());
+
+			for (size_t layer = 0; layer < info.Layers.size(); layer++)
+			{
+				const uint8_t* layerData = getLevelData(array, static_cast<int>(layer), level);
+				std::copy(layerData, layerData + layerSize, levelData.begin() + layer * layerSize);
+			}
+
+			uploadLevel(array, level, levelData.data());
+		}
+
+		setBaseLevel(array, tailLevel);
+	}
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+
+void TextureArrays::bind(int array, int textureUnit) const
+{
+	glActiveTexture(GL_TEXTURE0 + textureUnit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, arrays[array].TextureID);
+}
+
+
+uint32_t TextureArrays::getMipTailLevel(int array) const
+{
+	const ArrayInfo& info = arrays[array];
+
+	uint32_t level = 0;
+	while (level + 1 < info.LevelCount && std::max(info.Width >> level, info.Height >> level) > TEXTURE_MIP_TAIL_SIZE)
+		level++;
+
+	return level;
+}
+
+
+size_t TextureArrays::getLayerLevelSize(int array, uint32_t level) const
+{
+	const ArrayInfo& info = arrays[array];
+	return GetTextureLevelSize(info.Format, std::max(info.Width >> level, 1u), std::max(info.Height >> level, 1u));
+}
+
+
+const uint8_t* TextureArrays::getLevelData(int array, int layer, uint32_t level) const
+{
+	const TextureSource& source = sources[arrays[array].Layers[layer]];
+
+	return source.Baked ? source.Baked->GetLevelData(level) : source.Levels[level].Pixels.data();
+}
+
+
+void TextureArrays::uploadLevel(int array, uint32_t level, const void* data)
+{
+	const ArrayInfo& info = arrays[array];
+	GLsizei width = static_cast<GLsizei>(std::max(info.Width >> level, 1u));
+	GLsizei height = static_cast<GLsizei>(std::max(info.Height >> level, 1u));
+	GLsizei layers = static_cast<GLsizei>(info.Layers.size());
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, info.TextureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	if (info.Format == TEXTURE_FORMAT_RGBA8)
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	else
+		glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, getCompressedFormat(array), width, height, layers, 0,
+			static_cast<GLsizei>(getLevelSize(array, level)), data);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	TrackGpuMemory(GPU_RESOURCE_TEXTURE, info.TextureID, MEMORY_CATEGORY_TEXTURES, getLevelSize(array, level), level);
+}
+
+
+void TextureArrays::releaseLevel(int array, uint32_t level)
+{
+	glBindTexture(GL_TEXTURE_2D_ARRAY, arrays[array].TextureID);
+
+	// Re-specifying a level as empty lets the driver free its storage.
+	if (arrays[array].Format == TEXTURE_FORMAT_RGBA8)
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, 0, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	else
+		glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, getCompressedFormat(array), 0, 0, 0, 0, 0, nullptr);
+
+	TrackGpuMemory(GPU_RESOURCE_TEXTURE, arrays[array].TextureID, MEMORY_CATEGORY_TEXTURES, 0, level);
+}
+
+
+void TextureArrays::setBaseLevel(int array, uint32_t baseLevel)
+{
+	glBindTexture(GL_TEXTURE_2D_ARRAY, arrays[array].TextureID);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(baseLevel));
+}
+
+
+void TextureArrays::deleteTextures()
+{
+	for (ArrayInfo& info : arrays)
+	{
+		glDeleteTextures(1, &info.TextureID);
+		ReleaseGpuMemory(GPU_RESOURCE_TEXTURE, info.TextureID);
+		info.TextureID = 0;
+	}
+}
+
+
+GLenum TextureArrays::getCompressedFormat(int array) const
+{
+	return (arrays[array].Format == TEXTURE_FORMAT_BC1) ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "../Jobs/JobSystem.h"
+#include "../Textures/MipGenerator.h"
+#include "../Textures/TextureFile.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Levels no larger than this stay resident (the mip tail), larger ones are streamed.
+#define TEXTURE_MIP_TAIL_SIZE 64
+
+// Where a texture ended up: array and layer within it.
+struct TextureSlot
+{
+	int Array = -1;
+	int Layer = -1;
+};
+
+/* Packs textures of the same size and format into GL_TEXTURE_2D_ARRAY layers.
+
+   Materials refer to textures by layer, so instances with different textures
+   draw in one call as long as their textures share an array. Textures are
+   collected with addTexture() and created together by build(), when the
+   layer count of every array is known.
+
+   Baked textures (.ctex next to the image) are preferred and read from the
+   mapped file; images are decoded and get a CPU mip chain otherwise. The
+   source levels stay available, so build() only uploads the mip tail and
+   larger levels are streamed in and out per array (TextureStreamer).
+*/
+class TextureArrays
+{
+private:
+
+	// One GL array per size / format class.
+	struct ArrayInfo
+	{
+		uint32_t Width;
+		uint32_t Height;
+		Texture_Format Format;
+		uint32_t LevelCount;
+
+		// Source of every layer (index into sources).
+		std::vector<size_t> Layers;
+
+		unsigned int TextureID;
+	};
+
+	// Level data of one texture: a mapped baked file or a decoded mip chain.
+	struct TextureSource
+	{
+		std::unique_ptr<TextureFile> Baked;
+		std::vector<TextureImage> Levels;
+	};
+
+	std::vector<ArrayInfo> arrays;
+	std::vector<TextureSource> sources;
+	std::unordered_map<std::string, TextureSlot> slots;
+
+	int maxLayers;
+	bool compressionSupported;
+
+public:
+
+	// constructor queries the array limits. Needs a current GL context.
+	TextureArrays();
+
+	// Queue a texture (once per path) and return its slot. Array = -1 on failure.
+	TextureSlot addTexture(const std::string& imagePath);
+
+	// Build mip chains of decoded images, create the arrays and upload their mip tails.
+	void build(JobSystem& jobs);
+
+	void bind(int array, int textureUnit) const;
+
+	int getArrayCount() const { return static_cast<int>(arrays.size()); }
+
+	uint32_t getWidth(int array) const { return arrays[array].Width; }
+	uint32_t getHeight(int array) const { return arrays[array].Height; }
+	uint32_t getLevelCount(int array) const { return arrays[array].LevelCount; }
+	int getLayerCount(int array) const { return static_cast<int>(arrays[array].Layers.size()); }
+
+	// First level of the always resident mip tail.
+	uint32_t getMipTailLevel(int array) const;
+
+	// Bytes of one level of one layer.
+	size_t getLayerLevelSize(int array, uint32_t level) const;
+
+	// Bytes of one level of all layers.
+	size_t getLevelSize(int array, uint32_t level) const { return getLayerLevelSize(array, level) * arrays[array].Layers.size(); }
+
+	// Source data of a level. Safe to read from other threads after build().
+	const uint8_t* getLevelData(int array, int layer, uint32_t level) const;
+
+	// Specify a level of all layers from data stored layer after layer. data is
+	// an offset when a GL_PIXEL_UNPACK_BUFFER is bound.
+	void uploadLevel(int array, uint32_t level, const void* data);
+
+	// Free a level's storage. It has to be below the base level.
+	void releaseLevel(int array, uint32_t level);
+
+	// Clamp sampling to levels from baseLevel down.
+	void setBaseLevel(int array, uint32_t baseLevel);
+
+	// Delete the arrays. Call before the context is destroyed.
+	void deleteTextures();
+
+private:
+
+	// Array with a free layer for this class, created if needed.
+	TextureSlot allocateLayer(uint32_t width, uint32_t height, Texture_Format format, uint32_t levelCount);
+
+	GLenum getCompressedFormat(int array) const;
+};
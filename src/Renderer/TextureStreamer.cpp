@@ -0,0 +1,296 @@
+#include "TextureStreamer.h"
+#include "../Memory/MemoryTracker.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+TextureStreamer::TextureStreamer(TextureArrays& arrays, size_t budgetBytes)
+	: textureArrays(arrays)
+{
+	this->budgetBytes = budgetBytes;
+	residentBytes = 0;
+	frame = 0;
+	stopping = false;
+
+	// The mip tail was uploaded by TextureArrays::build().
+	residency.resize(arrays.getArrayCount());
+	for (int array = 0; array < arrays.getArrayCount(); array++)
+	{
+		ArrayResidency& entry = residency[array];
+		entry.ResidentLevel = arrays.getMipTailLevel(array);
+		entry.RequestedLevel = entry.ResidentLevel;
+		entry.Loading = false;
+		entry.LastUsed.assign(arrays.getLevelCount(array), 0);
+
+		for (uint32_t level = entry.ResidentLevel; level < arrays.getLevelCount(array); level++)
+			residentBytes += arrays.getLevelSize(array, level);
+	}
+
+	stats.BudgetBytes = budgetBytes;
+	stats.ResidentBytes = residentBytes;
+
+	worker = std::thread(&TextureStreamer::workerLoop, this);
+}
+
+
+TextureStreamer::~TextureStreamer()
+{
+	stopWorker();
+}
+
+
+void TextureStreamer::beginFrame()
+{
+	frame++;
+
+	for (int array = 0; array < static_cast<int>(residency.size()); array++)
+		residency[array].RequestedLevel = textureArrays.getMipTailLevel(array);
+}
+
+
+void TextureStreamer::requestLevel(int array, uint32_t level)
+{
+	ArrayResidency& entry = residency[array];
+	entry.RequestedLevel = std::min(entry.RequestedLevel, level);
+}
+
+
+void TextureStreamer::update()
+{
+	MemoryScope memory(MEMORY_CATEGORY_TEXTURES);
+
+	stats.CompletedLoads = 0;
+	stats.Evictions = 0;
+
+	// Loads finish in order, stop at the first one still copying.
+	while (!loads.empty() && loads.front()->Done.load(std::memory_order_acquire))
+	{
+		finishLoad(*loads.front());
+		loads.pop_front();
+		stats.CompletedLoads++;
+	}
+
+	for (ArrayResidency& entry : residency)
+	{
+		for (uint32_t level = entry.RequestedLevel; level < entry.LastUsed.size(); level++)
+			entry.LastUsed[level] = frame;
+	}
+
+	// Arrays furthest from their requested level load first.
+	std::vector<int> starved;
+	for (int array = 0; array < static_cast<int>(residency.size()); array++)
+	{
+		if (residency[array].ResidentLevel > residency[array].RequestedLevel)
+			starved.push_back(array);
+	}
+
+	std::sort(starved.begin(), starved.end(), [this](int a, int b)
+	{
+		return residency[a].ResidentLevel - residency[a].RequestedLevel > residency[b].ResidentLevel - residency[b].RequestedLevel;
+	});
+
+	for (int array : starved)
+	{
+		if (loads.size() >= MAX_PENDING_TEXTURE_LOADS)
+			break;
+
+		if (residency[array].Loading)
+			continue;
+
+		uint32_t level = residency[array].ResidentLevel - 1;
+		size_t size = textureArrays.getLevelSize(array, level);
+
+		bool fits = true;
+		while (fits && residentBytes + size > budgetBytes)
+			fits = evictLeastRecentlyUsed();
+
+		if (fits)
+			startLoad(array, level);
+	}
+
+	// A lowered budget is enforced even without loads.
+	while (residentBytes > budgetBytes && evictLeastRecentlyUsed())
+		;
+
+	stats.ResidentBytes = residentBytes;
+	stats.PendingLoads = static_cast<int>(loads.size());
+	stats.StarvedArrays = static_cast<int>(starved.size());
+}
+
+
+bool TextureStreamer::evictLeastRecentlyUsed()
+{
+	int victim = -1;
+	unsigned long long oldest = frame;
+
+	for (int array = 0; array < static_cast<int>(residency.size()); array++)
+	{
+		const ArrayResidency& entry = residency[array];
+
+		if (entry.Loading || entry.ResidentLevel >= textureArrays.getMipTailLevel(array))
+			continue;
+
+		if (entry.LastUsed[entry.ResidentLevel] < oldest)
+		{
+			oldest = entry.LastUsed[entry.ResidentLevel];
+			victim = array;
+		}
+	}
+
+	if (victim < 0)
+		return false;
+
+	ArrayResidency& entry = residency[victim];
+
+	// Stop sampling the level before freeing it.
+	textureArrays.setBaseLevel(victim, entry.ResidentLevel + 1);
+	textureArrays.releaseLevel(victim, entry.ResidentLevel);
+
+	residentBytes -= textureArrays.getLevelSize(victim, entry.ResidentLevel);
+	entry.ResidentLevel++;
+	stats.Evictions++;
+
+	return true;
+}
+
+
+void TextureStreamer::startLoad(int array, uint32_t level)
+{
+	std::unique_ptr<LoadRequest> load(new LoadRequest());
+	load->Array = array;
+	load->Level = level;
+	load->Size = textureArrays.getLevelSize(array, level);
+	load->Done.store(false);
+
+	// Staging memory the worker fills while it is mapped.
+	glGenBuffers(1, &load->PixelBuffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, load->PixelBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, load->Size, nullptr, GL_STREAM_DRAW);
+	TrackGpuMemory(GPU_RESOURCE_BUFFER, load->PixelBuffer, MEMORY_CATEGORY_TEXTURES, load->Size);
+	load->Destination = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, load->Size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (!load->Destination)
+	{
+		glDeleteBuffers(1, &load->PixelBuffer);
+		ReleaseGpuMemory(GPU_RESOURCE_BUFFER, load->PixelBuffer);
+		return;
+	}
+
+	// Reserve the memory now, so later loads see it in the budget.
+	residentBytes += load->Size;
+	residency[array].Loading = true;
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queue.push_back(load.get());
+	}
+	queueChanged.notify_one();
+
+	loads.push_back(std::move(load));
+}
+
+
+void TextureStreamer::finishLoad(LoadRequest& load)
+{
+	ArrayResidency& entry = residency[load.Array];
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, load.PixelBuffer);
+	bool intact = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+
+	// Specify the level from the pixel buffer, then allow sampling it.
+	if (intact)
+		textureArrays.uploadLevel(load.Array, load.Level, nullptr);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glDeleteBuffers(1, &load.PixelBuffer);
+	ReleaseGpuMemory(GPU_RESOURCE_BUFFER, load.PixelBuffer);
+
+	if (intact)
+	{
+		textureArrays.setBaseLevel(load.Array, load.Level);
+		entry.ResidentLevel = load.Level;
+	}
+	else
+	{
+		// Mapped memory was lost (e.g. mode switch), the level is requested again.
+		residentBytes -= load.Size;
+	}
+
+	entry.Loading = false;
+}
+
+
+void TextureStreamer::workerLoop()
+{
+	while (true)
+	{
+		LoadRequest* load;
+
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+
+			if (stopping)
+				return;
+
+			load = queue.front();
+			queue.pop_front();
+		}
+
+		// Layers one after another, as TextureArrays::uploadLevel expects.
+		size_t layerSize = textureArrays.getLayerLevelSize(load->Array, load->Level);
+
+		for (int layer = 0; layer < textureArrays.getLayerCount(load->Array); layer++)
+			memcpy(load->Destination + layer * layerSize, textureArrays.getLevelData(load->Array, layer, load->Level), layerSize);
+
+		load->Done.store(true, std::memory_order_release);
+	}
+}
+
+
+void TextureStreamer::stopWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopping = true;
+	}
+	queueChanged.notify_all();
+
+	if (worker.joinable())
+		worker.join();
+}
+
+
+void TextureStreamer::deleteBuffers()
+{
+	stopWorker();
+
+	for (std::unique_ptr<LoadRequest>& load : loads)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, load->PixelBuffer);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glDeleteBuffers(1, &load->PixelBuffer);
+		ReleaseGpuMemory(GPU_RESOURCE_BUFFER, load->PixelBuffer);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	loads.clear();
+}
+
+
+uint32_t TextureStreamer::GetRequiredLevel(float distance, float radius, uint32_t textureSize, float fovYDegrees, int viewportHeight)
+{
+	// Projected diameter in pixels; inside the bounds the object fills the view.
+	distance = std::max(distance, radius);
+	float screenSize = radius * viewportHeight / (distance * std::tan(glm::radians(fovYDegrees) * 0.5f));
+
+	// The texture spans the object once, every level halves the texels per pixel.
+	float texelsPerPixel = textureSize / std::max(screenSize, 1.0f);
+
+	return texelsPerPixel > 1.0f ? static_cast<uint32_t>(std::log2(texelsPerPixel)) : 0;
+}
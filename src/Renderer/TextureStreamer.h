@@ -0,0 +1,121 @@
+#pragma once
+
+#include "TextureArrays.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Level loads in flight at once.
+#define MAX_PENDING_TEXTURE_LOADS 4
+
+struct TextureStreamingStats
+{
+	size_t ResidentBytes = 0;
+	size_t BudgetBytes = 0;
+
+	// Loads in flight, finished and evicted levels this frame.
+	int PendingLoads = 0;
+	int CompletedLoads = 0;
+	int Evictions = 0;
+
+	// Arrays whose resident mips are coarser than requested.
+	int StarvedArrays = 0;
+};
+
+/* Streams mip levels of texture arrays under a GPU memory budget.
+
+   Every frame the renderer requests the finest level each array needs (from
+   distance and screen size of the instances using it). Missing levels are
+   loaded one at a time per array: a worker thread copies the level of all
+   layers into a mapped pixel buffer, the render thread then specifies the
+   level from it and lowers GL_TEXTURE_BASE_LEVEL. When a load would exceed
+   the budget, the least recently used finest levels of other arrays are
+   released first. The mip tail is never evicted.
+*/
+class TextureStreamer
+{
+private:
+
+	struct ArrayResidency
+	{
+		uint32_t ResidentLevel;
+		uint32_t RequestedLevel;
+		bool Loading;
+
+		// Last frame each level was needed.
+		std::vector<unsigned long long> LastUsed;
+	};
+
+	struct LoadRequest
+	{
+		int Array;
+		uint32_t Level;
+		size_t Size;
+
+		unsigned int PixelBuffer;
+		uint8_t* Destination;
+		std::atomic<bool> Done;
+	};
+
+	TextureArrays& textureArrays;
+	std::vector<ArrayResidency> residency;
+
+	size_t budgetBytes;
+	size_t residentBytes;
+	unsigned long long frame;
+
+	// Loads in flight, owned by the render thread.
+	std::deque<std::unique_ptr<LoadRequest>> loads;
+
+	// Loads waiting for the worker.
+	std::thread worker;
+	std::mutex queueMutex;
+	std::condition_variable queueChanged;
+	std::deque<LoadRequest*> queue;
+	bool stopping;
+
+	TextureStreamingStats stats;
+
+public:
+
+	// Needs built texture arrays and a current GL context.
+	TextureStreamer(TextureArrays& arrays, size_t budgetBytes);
+	~TextureStreamer();
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	// Start a frame: clear the requests of the previous one.
+	void beginFrame();
+
+	// Ask for levels from level down to be resident in an array this frame.
+	void requestLevel(int array, uint32_t level);
+
+	// Finish completed loads, evict and start new loads. Call on the render thread.
+	void update();
+
+	const TextureStreamingStats& getStats() const { return stats; }
+
+	// Finest level needed for an object of radius at distance covering
+	// textureSize texels, in a view of viewportHeight pixels.
+	static uint32_t GetRequiredLevel(float distance, float radius, uint32_t textureSize, float fovYDegrees, int viewportHeight);
+
+	// Stop the worker and delete the pixel buffers. Call before the context is destroyed.
+	void deleteBuffers();
+
+private:
+
+	void workerLoop();
+	void stopWorker();
+
+	// Release the least recently used evictable level not needed this frame.
+	bool evictLeastRecentlyUsed();
+
+	void startLoad(int array, uint32_t level);
+	void finishLoad(LoadRequest& load);
+};
@@ -0,0 +1,224 @@
+#include "CameraRecording.h"
+
+#include <cmath>
+#include <iostream>
+
+// Largest position / angle difference accepted before a replayed tick is snapped.
+#define REPLAY_POSITION_TOLERANCE 1e-4
+#define REPLAY_ANGLE_TOLERANCE 1e-3f
+
+
+static CameraStateRecord CaptureState(const Camera& camera)
+{
+	CameraStateRecord state;
+	dvec3 position = camera.GetPosition();
+
+	state.PositionX = position.x;
+	state.PositionY = position.y;
+	state.PositionZ = position.z;
+	state.Yaw = camera.GetYaw();
+	state.Pitch = camera.GetPitch();
+	state.FOV = camera.GetCurrentFOV();
+	state.Padding = 0.0f;
+
+	return state;
+}
+
+
+CameraRecorder::CameraRecorder()
+{
+	Header = RecordingHeader();
+	StartTime = 0.0;
+}
+
+
+CameraRecorder::~CameraRecorder()
+{
+	Close();
+}
+
+
+bool CameraRecorder::Open(const std::string& path, float tickDuration, double startTime)
+{
+	Close();
+
+	File.open(path, std::ios::binary | std::ios::trunc);
+	if (!File.is_open())
+	{
+		std::cout << "ERROR::CAMERA_RECORDER::FILE_NOT_CREATED: " << path << std::endl;
+		return false;
+	}
+
+	Header.Magic = CAMERA_RECORDING_MAGIC;
+	Header.Version = CAMERA_RECORDING_VERSION;
+	Header.TickDuration = tickDuration;
+	Header.TickCount = 0;
+
+	StartTime = startTime;
+	PendingEvents.clear();
+
+	File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+	return true;
+}
+
+
+void CameraRecorder::Close()
+{
+	if (!File.is_open())
+		return;
+
+	File.seekp(0);
+	File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+	File.close();
+}
+
+
+void CameraRecorder::AddEvent(Input_Event_Type type, double time, float x, float y)
+{
+	if (!File.is_open())
+		return;
+
+	InputEventRecord event;
+	event.Time = static_cast<float>(time - StartTime);
+	event.Type = type;
+	event.X = x;
+	event.Y = y;
+
+	PendingEvents.push_back(event);
+}
+
+
+void CameraRecorder::EndTick(unsigned int movementMask, const Camera& camera)
+{
+	if (!File.is_open())
+		return;
+
+	TickRecord tick;
+	tick.EventCount = static_cast<uint32_t>(PendingEvents.size());
+	tick.MovementMask = movementMask;
+	tick.State = CaptureState(camera);
+
+	File.write(reinterpret_cast<const char*>(&tick), sizeof(tick));
+
+	if (!PendingEvents.empty())
+		File.write(reinterpret_cast<const char*>(PendingEvents.data()), sizeof(InputEventRecord) * PendingEvents.size());
+
+	PendingEvents.clear();
+	Header.TickCount++;
+}
+
+
+CameraReplay::CameraReplay()
+{
+	Header = RecordingHeader();
+	CurrentTick = 0;
+	DivergedTicks = 0;
+}
+
+
+bool CameraReplay::Open(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::CAMERA_REPLAY::FILE_NOT_FOUND: " << path << std::endl;
+		return false;
+	}
+
+	file.seekg(0, std::ios::end);
+	uint64_t remaining = static_cast<uint64_t>(file.tellg());
+	file.seekg(0, std::ios::beg);
+
+	bool valid = remaining >= sizeof(Header)
+		&& file.read(reinterpret_cast<char*>(&Header), sizeof(Header))
+		&& Header.Magic == CAMERA_RECORDING_MAGIC
+		&& Header.Version == CAMERA_RECORDING_VERSION
+		&& Header.TickDuration > 0.0f;
+
+	Ticks.clear();
+	Events.clear();
+	EventOffsets.clear();
+
+	// Counts come from the file, so they are checked against the bytes left
+	// before anything is sized by them.
+	if (valid)
+	{
+		remaining -= sizeof(Header);
+		valid = Header.TickCount <= remaining / sizeof(TickRecord);
+	}
+
+	if (valid)
+	{
+		Ticks.resize(Header.TickCount);
+		EventOffsets.resize(Header.TickCount);
+
+		for (uint32_t i = 0; i < Header.TickCount && valid; i++)
+		{
+			valid = static_cast<bool>(file.read(reinterpret_cast<char*>(&Ticks[i]), sizeof(TickRecord)));
+			EventOffsets[i] = Events.size();
+			remaining -= sizeof(TickRecord);
+
+			// Bytes left for this tick's events once the ticks still to come are reserved.
+			uint64_t eventBytes = remaining - (Header.TickCount - 1 - i) * uint64_t(sizeof(TickRecord));
+			valid = valid && Ticks[i].EventCount <= eventBytes / sizeof(InputEventRecord);
+
+			if (valid && Ticks[i].EventCount > 0)
+			{
+				remaining -= uint64_t(sizeof(InputEventRecord)) * Ticks[i].EventCount;
+				Events.resize(Events.size() + Ticks[i].EventCount);
+				valid = static_cast<bool>(file.read(reinterpret_cast<char*>(&Events[EventOffsets[i]]), sizeof(InputEventRecord) * Ticks[i].EventCount));
+			}
+		}
+	}
+
+	if (!valid)
+	{
+		std::cout << "ERROR::CAMERA_REPLAY::INVALID_RECORDING: " << path << std::endl;
+		Ticks.clear();
+		return false;
+	}
+
+	CurrentTick = 0;
+	DivergedTicks = 0;
+	return true;
+}
+
+
+bool CameraReplay::NextTick(Camera& camera)
+{
+	if (CurrentTick >= Ticks.size())
+		return false;
+
+	const TickRecord& tick = Ticks[CurrentTick];
+	const InputEventRecord* events = Events.data() + EventOffsets[CurrentTick];
+
+	// Same order as live: input events first, then movement at the fixed timestep.
+	for (uint32_t i = 0; i < tick.EventCount; i++)
+	{
+		if (events[i].Type == MOUSE_MOVE_EVENT)
+			camera.ProcessMouseInput(events[i].X, events[i].Y);
+		else if (events[i].Type == MOUSE_SCROLL_EVENT)
+			camera.ProcessMouseScroll(events[i].Y);
+	}
+
+	camera.ProcessKeyboardMask(tick.MovementMask, Header.TickDuration);
+
+	// Snap to the recorded state if replay drifted (e.g. camera code changed),
+	// so the flight path stays identical between runs.
+	const CameraStateRecord& recorded = tick.State;
+	dvec3 recordedPosition(recorded.PositionX, recorded.PositionY, recorded.PositionZ);
+
+	bool diverged = glm::length(camera.GetPosition() - recordedPosition) > REPLAY_POSITION_TOLERANCE
+		|| std::fabs(camera.GetYaw() - recorded.Yaw) > REPLAY_ANGLE_TOLERANCE
+		|| std::fabs(camera.GetPitch() - recorded.Pitch) > REPLAY_ANGLE_TOLERANCE
+		|| std::fabs(camera.GetCurrentFOV() - recorded.FOV) > REPLAY_ANGLE_TOLERANCE;
+
+	if (diverged)
+	{
+		camera.SetState(recordedPosition, recorded.Yaw, recorded.Pitch, recorded.FOV);
+		DivergedTicks++;
+	}
+
+	CurrentTick++;
+	return true;
+}
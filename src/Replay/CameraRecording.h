@@ -0,0 +1,135 @@
+#pragma once
+
+#include "../Camera/Camera.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* Binary camera recording.
+
+   File layout (little endian):
+     RecordingHeader
+     for every tick: TickRecord, followed by TickRecord::EventCount InputEventRecords
+
+   Input events are stored with the tick they were applied in, and the camera
+   state after the tick is stored for validation, so a replay can run the exact
+   same sequence of camera updates at the fixed tick rate.
+*/
+
+#define CAMERA_RECORDING_MAGIC 0x52434D43u	// "CMCR"
+#define CAMERA_RECORDING_VERSION 1u
+
+enum Input_Event_Type : uint32_t
+{
+	MOUSE_MOVE_EVENT,
+	MOUSE_SCROLL_EVENT
+};
+
+struct RecordingHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	float TickDuration;
+	uint32_t TickCount;
+};
+
+struct InputEventRecord
+{
+	// Seconds since recording started.
+	float Time;
+	uint32_t Type;
+	float X;
+	float Y;
+};
+
+struct CameraStateRecord
+{
+	double PositionX;
+	double PositionY;
+	double PositionZ;
+	float Yaw;
+	float Pitch;
+	float FOV;
+	float Padding;
+};
+
+struct TickRecord
+{
+	uint32_t EventCount;
+
+	// MOVEMENT_BIT mask of pressed directions.
+	uint32_t MovementMask;
+
+	CameraStateRecord State;
+};
+
+static_assert(sizeof(RecordingHeader) == 16, "RecordingHeader layout changed");
+static_assert(sizeof(InputEventRecord) == 16, "InputEventRecord layout changed");
+static_assert(sizeof(TickRecord) == 48, "TickRecord layout changed");
+
+
+/* Writes input events and camera states while the app runs live. */
+class CameraRecorder
+{
+private:
+
+	std::ofstream File;
+	RecordingHeader Header;
+	std::vector<InputEventRecord> PendingEvents;
+	double StartTime;
+
+public:
+
+	CameraRecorder();
+	~CameraRecorder();
+
+	// Create the file and write the header. Returns false on failure.
+	bool Open(const std::string& path, float tickDuration, double startTime);
+
+	// Patch the tick count into the header and close the file.
+	void Close();
+
+	bool IsRecording() const { return File.is_open(); }
+
+	// Queue an input event for the next tick.
+	void AddEvent(Input_Event_Type type, double time, float x, float y);
+
+	// Write one tick with its queued events and the resulting camera state.
+	void EndTick(unsigned int movementMask, const Camera& camera);
+};
+
+
+/* Reads a recording and drives a Camera from it, one tick at a time. */
+class CameraReplay
+{
+private:
+
+	RecordingHeader Header;
+	std::vector<TickRecord> Ticks;
+	std::vector<InputEventRecord> Events;
+
+	// First event of every tick.
+	std::vector<size_t> EventOffsets;
+
+	size_t CurrentTick;
+
+	// Ticks whose replayed state differed from the recorded one.
+	size_t DivergedTicks;
+
+public:
+
+	CameraReplay();
+
+	// Load the whole recording. Returns false on failure.
+	bool Open(const std::string& path);
+
+	// Apply the next tick to the camera. Returns false when the recording is exhausted.
+	bool NextTick(Camera& camera);
+
+	float GetTickDuration() const { return Header.TickDuration; }
+	size_t GetTickCount() const { return Ticks.size(); }
+	size_t GetCurrentTick() const { return CurrentTick; }
+	size_t GetDivergedTicks() const { return DivergedTicks; }
+};
@@ -0,0 +1,138 @@
+#include "FrameTimings.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// p-th percentile (0..1) of the non-negative values. Returns -1 if there are none.
+static double Percentile(std::vector<double> values, double p)
+{
+	values.erase(std::remove_if(values.begin(), values.end(), [](double v) { return v < 0.0; }), values.end());
+
+	if (values.empty())
+		return -1.0;
+
+	size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+
+static void PrintRow(const char* label, const std::vector<double>& baseline, const std::vector<double>& current)
+{
+	const double percentiles[] = { 0.5, 0.95, 0.99 };
+
+	std::cout << std::setw(5) << label;
+	for (double p : percentiles)
+	{
+		double before = Percentile(baseline, p);
+		double after = Percentile(current, p);
+		std::cout << "  p" << static_cast<int>(p * 100.0) << " " << before << " -> " << after << " ms";
+	}
+	std::cout << "\n";
+}
+
+
+size_t FrameTimingLog::AddFrame(double cpuMs)
+{
+	Frames.push_back({ cpuMs, -1.0 });
+	return Frames.size() - 1;
+}
+
+
+void FrameTimingLog::SetGpuTime(size_t frame, double gpuMs)
+{
+	if (frame < Frames.size())
+		Frames[frame].GpuMs = gpuMs;
+}
+
+
+bool FrameTimingLog::WriteCSV(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::FRAME_TIMINGS::FILE_NOT_CREATED: " << path << std::endl;
+		return false;
+	}
+
+	file << "frame,cpu_ms,gpu_ms\n";
+	file << std::fixed << std::setprecision(4);
+
+	for (size_t i = 0; i < Frames.size(); i++)
+		file << i << "," << Frames[i].CpuMs << "," << Frames[i].GpuMs << "\n";
+
+	return true;
+}
+
+
+bool FrameTimingLog::ReadCSV(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::FRAME_TIMINGS::FILE_NOT_FOUND: " << path << std::endl;
+		return false;
+	}
+
+	Frames.clear();
+
+	std::string line;
+	std::getline(file, line);	// header.
+
+	while (std::getline(file, line))
+	{
+		std::stringstream row(line);
+		size_t frame;
+		char separator;
+		FrameTiming timing;
+
+		if (row >> frame >> separator >> timing.CpuMs >> separator >> timing.GpuMs)
+			Frames.push_back(timing);
+	}
+
+	return true;
+}
+
+
+bool FrameTimingLog::Compare(const FrameTimingLog& baseline, const FrameTimingLog& current, double tolerance)
+{
+	std::vector<double> cpuBefore, cpuAfter, gpuBefore, gpuAfter;
+
+	for (const FrameTiming& frame : baseline.Frames)
+	{
+		cpuBefore.push_back(frame.CpuMs);
+		gpuBefore.push_back(frame.GpuMs);
+	}
+
+	for (const FrameTiming& frame : current.Frames)
+	{
+		cpuAfter.push_back(frame.CpuMs);
+		gpuAfter.push_back(frame.GpuMs);
+	}
+
+	std::cout << "Frame timings (baseline -> current), " << baseline.Size() << " / " << current.Size() << " frames\n";
+	std::cout << std::fixed << std::setprecision(3);
+	PrintRow("CPU", cpuBefore, cpuAfter);
+	PrintRow("GPU", gpuBefore, gpuAfter);
+
+	bool passed = true;
+
+	double cpuBaseline = Percentile(cpuBefore, 0.95);
+	if (cpuBaseline > 0.0 && Percentile(cpuAfter, 0.95) > cpuBaseline * (1.0 + tolerance))
+	{
+		std::cout << "REGRESSION: CPU p95 frame time\n";
+		passed = false;
+	}
+
+	double gpuBaseline = Percentile(gpuBefore, 0.95);
+	if (gpuBaseline > 0.0 && Percentile(gpuAfter, 0.95) > gpuBaseline * (1.0 + tolerance))
+	{
+		std::cout << "REGRESSION: GPU p95 frame time\n";
+		passed = false;
+	}
+
+	return passed;
+}
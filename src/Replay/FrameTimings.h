@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct FrameTiming
+{
+	double CpuMs;
+
+	// Negative until the GPU query for the frame has been collected.
+	double GpuMs;
+};
+
+/* Per-frame CPU / GPU timings of a replay run.
+   Written as CSV so runs before and after a change can be compared.
+*/
+class FrameTimingLog
+{
+private:
+
+	std::vector<FrameTiming> Frames;
+
+public:
+
+	// Append a frame and return its index.
+	size_t AddFrame(double cpuMs);
+
+	// GPU times arrive a few frames late (queries are read back without stalling).
+	void SetGpuTime(size_t frame, double gpuMs);
+
+	size_t Size() const { return Frames.size(); }
+	const std::vector<FrameTiming>& GetFrames() const { return Frames; }
+
+	// Write "frame,cpu_ms,gpu_ms" rows. Returns false on failure.
+	bool WriteCSV(const std::string& path) const;
+
+	// Read a file written by WriteCSV. Returns false on failure.
+	bool ReadCSV(const std::string& path);
+
+	// Print a summary of both runs. Returns false if the p95 CPU or GPU time of
+	// current is more than tolerance (fraction) slower than baseline.
+	static bool Compare(const FrameTimingLog& baseline, const FrameTimingLog& current, double tolerance);
+};
@@ -0,0 +1,141 @@
+#include "DefaultScene.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <random>
+
+// Unit cube, pos3_color3_uv2.
+static const float CUBE_VERTICES[] = {
+
+	-0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f,
+	 0.5f, -0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 0.0f,
+	 0.5f,  0.5f, -0.5f,  0.0f, 0.0f, 1.0f,  1.0f, 1.0f,
+	 0.5f,  0.5f, -0.5f,  1.0f, 1.0f, 0.0f,  1.0f, 1.0f,
+	-0.5f,  0.5f, -0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 1.0f,
+	-0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f,
+
+	-0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f,
+	 0.5f, -0.5f,  0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 0.0f,
+	 0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  1.0f, 1.0f,
+	 0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  1.0f, 1.0f,
+	-0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 1.0f,
+	-0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f,
+
+	-0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,
+	-0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,
+	-0.5f, -0.5f, -0.5f,  0.0f, 0.0f, 1.0f,  0.0f, 1.0f,
+	-0.5f, -0.5f, -0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 1.0f,
+	-0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 0.0f,
+	-0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,
+
+	 0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,
+	 0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,
+	 0.5f, -0.5f, -0.5f,  0.0f, 0.0f, 1.0f,  0.0f, 1.0f,
+	 0.5f, -0.5f, -0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 1.0f,
+	 0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 0.0f,
+	 0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,
+
+	-0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f,
+	 0.5f, -0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,
+	 0.5f, -0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  1.0f, 0.0f,
+	 0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  1.0f, 0.0f,
+	-0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 0.0f,
+	-0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f,
+
+	-0.5f,  0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f,
+	 0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,
+	 0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  1.0f, 0.0f,
+	 0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  1.0f, 0.0f,
+	-0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 0.0f,
+	-0.5f,  0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f
+};
+
+#define CUBE_VERTEX_COUNT 36
+
+// World space positions of the default cubes.
+static const glm::vec3 CUBE_POSITIONS[] = {
+	glm::vec3(0.0f,  0.0f,  0.0f),
+	glm::vec3(2.0f,  5.0f, -15.0f),
+	glm::vec3(-1.5f, -2.2f, -2.5f),
+	glm::vec3(-3.8f, -2.0f, -12.3f),
+	glm::vec3(2.4f, -0.4f, -3.5f),
+	glm::vec3(-1.7f,  3.0f, -7.5f),
+	glm::vec3(1.3f, -2.0f, -2.5f),
+	glm::vec3(1.5f,  2.0f, -2.5f),
+	glm::vec3(1.5f,  0.2f, -1.5f),
+	glm::vec3(-1.3f,  1.0f, -1.5f)
+};
+
+
+static void AddCubeMaterial(SceneData& scene)
+{
+	SceneMaterialRecord material = {};
+	material.BaseTexture = scene.AddTexture("texture_1.jpg");
+	material.OverlayTexture = scene.AddTexture("texture_2.png");
+	material.TextureInterp = 0.2f;
+
+	scene.Materials.push_back(material);
+}
+
+
+static SceneInstanceRecord MakeInstance(const glm::dvec3& position, const glm::quat& rotation, uint32_t mesh)
+{
+	SceneInstanceRecord instance = {};
+	instance.Position[0] = position.x;
+	instance.Position[1] = position.y;
+	instance.Position[2] = position.z;
+	instance.Rotation[0] = rotation.x;
+	instance.Rotation[1] = rotation.y;
+	instance.Rotation[2] = rotation.z;
+	instance.Rotation[3] = rotation.w;
+	instance.Scale[0] = instance.Scale[1] = instance.Scale[2] = 1.0f;
+	instance.Mesh = mesh;
+	instance.Material = 0;
+
+	return instance;
+}
+
+
+SceneData BuildDefaultScene()
+{
+	SceneData scene;
+	uint32_t cube = scene.AddMesh(CUBE_VERTICES, CUBE_VERTEX_COUNT);
+	AddCubeMaterial(scene);
+
+	const int cubeCount = sizeof(CUBE_POSITIONS) / sizeof(CUBE_POSITIONS[0]);
+
+	for (int i = 0; i < cubeCount; i++)
+	{
+		glm::quat rotation = glm::angleAxis(glm::radians(20.0f * i), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f)));
+		scene.Instances.push_back(MakeInstance(glm::dvec3(CUBE_POSITIONS[i]), rotation, cube));
+	}
+
+	return scene;
+}
+
+
+SceneData BuildCubeFieldScene(size_t cubeCount, double extent, uint32_t seed)
+{
+	SceneData scene;
+	uint32_t cube = scene.AddMesh(CUBE_VERTICES, CUBE_VERTEX_COUNT);
+	AddCubeMaterial(scene);
+
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<double> position(-extent, extent);
+	std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+	std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+
+	scene.Instances.reserve(cubeCount);
+
+	for (size_t i = 0; i < cubeCount; i++)
+	{
+		glm::dvec3 cubePosition(position(random), position(random), position(random));
+		glm::vec3 rotationAxis(axis(random), axis(random), axis(random) + 2.0f);
+
+		glm::quat rotation = glm::angleAxis(glm::radians(angle(random)), glm::normalize(rotationAxis));
+		scene.Instances.push_back(MakeInstance(cubePosition, rotation, cube));
+	}
+
+	return scene;
+}
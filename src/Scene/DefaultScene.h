@@ -0,0 +1,12 @@
+#pragma once
+
+#include "SceneData.h"
+
+#include <cstdint>
+
+// The textured cube scene the viewport shows without a scene file.
+SceneData BuildDefaultScene();
+
+// Randomly placed and rotated cubes within [-extent, extent], for load and
+// rendering benchmarks.
+SceneData BuildCubeFieldScene(size_t cubeCount, double extent, uint32_t seed);
@@ -0,0 +1,222 @@
+#include "SceneData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+uint32_t SceneData::AddMesh(const float* vertices, size_t vertexCount)
+{
+	SceneMeshRecord mesh = {};
+	mesh.VertexOffset = VertexData.size();
+	mesh.VertexCount = static_cast<uint32_t>(vertexCount);
+	mesh.VertexStride = SCENE_VERTEX_FLOATS * sizeof(float);
+	mesh.Layout = SCENE_LAYOUT_POS3_COLOR3_UV2;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		mesh.BoundsMin[axis] = vertexCount > 0 ? vertices[axis] : 0.0f;
+		mesh.BoundsMax[axis] = mesh.BoundsMin[axis];
+	}
+
+	float radiusSquared = 0.0f;
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		const float* position = vertices + i * SCENE_VERTEX_FLOATS;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			mesh.BoundsMin[axis] = std::min(mesh.BoundsMin[axis], position[axis]);
+			mesh.BoundsMax[axis] = std::max(mesh.BoundsMax[axis], position[axis]);
+		}
+
+		radiusSquared = std::max(radiusSquared, position[0] * position[0] + position[1] * position[1] + position[2] * position[2]);
+	}
+
+	// Sphere around the mesh origin, so instance positions are the sphere centers.
+	mesh.BoundingRadius = std::sqrt(radiusSquared);
+
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(vertices);
+	VertexData.insert(VertexData.end(), bytes, bytes + vertexCount * mesh.VertexStride);
+
+	Meshes.push_back(mesh);
+	return static_cast<uint32_t>(Meshes.size() - 1);
+}
+
+
+uint32_t SceneData::AddTexture(const std::string& path)
+{
+	SceneTextureRecord texture = {};
+	memcpy(texture.Path, path.c_str(), std::min<size_t>(path.size(), SCENE_TEXTURE_PATH_LENGTH - 1));
+
+	Textures.push_back(texture);
+	return static_cast<uint32_t>(Textures.size() - 1);
+}
+
+
+SceneView SceneData::GetView() const
+{
+	SceneView view;
+	view.Meshes = Meshes.data();
+	view.MeshCount = Meshes.size();
+	view.VertexData = VertexData.data();
+	view.VertexDataSize = VertexData.size();
+	view.Instances = Instances.data();
+	view.InstanceCount = Instances.size();
+	view.Materials = Materials.data();
+	view.MaterialCount = Materials.size();
+	view.Textures = Textures.data();
+	view.TextureCount = Textures.size();
+
+	return view;
+}
+
+
+void SceneData::SortInstancesByMesh()
+{
+	std::stable_sort(Instances.begin(), Instances.end(),
+		[](const SceneInstanceRecord& a, const SceneInstanceRecord& b) { return a.Mesh < b.Mesh; });
+}
+
+
+bool SceneData::LoadText(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::SCENE_TEXT::FILE_NOT_FOUND: " << path << std::endl;
+		return false;
+	}
+
+	*this = SceneData();
+
+	// Vertices of the mesh being read.
+	std::vector<float> meshVertices;
+	bool readingMesh = false;
+
+	auto finishMesh = [&]
+	{
+		if (readingMesh)
+			AddMesh(meshVertices.data(), meshVertices.size() / SCENE_VERTEX_FLOATS);
+
+		meshVertices.clear();
+		readingMesh = false;
+	};
+
+	std::string line;
+	std::string keyword;
+	int lineNumber = 0;
+
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+
+		std::stringstream row(line.substr(0, line.find('#')));
+		if (!(row >> keyword))
+			continue;
+
+		bool valid = true;
+
+		if (keyword == "v")
+		{
+			float vertex[SCENE_VERTEX_FLOATS];
+			for (float& value : vertex)
+				valid = valid && static_cast<bool>(row >> value);
+
+			valid = valid && readingMesh;
+			if (valid)
+				meshVertices.insert(meshVertices.end(), vertex, vertex + SCENE_VERTEX_FLOATS);
+		}
+		else if (keyword == "instance")
+		{
+			SceneInstanceRecord instance = {};
+			valid = static_cast<bool>(row >> instance.Position[0] >> instance.Position[1] >> instance.Position[2]
+				>> instance.Rotation[0] >> instance.Rotation[1] >> instance.Rotation[2] >> instance.Rotation[3]
+				>> instance.Scale[0] >> instance.Scale[1] >> instance.Scale[2]
+				>> instance.Mesh >> instance.Material);
+
+			if (valid)
+				Instances.push_back(instance);
+		}
+		else if (keyword == "mesh")
+		{
+			finishMesh();
+			readingMesh = true;
+		}
+		else if (keyword == "texture")
+		{
+			std::string texturePath;
+			valid = static_cast<bool>(row >> texturePath);
+
+			if (valid)
+				AddTexture(texturePath);
+		}
+		else if (keyword == "material")
+		{
+			SceneMaterialRecord material = {};
+			valid = static_cast<bool>(row >> material.BaseTexture >> material.OverlayTexture >> material.TextureInterp);
+
+			if (valid)
+				Materials.push_back(material);
+		}
+		else
+		{
+			valid = false;
+		}
+
+		if (!valid)
+		{
+			std::cout << "ERROR::SCENE_TEXT::INVALID_LINE " << lineNumber << ": " << line << std::endl;
+			return false;
+		}
+	}
+
+	finishMesh();
+	return true;
+}
+
+
+bool SceneData::SaveText(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::SCENE_TEXT::FILE_NOT_CREATED: " << path << std::endl;
+		return false;
+	}
+
+	for (const SceneTextureRecord& texture : Textures)
+		file << "texture " << texture.Path << "\n";
+
+	for (const SceneMaterialRecord& material : Materials)
+		file << "material " << material.BaseTexture << " " << material.OverlayTexture << " " << material.TextureInterp << "\n";
+
+	for (const SceneMeshRecord& mesh : Meshes)
+	{
+		file << "mesh\n";
+
+		const float* vertices = reinterpret_cast<const float*>(VertexData.data() + mesh.VertexOffset);
+		for (uint32_t i = 0; i < mesh.VertexCount; i++)
+		{
+			file << "v";
+			for (int j = 0; j < SCENE_VERTEX_FLOATS; j++)
+				file << " " << vertices[i * SCENE_VERTEX_FLOATS + j];
+			file << "\n";
+		}
+	}
+
+	file.precision(17);
+
+	for (const SceneInstanceRecord& instance : Instances)
+	{
+		file << "instance " << instance.Position[0] << " " << instance.Position[1] << " " << instance.Position[2]
+			<< " " << instance.Rotation[0] << " " << instance.Rotation[1] << " " << instance.Rotation[2] << " " << instance.Rotation[3]
+			<< " " << instance.Scale[0] << " " << instance.Scale[1] << " " << instance.Scale[2]
+			<< " " << instance.Mesh << " " << instance.Material << "\n";
+	}
+
+	return true;
+}
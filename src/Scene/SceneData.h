@@ -0,0 +1,60 @@
+#pragma once
+
+#include "SceneFormat.h"
+
+#include <string>
+#include <vector>
+
+/* Non-owning view of scene records. Points either into a mapped scene file
+   or into a SceneData, so the renderer consumes both the same way.
+*/
+struct SceneView
+{
+	const SceneMeshRecord* Meshes = nullptr;
+	size_t MeshCount = 0;
+
+	const uint8_t* VertexData = nullptr;
+	size_t VertexDataSize = 0;
+
+	const SceneInstanceRecord* Instances = nullptr;
+	size_t InstanceCount = 0;
+
+	const SceneMaterialRecord* Materials = nullptr;
+	size_t MaterialCount = 0;
+
+	const SceneTextureRecord* Textures = nullptr;
+	size_t TextureCount = 0;
+};
+
+
+/* Scene held in memory, used to build scenes and to convert between the text
+   and binary formats.
+
+   Text format, one record per line ('#' starts a comment):
+     texture <path>
+     material <baseTexture> <overlayTexture> <textureInterp>
+     mesh                                  (starts a pos3_color3_uv2 mesh)
+     v <x> <y> <z> <r> <g> <b> <u> <v>     (vertex of the last mesh)
+     instance <x> <y> <z> <qx> <qy> <qz> <qw> <sx> <sy> <sz> <mesh> <material>
+*/
+struct SceneData
+{
+	std::vector<SceneMeshRecord> Meshes;
+	std::vector<uint8_t> VertexData;
+	std::vector<SceneInstanceRecord> Instances;
+	std::vector<SceneMaterialRecord> Materials;
+	std::vector<SceneTextureRecord> Textures;
+
+	// Append a mesh from interleaved pos3_color3_uv2 floats. Computes its bounds.
+	uint32_t AddMesh(const float* vertices, size_t vertexCount);
+
+	uint32_t AddTexture(const std::string& path);
+
+	SceneView GetView() const;
+
+	// Stable-sort instances by mesh (required by the binary format).
+	void SortInstancesByMesh();
+
+	bool LoadText(const std::string& path);
+	bool SaveText(const std::string& path) const;
+};
@@ -0,0 +1,203 @@
+#include "SceneFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+
+SceneFile::SceneFile()
+{
+	Header = nullptr;
+}
+
+
+bool SceneFile::Open(const std::string& path)
+{
+	Close();
+
+	if (!File.Open(path))
+	{
+		std::cout << "ERROR::SCENE_FILE::FILE_NOT_FOUND: " << path << std::endl;
+		return false;
+	}
+
+	Header = reinterpret_cast<const SceneFileHeader*>(File.GetData());
+
+	bool valid = File.GetSize() >= sizeof(SceneFileHeader)
+		&& Header->Magic == SCENE_FILE_MAGIC
+		&& Header->Version == SCENE_FILE_VERSION
+		&& Header->FileSize == File.GetSize();
+
+	// Pointer fixup: section offsets become pointers into the mapping.
+	if (valid)
+	{
+		View.Meshes = reinterpret_cast<const SceneMeshRecord*>(GetSection(SCENE_SECTION_MESHES, sizeof(SceneMeshRecord)));
+		View.VertexData = GetSection(SCENE_SECTION_VERTICES, 1);
+		View.Instances = reinterpret_cast<const SceneInstanceRecord*>(GetSection(SCENE_SECTION_INSTANCES, sizeof(SceneInstanceRecord)));
+		View.Materials = reinterpret_cast<const SceneMaterialRecord*>(GetSection(SCENE_SECTION_MATERIALS, sizeof(SceneMaterialRecord)));
+		View.Textures = reinterpret_cast<const SceneTextureRecord*>(GetSection(SCENE_SECTION_TEXTURES, sizeof(SceneTextureRecord)));
+
+		View.MeshCount = static_cast<size_t>(Header->Sections[SCENE_SECTION_MESHES].Count);
+		View.VertexDataSize = static_cast<size_t>(Header->Sections[SCENE_SECTION_VERTICES].Size);
+		View.InstanceCount = static_cast<size_t>(Header->Sections[SCENE_SECTION_INSTANCES].Count);
+		View.MaterialCount = static_cast<size_t>(Header->Sections[SCENE_SECTION_MATERIALS].Count);
+		View.TextureCount = static_cast<size_t>(Header->Sections[SCENE_SECTION_TEXTURES].Count);
+
+		valid = (View.Meshes || View.MeshCount == 0)
+			&& (View.VertexData || View.VertexDataSize == 0)
+			&& (View.Instances || View.InstanceCount == 0)
+			&& (View.Materials || View.MaterialCount == 0)
+			&& (View.Textures || View.TextureCount == 0);
+	}
+
+	// Indices between records must stay in range, so users don't check again.
+	for (size_t i = 0; valid && i < View.MeshCount; i++)
+	{
+		const SceneMeshRecord& mesh = View.Meshes[i];
+		valid = mesh.Layout == SCENE_LAYOUT_POS3_COLOR3_UV2
+			&& mesh.VertexStride == SCENE_VERTEX_FLOATS * sizeof(float) && mesh.VertexOffset % mesh.VertexStride == 0
+			&& mesh.VertexOffset <= View.VertexDataSize
+			&& static_cast<uint64_t>(mesh.VertexCount) * mesh.VertexStride <= View.VertexDataSize - mesh.VertexOffset;
+	}
+
+	for (size_t i = 0; valid && i < View.InstanceCount; i++)
+	{
+		const SceneInstanceRecord& instance = View.Instances[i];
+		valid = instance.Mesh < View.MeshCount && (instance.Material < View.MaterialCount || View.MaterialCount == 0)
+			&& (i == 0 || View.Instances[i - 1].Mesh <= instance.Mesh);
+	}
+
+	for (size_t i = 0; valid && i < View.MaterialCount; i++)
+		valid = View.Materials[i].BaseTexture < View.TextureCount && View.Materials[i].OverlayTexture < View.TextureCount;
+
+	for (size_t i = 0; valid && i < View.TextureCount; i++)
+		valid = View.Textures[i].Path[SCENE_TEXTURE_PATH_LENGTH - 1] == '\0';
+
+	if (!valid)
+	{
+		std::cout << "ERROR::SCENE_FILE::INVALID_FILE: " << path << std::endl;
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+void SceneFile::Close()
+{
+	File.Close();
+	Header = nullptr;
+	View = SceneView();
+}
+
+
+const uint8_t* SceneFile::GetSection(Scene_Section section, size_t recordSize) const
+{
+	const SceneSection& entry = Header->Sections[section];
+
+	if (entry.Size == 0)
+		return nullptr;
+
+	bool inBounds = entry.Offset % SCENE_SECTION_ALIGNMENT == 0
+		&& entry.Offset <= File.GetSize()
+		&& entry.Size <= File.GetSize() - entry.Offset
+		// Divided, so a huge file-supplied count can't wrap around.
+		&& entry.Count <= entry.Size / recordSize;
+
+	return inBounds ? File.GetData() + entry.Offset : nullptr;
+}
+
+
+bool WriteSceneFile(const std::string& path, const SceneData& scene)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::SCENE_FILE::FILE_NOT_CREATED: " << path << std::endl;
+		return false;
+	}
+
+	SceneFileHeader header = {};
+	header.Magic = SCENE_FILE_MAGIC;
+	header.Version = SCENE_FILE_VERSION;
+
+	// World bounds from instance positions and their meshes' bounding spheres.
+	for (int axis = 0; axis < 3; axis++)
+	{
+		header.BoundsMin[axis] = scene.Instances.empty() ? 0.0 : INFINITY;
+		header.BoundsMax[axis] = scene.Instances.empty() ? 0.0 : -INFINITY;
+	}
+
+	for (const SceneInstanceRecord& instance : scene.Instances)
+	{
+		float scale = std::max(std::fabs(instance.Scale[0]), std::max(std::fabs(instance.Scale[1]), std::fabs(instance.Scale[2])));
+		double radius = instance.Mesh < scene.Meshes.size() ? scene.Meshes[instance.Mesh].BoundingRadius * scale : 0.0;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			header.BoundsMin[axis] = std::min(header.BoundsMin[axis], instance.Position[axis] - radius);
+			header.BoundsMax[axis] = std::max(header.BoundsMax[axis], instance.Position[axis] + radius);
+		}
+	}
+
+	// Section placement.
+	const void* sectionData[SCENE_SECTION_COUNT] = {
+		scene.Meshes.data(), scene.VertexData.data(), scene.Instances.data(), scene.Materials.data(), scene.Textures.data()
+	};
+
+	header.Sections[SCENE_SECTION_MESHES].Count = scene.Meshes.size();
+	header.Sections[SCENE_SECTION_MESHES].Size = scene.Meshes.size() * sizeof(SceneMeshRecord);
+	header.Sections[SCENE_SECTION_VERTICES].Count = scene.VertexData.size();
+	header.Sections[SCENE_SECTION_VERTICES].Size = scene.VertexData.size();
+	header.Sections[SCENE_SECTION_INSTANCES].Count = scene.Instances.size();
+	header.Sections[SCENE_SECTION_INSTANCES].Size = scene.Instances.size() * sizeof(SceneInstanceRecord);
+	header.Sections[SCENE_SECTION_MATERIALS].Count = scene.Materials.size();
+	header.Sections[SCENE_SECTION_MATERIALS].Size = scene.Materials.size() * sizeof(SceneMaterialRecord);
+	header.Sections[SCENE_SECTION_TEXTURES].Count = scene.Textures.size();
+	header.Sections[SCENE_SECTION_TEXTURES].Size = scene.Textures.size() * sizeof(SceneTextureRecord);
+
+	uint64_t offset = AlignUp(sizeof(SceneFileHeader), SCENE_SECTION_ALIGNMENT);
+	for (uint32_t section = 0; section < SCENE_SECTION_COUNT; section++)
+	{
+		header.Sections[section].Offset = offset;
+		offset = AlignUp(offset + header.Sections[section].Size, SCENE_SECTION_ALIGNMENT);
+	}
+	header.FileSize = offset;
+
+	// Header, then every section padded to the alignment.
+	std::vector<char> padding(SCENE_SECTION_ALIGNMENT, 0);
+	uint64_t written = 0;
+
+	auto writeBytes = [&](const void* data, uint64_t size)
+	{
+		file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+		written += size;
+	};
+
+	writeBytes(&header, sizeof(header));
+
+	for (uint32_t section = 0; section < SCENE_SECTION_COUNT; section++)
+	{
+		writeBytes(padding.data(), header.Sections[section].Offset - written);
+
+		if (header.Sections[section].Size > 0)
+			writeBytes(sectionData[section], header.Sections[section].Size);
+	}
+
+	writeBytes(padding.data(), header.FileSize - written);
+
+	if (!file)
+	{
+		std::cout << "ERROR::SCENE_FILE::WRITE_FAILED: " << path << std::endl;
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "SceneData.h"
+#include "../IO/MappedFile.h"
+
+#include <string>
+
+/* Memory-mapped binary scene. Open() validates the header and section bounds;
+   records are then used in place from the mapping, without parsing or copying.
+*/
+class SceneFile
+{
+private:
+
+	MappedFile File;
+	const SceneFileHeader* Header;
+	SceneView View;
+
+public:
+
+	SceneFile();
+
+	// Map and validate the file. Returns false on failure.
+	bool Open(const std::string& path);
+
+	void Close();
+
+	const SceneFileHeader& GetHeader() const { return *Header; }
+
+	// Records pointing into the mapping. Valid until Close().
+	const SceneView& GetView() const { return View; }
+
+private:
+
+	// Pointer to a section, or nullptr if it is out of bounds or misaligned.
+	const uint8_t* GetSection(Scene_Section section, size_t recordSize) const;
+};
+
+// Write a scene as a binary scene file. Instances have to be sorted by mesh.
+bool WriteSceneFile(const std::string& path, const SceneData& scene);
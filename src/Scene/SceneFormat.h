@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+
+/* Binary scene file layout (version 1, little endian).
+
+   SceneFileHeader at offset 0, followed by sections. Every section starts on a
+   SCENE_SECTION_ALIGNMENT boundary, so a mapped file can be used in place:
+   loading is validating the header and adding section offsets to the base
+   pointer, and vertex data can be uploaded straight from the mapped pages.
+
+   Instances are sorted by mesh, so per-mesh draws are contiguous ranges.
+*/
+
+#define SCENE_FILE_MAGIC 0x4E435343u	// "CSCN"
+#define SCENE_FILE_VERSION 1u
+
+// Page size, so sections can be mapped and uploaded directly.
+#define SCENE_SECTION_ALIGNMENT 4096u
+
+enum Scene_Section : uint32_t
+{
+	SCENE_SECTION_MESHES,
+	SCENE_SECTION_VERTICES,
+	SCENE_SECTION_INSTANCES,
+	SCENE_SECTION_MATERIALS,
+	SCENE_SECTION_TEXTURES,
+	SCENE_SECTION_COUNT
+};
+
+// Interleaved vertex layouts.
+enum Scene_Vertex_Layout : uint32_t
+{
+	// vec3 position, vec3 color, vec2 uv (32 bytes).
+	SCENE_LAYOUT_POS3_COLOR3_UV2
+};
+
+// Floats per pos3_color3_uv2 vertex. The renderer's vertex array uses this stride for every mesh.
+#define SCENE_VERTEX_FLOATS 8
+
+#define SCENE_TEXTURE_PATH_LENGTH 124
+
+struct SceneSection
+{
+	uint64_t Offset;
+	uint64_t Size;
+	uint64_t Count;
+	uint64_t Reserved;
+};
+
+struct SceneFileHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t FileSize;
+
+	// World bounds of all instances.
+	double BoundsMin[3];
+	double BoundsMax[3];
+
+	SceneSection Sections[SCENE_SECTION_COUNT];
+};
+
+struct SceneMeshRecord
+{
+	// Byte offset into the vertex section.
+	uint64_t VertexOffset;
+	uint32_t VertexCount;
+	uint32_t VertexStride;
+	uint32_t Layout;
+
+	// Local bounds.
+	float BoundsMin[3];
+	float BoundsMax[3];
+	float BoundingRadius;
+};
+
+struct SceneInstanceRecord
+{
+	double Position[3];
+	float Rotation[4];	// x, y, z, w
+	float Scale[3];
+	uint32_t Mesh;
+	uint32_t Material;
+	uint32_t Padding;
+};
+
+struct SceneMaterialRecord
+{
+	// Indices into the texture section.
+	uint32_t BaseTexture;
+	uint32_t OverlayTexture;
+	float TextureInterp;
+	uint32_t Padding;
+};
+
+struct SceneTextureRecord
+{
+	// Null terminated, relative to the working directory.
+	char Path[SCENE_TEXTURE_PATH_LENGTH];
+	uint32_t Flags;
+};
+
+static_assert(sizeof(SceneSection) == 32, "SceneSection layout changed");
+static_assert(sizeof(SceneFileHeader) == 224, "SceneFileHeader layout changed");
+static_assert(sizeof(SceneMeshRecord) == 48, "SceneMeshRecord layout changed");
+static_assert(sizeof(SceneInstanceRecord) == 64, "SceneInstanceRecord layout changed");
+static_assert(sizeof(SceneMaterialRecord) == 16, "SceneMaterialRecord layout changed");
+static_assert(sizeof(SceneTextureRecord) == 128, "SceneTextureRecord layout changed");
@@ -0,0 +1,309 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <initializer_list>
+#include <iostream>
+#include <numeric>
+
+#include <immintrin.h>
+
+// Nodes processed together in SIMD lanes.
+#define TRANSFORM_SIMD_WIDTH 4
+
+
+TransformHierarchy::TransformHierarchy()
+{
+	Sorted = true;
+}
+
+
+void TransformHierarchy::Reserve(size_t count)
+{
+	for (std::vector<float>* values : { &PositionX, &PositionY, &PositionZ, &RotationX, &RotationY, &RotationZ, &RotationW, &ScaleX, &ScaleY, &ScaleZ })
+		values->reserve(count);
+
+	Parent.reserve(count);
+	Depth.reserve(count);
+	LocalDirty.reserve(count);
+	WorldDirty.reserve(count);
+	WorldMatrices.reserve(count);
+}
+
+
+int32_t TransformHierarchy::AddNode(int32_t parent, const vec3& position, const quat& rotation, const vec3& scale)
+{
+	int32_t node = static_cast<int32_t>(Parent.size());
+
+	PositionX.push_back(position.x);
+	PositionY.push_back(position.y);
+	PositionZ.push_back(position.z);
+
+	RotationX.push_back(rotation.x);
+	RotationY.push_back(rotation.y);
+	RotationZ.push_back(rotation.z);
+	RotationW.push_back(rotation.w);
+
+	ScaleX.push_back(scale.x);
+	ScaleY.push_back(scale.y);
+	ScaleZ.push_back(scale.z);
+
+	uint32_t depth = parent >= 0 ? Depth[parent] + 1 : 0;
+
+	// Appending a node shallower than the last one breaks the level order.
+	if (!Depth.empty() && depth < Depth.back())
+		Sorted = false;
+
+	Parent.push_back(parent);
+	Depth.push_back(depth);
+	LocalDirty.push_back(1);
+	WorldDirty.push_back(0);
+	WorldMatrices.push_back(glm::mat4(1.0f));
+
+	return node;
+}
+
+
+template <typename T>
+void TransformHierarchy::Permute(std::vector<T>& values, const std::vector<int32_t>& order)
+{
+	std::vector<T> permuted(values.size());
+
+	for (size_t i = 0; i < order.size(); i++)
+		permuted[i] = values[order[i]];
+
+	values.swap(permuted);
+}
+
+
+std::vector<int32_t> TransformHierarchy::SortByDepth()
+{
+	size_t count = Parent.size();
+
+	// order[new] = old, stable so siblings keep their relative order.
+	std::vector<int32_t> order(count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](int32_t a, int32_t b) { return Depth[a] < Depth[b]; });
+
+	std::vector<int32_t> remap(count);
+	for (size_t i = 0; i < count; i++)
+		remap[order[i]] = static_cast<int32_t>(i);
+
+	for (std::vector<float>* values : { &PositionX, &PositionY, &PositionZ, &RotationX, &RotationY, &RotationZ, &RotationW, &ScaleX, &ScaleY, &ScaleZ })
+		Permute(*values, order);
+
+	Permute(Parent, order);
+	Permute(Depth, order);
+	Permute(LocalDirty, order);
+	Permute(WorldDirty, order);
+	Permute(WorldMatrices, order);
+
+	for (int32_t& parent : Parent)
+	{
+		if (parent >= 0)
+			parent = remap[parent];
+	}
+
+	// Level ranges.
+	LevelOffsets.clear();
+	for (size_t i = 0; i < count; i++)
+	{
+		while (LevelOffsets.size() <= Depth[i])
+			LevelOffsets.push_back(i);
+	}
+	LevelOffsets.push_back(count);
+
+	Sorted = true;
+	return remap;
+}
+
+
+void TransformHierarchy::SetLocalPosition(int32_t node, const vec3& position)
+{
+	PositionX[node] = position.x;
+	PositionY[node] = position.y;
+	PositionZ[node] = position.z;
+	LocalDirty[node] = 1;
+}
+
+
+void TransformHierarchy::SetLocalRotation(int32_t node, const quat& rotation)
+{
+	RotationX[node] = rotation.x;
+	RotationY[node] = rotation.y;
+	RotationZ[node] = rotation.z;
+	RotationW[node] = rotation.w;
+	LocalDirty[node] = 1;
+}
+
+
+void TransformHierarchy::SetLocalScale(int32_t node, const vec3& scale)
+{
+	ScaleX[node] = scale.x;
+	ScaleY[node] = scale.y;
+	ScaleZ[node] = scale.z;
+	LocalDirty[node] = 1;
+}
+
+
+size_t TransformHierarchy::Update(JobSystem& jobs)
+{
+	// Sorting here would move nodes under indices the caller still holds.
+	bool sorted = Parent.empty() || (Sorted && !LevelOffsets.empty() && LevelOffsets.back() == Parent.size());
+	assert(sorted && "SortByDepth() must be called after adding nodes");
+	if (!sorted)
+	{
+		std::cout << "ERROR::TRANSFORM_HIERARCHY::NOT_SORTED: " << Parent.size() << " nodes" << std::endl;
+		return 0;
+	}
+
+	std::atomic<size_t> updated(0);
+
+	// Levels run in order (children read their parent's world matrix),
+	// nodes within a level in parallel.
+	for (size_t level = 0; level + 1 < LevelOffsets.size(); level++)
+	{
+		size_t levelBegin = LevelOffsets[level];
+		size_t levelEnd = LevelOffsets[level + 1];
+
+		jobs.ParallelFor(levelEnd - levelBegin, UPDATE_BATCH_SIZE, [&](size_t begin, size_t end)
+		{
+			updated += UpdateRange(levelBegin + begin, levelBegin + end);
+		});
+	}
+
+	return updated;
+}
+
+
+size_t TransformHierarchy::UpdateRange(size_t begin, size_t end)
+{
+	size_t updated = 0;
+
+	for (size_t base = begin; base < end; base += TRANSFORM_SIMD_WIDTH)
+	{
+		size_t lanes = std::min<size_t>(TRANSFORM_SIMD_WIDTH, end - base);
+
+		// Which lanes need a new world matrix.
+		bool needsUpdate[TRANSFORM_SIMD_WIDTH] = {};
+		bool anyUpdate = false;
+
+		for (size_t lane = 0; lane < lanes; lane++)
+		{
+			size_t node = base + lane;
+			int32_t parent = Parent[node];
+
+			needsUpdate[lane] = LocalDirty[node] || (parent >= 0 && WorldDirty[parent]);
+			anyUpdate |= needsUpdate[lane];
+		}
+
+		if (!anyUpdate)
+		{
+			for (size_t lane = 0; lane < lanes; lane++)
+				WorldDirty[base + lane] = 0;
+			continue;
+		}
+
+		// Load TRS of the group into SIMD lanes (tail lanes padded with the last node).
+		float laneValues[10][TRANSFORM_SIMD_WIDTH];
+		for (size_t lane = 0; lane < TRANSFORM_SIMD_WIDTH; lane++)
+		{
+			size_t node = base + std::min(lane, lanes - 1);
+			laneValues[0][lane] = RotationX[node];
+			laneValues[1][lane] = RotationY[node];
+			laneValues[2][lane] = RotationZ[node];
+			laneValues[3][lane] = RotationW[node];
+			laneValues[4][lane] = ScaleX[node];
+			laneValues[5][lane] = ScaleY[node];
+			laneValues[6][lane] = ScaleZ[node];
+			laneValues[7][lane] = PositionX[node];
+			laneValues[8][lane] = PositionY[node];
+			laneValues[9][lane] = PositionZ[node];
+		}
+
+		__m128 qx = _mm_loadu_ps(laneValues[0]);
+		__m128 qy = _mm_loadu_ps(laneValues[1]);
+		__m128 qz = _mm_loadu_ps(laneValues[2]);
+		__m128 qw = _mm_loadu_ps(laneValues[3]);
+		__m128 sx = _mm_loadu_ps(laneValues[4]);
+		__m128 sy = _mm_loadu_ps(laneValues[5]);
+		__m128 sz = _mm_loadu_ps(laneValues[6]);
+
+		// Rotation matrix from quaternion, 4 nodes at once (glm::mat3_cast layout).
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+
+		__m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+		__m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+		__m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+		// Columns scaled by the node's scale.
+		__m128 m00 = _mm_mul_ps(sx, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))));
+		__m128 m01 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_add_ps(xy, wz)));
+		__m128 m02 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_sub_ps(xz, wy)));
+
+		__m128 m10 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_sub_ps(xy, wz)));
+		__m128 m11 = _mm_mul_ps(sy, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))));
+		__m128 m12 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_add_ps(yz, wx)));
+
+		__m128 m20 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_add_ps(xz, wy)));
+		__m128 m21 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_sub_ps(yz, wx)));
+		__m128 m22 = _mm_mul_ps(sz, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))));
+
+		// Local matrix elements per lane: [column][row] for the 3x3 part.
+		alignas(16) float local[9][TRANSFORM_SIMD_WIDTH];
+		_mm_store_ps(local[0], m00); _mm_store_ps(local[1], m01); _mm_store_ps(local[2], m02);
+		_mm_store_ps(local[3], m10); _mm_store_ps(local[4], m11); _mm_store_ps(local[5], m12);
+		_mm_store_ps(local[6], m20); _mm_store_ps(local[7], m21); _mm_store_ps(local[8], m22);
+
+		for (size_t lane = 0; lane < lanes; lane++)
+		{
+			size_t node = base + lane;
+			WorldDirty[node] = needsUpdate[lane];
+			LocalDirty[node] = 0;
+
+			if (!needsUpdate[lane])
+				continue;
+
+			__m128 localColumns[4] = {
+				_mm_setr_ps(local[0][lane], local[1][lane], local[2][lane], 0.0f),
+				_mm_setr_ps(local[3][lane], local[4][lane], local[5][lane], 0.0f),
+				_mm_setr_ps(local[6][lane], local[7][lane], local[8][lane], 0.0f),
+				_mm_setr_ps(laneValues[7][lane], laneValues[8][lane], laneValues[9][lane], 1.0f)
+			};
+
+			float* world = &WorldMatrices[node][0][0];
+			int32_t parent = Parent[node];
+
+			if (parent < 0)
+			{
+				for (int column = 0; column < 4; column++)
+					_mm_storeu_ps(world + column * 4, localColumns[column]);
+			}
+			else
+			{
+				// world = parentWorld * local, one column at a time.
+				const float* parentWorld = &WorldMatrices[parent][0][0];
+				__m128 p0 = _mm_loadu_ps(parentWorld);
+				__m128 p1 = _mm_loadu_ps(parentWorld + 4);
+				__m128 p2 = _mm_loadu_ps(parentWorld + 8);
+				__m128 p3 = _mm_loadu_ps(parentWorld + 12);
+
+				for (int column = 0; column < 4; column++)
+				{
+					__m128 c = localColumns[column];
+					__m128 result = _mm_mul_ps(p0, _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 0, 0)));
+					result = _mm_add_ps(result, _mm_mul_ps(p1, _mm_shuffle_ps(c, c, _MM_SHUFFLE(1, 1, 1, 1))));
+					result = _mm_add_ps(result, _mm_mul_ps(p2, _mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2))));
+					result = _mm_add_ps(result, _mm_mul_ps(p3, _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3))));
+					_mm_storeu_ps(world + column * 4, result);
+				}
+			}
+
+			updated++;
+		}
+	}
+
+	return updated;
+}
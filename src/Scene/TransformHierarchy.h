@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../Jobs/JobSystem.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using glm::vec3;
+using glm::quat;
+
+/* Scene transforms stored as structure of arrays with a parent-index hierarchy.
+
+   Nodes are kept sorted by depth, so every parent is updated before its
+   children and each depth level can be updated in parallel. Local changes set
+   a dirty flag, and only dirty nodes and their descendants recompute their
+   world matrix.
+*/
+class TransformHierarchy
+{
+private:
+
+	// Local transform.
+	std::vector<float> PositionX, PositionY, PositionZ;
+	std::vector<float> RotationX, RotationY, RotationZ, RotationW;
+	std::vector<float> ScaleX, ScaleY, ScaleZ;
+
+	// Parent node, -1 for roots. Always smaller than the node's own index after SortByDepth().
+	std::vector<int32_t> Parent;
+	std::vector<uint32_t> Depth;
+
+	// Local transform changed since the last update.
+	std::vector<uint8_t> LocalDirty;
+
+	// World matrix changed in the last update (read by children).
+	std::vector<uint8_t> WorldDirty;
+
+	std::vector<glm::mat4> WorldMatrices;
+
+	// First node of every depth level, plus one past the last node.
+	std::vector<size_t> LevelOffsets;
+
+	bool Sorted;
+
+public:
+
+	// Nodes per job batch. A multiple of the SIMD width.
+	static const size_t UPDATE_BATCH_SIZE = 2048;
+
+	TransformHierarchy();
+
+	void Reserve(size_t count);
+
+	// Append a node (parent = -1 for a root) and return its index.
+	// The parent has to exist already.
+	int32_t AddNode(int32_t parent, const vec3& position, const quat& rotation = quat(1.0f, 0.0f, 0.0f, 0.0f), const vec3& scale = vec3(1.0f));
+
+	// Reorder nodes by depth. Returns the new index of every old index.
+	// Must be called after adding nodes and before Update().
+	std::vector<int32_t> SortByDepth();
+
+	void SetLocalPosition(int32_t node, const vec3& position);
+	void SetLocalRotation(int32_t node, const quat& rotation);
+	void SetLocalScale(int32_t node, const vec3& scale);
+
+	// Recompute world matrices of dirty subtrees, level by level, in parallel batches.
+	// Returns the number of nodes recomputed; nothing is updated until the
+	// nodes added since the last SortByDepth() are sorted.
+	size_t Update(JobSystem& jobs);
+
+	const glm::mat4& GetWorldMatrix(int32_t node) const { return WorldMatrices[node]; }
+	const glm::mat4* GetWorldMatrices() const { return WorldMatrices.data(); }
+
+	int32_t GetParent(int32_t node) const { return Parent[node]; }
+	size_t Size() const { return Parent.size(); }
+
+private:
+
+	// Update nodes [begin, end) of one level. Returns the number of nodes recomputed.
+	size_t UpdateRange(size_t begin, size_t end);
+
+	template <typename T>
+	static void Permute(std::vector<T>& values, const std::vector<int32_t>& order);
+};
@@ -0,0 +1,67 @@
+#include "WorldPositions.h"
+
+#include <immintrin.h>
+
+// Subtract origin from count doubles and convert the result to float.
+static void SubtractAndConvert(const double* in, double origin, float* out, size_t count)
+{
+	size_t i = 0;
+
+#if defined(__AVX__)
+	const __m256d origin4 = _mm256_set1_pd(origin);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128 low = _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(in + i), origin4));
+		__m128 high = _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(in + i + 4), origin4));
+		_mm_storeu_ps(out + i, low);
+		_mm_storeu_ps(out + i + 4, high);
+	}
+#else
+	const __m128d origin2 = _mm_set1_pd(origin);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 low = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(in + i), origin2));
+		__m128 high = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(in + i + 2), origin2));
+		_mm_storeu_ps(out + i, _mm_movelh_ps(low, high));
+	}
+#endif
+
+	for (; i < count; i++)
+		out[i] = static_cast<float>(in[i] - origin);
+}
+
+
+void WorldPositions::Reserve(size_t count)
+{
+	X.reserve(count);
+	Y.reserve(count);
+	Z.reserve(count);
+}
+
+
+size_t WorldPositions::Add(const dvec3& position)
+{
+	X.push_back(position.x);
+	Y.push_back(position.y);
+	Z.push_back(position.z);
+
+	return X.size() - 1;
+}
+
+
+void WorldPositions::Set(size_t index, const dvec3& position)
+{
+	X[index] = position.x;
+	Y[index] = position.y;
+	Z[index] = position.z;
+}
+
+
+void WorldPositions::ToCameraRelative(const dvec3& origin, float* outX, float* outY, float* outZ) const
+{
+	SubtractAndConvert(X.data(), origin.x, outX, X.size());
+	SubtractAndConvert(Y.data(), origin.y, outY, Y.size());
+	SubtractAndConvert(Z.data(), origin.z, outZ, Z.size());
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstddef>
+
+using glm::dvec3;
+
+/* Double precision world positions stored as structure of arrays.
+   Objects far away from the origin lose precision in float, so positions are
+   kept in double and only converted to float after the camera position has been
+   subtracted (camera-relative rendering).
+*/
+class WorldPositions
+{
+private:
+
+	std::vector<double> X;
+	std::vector<double> Y;
+	std::vector<double> Z;
+
+public:
+
+	void Reserve(size_t count);
+
+	// Append a position and return its index.
+	size_t Add(const dvec3& position);
+
+	void Set(size_t index, const dvec3& position);
+
+	dvec3 Get(size_t index) const { return dvec3(X[index], Y[index], Z[index]); }
+
+	size_t Size() const { return X.size(); }
+
+	// Subtract origin in double and write float results (SoA, Size() elements each).
+	// Vectorized with AVX when available, SSE2 otherwise.
+	void ToCameraRelative(const dvec3& origin, float* outX, float* outY, float* outZ) const;
+};
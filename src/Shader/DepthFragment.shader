@@ -0,0 +1,6 @@
+#version 330 core
+
+// Depth pre-pass: no color output, the fixed-function depth write is all that runs.
+void main()
+{
+}
\ No newline at end of file
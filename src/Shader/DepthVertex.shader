@@ -0,0 +1,31 @@
+#version 330 core
+
+// Depth pre-pass: positions only, transformed exactly like Vertex.shader.
+layout(location = 0) in vec3 aPos;
+
+// Index into the shared instance transforms.
+layout(location = 3) in uint aInstance;
+
+// Model matrices, 4 texels (columns) per instance.
+uniform samplerBuffer instanceTransforms;
+
+layout(std140) uniform CameraBlock
+{
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+};
+
+// Depth has to match the shading pass bit for bit.
+invariant gl_Position;
+
+void main()
+{
+	int base = int(aInstance) * 4;
+	mat4 modelMatrix = mat4(
+		texelFetch(instanceTransforms, base),
+		texelFetch(instanceTransforms, base + 1),
+		texelFetch(instanceTransforms, base + 2),
+		texelFetch(instanceTransforms, base + 3));
+
+	gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(aPos, 1.0f);
+}
\ No newline at end of file
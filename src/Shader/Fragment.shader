@@ -4,13 +4,23 @@ out vec4 FragColor;
 in vec3 ourColor;
 in vec2 TexCoord;
 
-uniform sampler2D texture1;
-uniform sampler2D texture2;
+// Base layer, overlay layer, overlay blend of the instance's material.
+flat in vec3 material;
 
-uniform float textureInterp;
+// Base and overlay textures of the draw's materials, one layer each. The two
+// arrays differ when a material's textures differ in size or format.
+uniform sampler2DArray materialTextures;
+uniform sampler2DArray overlayTextures;
+
+// Added to every material's overlay blend (UP / DOWN keys).
+uniform float textureInterpOffset;
 
 void main()
 {
-	FragColor = mix(texture(texture1, TexCoord), texture(texture2, TexCoord), textureInterp) * vec4(ourColor, 1.0f);
-	//FragColor = mix(texture(texture1, TexCoord), texture(texture2, TexCoord), textureInterp);
+	float textureInterp = clamp(material.z + textureInterpOffset, 0.0f, 1.0f);
+
+	vec4 baseColor = texture(materialTextures, vec3(TexCoord, material.x));
+	vec4 overlayColor = texture(overlayTextures, vec3(TexCoord, material.y));
+
+	FragColor = mix(baseColor, overlayColor, textureInterp) * vec4(ourColor, 1.0f);
 }
\ No newline at end of file
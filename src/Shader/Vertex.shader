@@ -4,16 +4,40 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aColor;
 layout(location = 2) in vec2 aTexCoord;
 
+// Index into the shared instance transforms.
+layout(location = 3) in uint aInstance;
+
 out vec3 ourColor;
 out vec2 TexCoord;
+flat out vec3 material;
+
+// Model matrices, 4 texels (columns) per instance.
+uniform samplerBuffer instanceTransforms;
+
+// Material texture layers and overlay blend, 1 texel per instance.
+uniform samplerBuffer instanceMaterials;
 
-uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projectionMatrix;
+// Matrices of the current view (CameraUniforms), written late in the frame.
+layout(std140) uniform CameraBlock
+{
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+};
+
+// Computed exactly like DepthVertex.shader, so the depth pre-pass can test GL_EQUAL.
+invariant gl_Position;
 
 void main()
 {
+	int base = int(aInstance) * 4;
+	mat4 modelMatrix = mat4(
+		texelFetch(instanceTransforms, base),
+		texelFetch(instanceTransforms, base + 1),
+		texelFetch(instanceTransforms, base + 2),
+		texelFetch(instanceTransforms, base + 3));
+
 	gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(aPos, 1.0f);
 	ourColor = aColor;
 	TexCoord = aTexCoord;
+	material = texelFetch(instanceMaterials, int(aInstance)).xyz;
 }
\ No newline at end of file
@@ -0,0 +1,453 @@
+#include "MipGenerator.h"
+#include "TextureFormat.h"
+
+#include "../Math/SimdMath.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Destination rows per batch.
+#define MIP_ROW_BATCH_SIZE 8
+
+// Entries of the linear to sRGB table.
+#define LINEAR_TO_SRGB_TABLE_SIZE 4096
+
+static const float PI = 3.14159265358979f;
+
+
+#pragma region Srgb
+
+static float SrgbToLinear(float value)
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+
+static float LinearToSrgb(float value)
+{
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+
+// Lookup tables for both directions of the sRGB transfer function. The
+// encode table is 32-bit so AVX2 can gather from it.
+struct SrgbTables
+{
+	float ToLinear[256];
+	int32_t ToSrgb[LINEAR_TO_SRGB_TABLE_SIZE];
+
+	SrgbTables()
+	{
+		for (int i = 0; i < 256; i++)
+			ToLinear[i] = SrgbToLinear(i / 255.0f);
+
+		for (int i = 0; i < LINEAR_TO_SRGB_TABLE_SIZE; i++)
+			ToSrgb[i] = static_cast<int32_t>(LinearToSrgb(i / float(LINEAR_TO_SRGB_TABLE_SIZE - 1)) * 255.0f + 0.5f);
+	}
+};
+
+static const SrgbTables& GetSrgbTables()
+{
+	static const SrgbTables tables;
+	return tables;
+}
+
+
+// Two pixels per iteration: colors through the table, alpha scaled. Returns
+// the pixels written.
+SIMD_TARGET_AVX2
+static uint32_t EncodeRowAvx2(const float* linear, uint8_t* out, uint32_t width, const int32_t* toSrgb)
+{
+	const __m256 tableScale = _mm256_set1_ps(LINEAR_TO_SRGB_TABLE_SIZE - 1.0f);
+	const __m256 alphaScale = _mm256_set1_ps(255.0f);
+	const __m256 half = _mm256_set1_ps(0.5f);
+
+	uint32_t x = 0;
+	for (; x + 2 <= width; x += 2)
+	{
+		__m256 value = _mm256_loadu_ps(linear + x * 4);
+
+		__m256i tableIndex = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, tableScale), half));
+		__m256i color = _mm256_i32gather_epi32(toSrgb, tableIndex, 4);
+		__m256i alpha = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, alphaScale), half));
+
+		__m256i pixels = _mm256_blend_epi32(color, alpha, 0x88);
+		pixels = _mm256_packus_epi32(pixels, pixels);
+		pixels = _mm256_packus_epi16(pixels, pixels);
+
+		uint32_t first = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_castsi256_si128(pixels)));
+		uint32_t second = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_extracti128_si256(pixels, 1)));
+
+		std::memcpy(out + x * 4, &first, 4);
+		std::memcpy(out + x * 4 + 4, &second, 4);
+	}
+
+	return x;
+}
+
+
+// Linear RGBA floats in [0, 1] to sRGB encoded RGBA8.
+static void EncodeRow(const float* linear, uint8_t* out, uint32_t width)
+{
+	const SrgbTables& srgb = GetSrgbTables();
+	uint32_t x = 0;
+
+	if (HasAvx2Fma())
+		x = EncodeRowAvx2(linear, out, width, srgb.ToSrgb);
+
+	for (; x < width; x++)
+	{
+		for (int c = 0; c < 3; c++)
+			out[x * 4 + c] = static_cast<uint8_t>(srgb.ToSrgb[static_cast<int>(linear[x * 4 + c] * (LINEAR_TO_SRGB_TABLE_SIZE - 1) + 0.5f)]);
+
+		out[x * 4 + 3] = static_cast<uint8_t>(linear[x * 4 + 3] * 255.0f + 0.5f);
+	}
+}
+
+#pragma endregion
+
+
+#pragma region Filters
+
+// Source texels and weights of every destination texel along one axis.
+struct FilterTaps
+{
+	uint32_t TapCount;
+	std::vector<uint32_t> Index;
+	std::vector<float> Weight;
+};
+
+static FilterTaps BuildBoxTaps(uint32_t sourceSize, uint32_t destinationSize)
+{
+	FilterTaps taps;
+	taps.TapCount = 2;
+
+	for (uint32_t x = 0; x < destinationSize; x++)
+	{
+		taps.Index.push_back(std::min(x * 2, sourceSize - 1));
+		taps.Index.push_back(std::min(x * 2 + 1, sourceSize - 1));
+		taps.Weight.push_back(0.5f);
+		taps.Weight.push_back(0.5f);
+	}
+
+	return taps;
+}
+
+
+// Modified Bessel function of the first kind, order 0.
+static double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+
+	for (int k = 1; k < 32; k++)
+	{
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+
+	return sum;
+}
+
+
+static FilterTaps BuildKaiserTaps(uint32_t sourceSize, uint32_t destinationSize)
+{
+	FilterTaps taps;
+
+	// Axis that doesn't shrink any more (e.g. 1 texel wide) is copied.
+	if (sourceSize == destinationSize)
+	{
+		taps.TapCount = 1;
+		for (uint32_t x = 0; x < destinationSize; x++)
+		{
+			taps.Index.push_back(x);
+			taps.Weight.push_back(1.0f);
+		}
+
+		return taps;
+	}
+
+	double scale = double(sourceSize) / destinationSize;
+	double radius = KAISER_FILTER_WIDTH * scale;
+	double windowNormalization = 1.0 / BesselI0(KAISER_FILTER_ALPHA);
+
+	taps.TapCount = static_cast<uint32_t>(std::ceil(radius * 2.0)) + 1;
+
+	for (uint32_t x = 0; x < destinationSize; x++)
+	{
+		double center = (x + 0.5) * scale;
+		int64_t first = static_cast<int64_t>(std::floor(center - radius));
+
+		double weightSum = 0.0;
+		size_t firstWeight = taps.Weight.size();
+
+		for (uint32_t k = 0; k < taps.TapCount; k++)
+		{
+			int64_t i = first + k;
+
+			// Distance in destination texels.
+			double t = (i + 0.5 - center) / scale;
+			double weight = 0.0;
+
+			if (std::fabs(t) < KAISER_FILTER_WIDTH)
+			{
+				double sinc = (t == 0.0) ? 1.0 : std::sin(PI * t) / (PI * t);
+				double window = t / KAISER_FILTER_WIDTH;
+				weight = sinc * BesselI0(KAISER_FILTER_ALPHA * std::sqrt(1.0 - window * window)) * windowNormalization;
+			}
+
+			// Wrap like GL_REPEAT.
+			int64_t wrapped = ((i % sourceSize) + sourceSize) % sourceSize;
+			taps.Index.push_back(static_cast<uint32_t>(wrapped));
+			taps.Weight.push_back(static_cast<float>(weight));
+			weightSum += weight;
+		}
+
+		for (uint32_t k = 0; k < taps.TapCount; k++)
+			taps.Weight[firstWeight + k] = static_cast<float>(taps.Weight[firstWeight + k] / weightSum);
+	}
+
+	return taps;
+}
+
+
+// Eight floats per iteration. Returns the floats accumulated.
+SIMD_TARGET_AVX2
+static size_t AccumulateRowAvx2(float* acc, const float* row, float weight, size_t count)
+{
+	__m256 weight8 = _mm256_set1_ps(weight);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+		_mm256_storeu_ps(acc + i, _mm256_fmadd_ps(_mm256_loadu_ps(row + i), weight8, _mm256_loadu_ps(acc + i)));
+
+	return i;
+}
+
+
+// acc += row * weight over count floats.
+static void AccumulateRow(float* acc, const float* row, float weight, size_t count)
+{
+	size_t i = 0;
+
+	if (HasAvx2Fma())
+		i = AccumulateRowAvx2(acc, row, weight, count);
+
+	__m128 weight4 = _mm_set1_ps(weight);
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(_mm_loadu_ps(row + i), weight4)));
+
+	for (; i < count; i++)
+		acc[i] += row[i] * weight;
+}
+
+
+// Box filter of even sources: two destination pixels from four source pixels.
+// Returns the pixels written.
+SIMD_TARGET_AVX2
+static uint32_t FilterRowBoxAvx2(const float* row, const uint32_t* index, float* out, uint32_t width)
+{
+	const __m256 half = _mm256_set1_ps(0.5f);
+
+	uint32_t x = 0;
+	for (; x + 2 <= width && index[x * 2 + 3] == x * 2 + 3; x += 2)
+	{
+		__m256 a = _mm256_loadu_ps(row + x * 8);
+		__m256 b = _mm256_loadu_ps(row + x * 8 + 8);
+
+		__m256 low = _mm256_permute2f128_ps(a, b, 0x20);
+		__m256 high = _mm256_permute2f128_ps(a, b, 0x31);
+
+		_mm256_storeu_ps(out + x * 4, _mm256_mul_ps(_mm256_add_ps(low, high), half));
+	}
+
+	return x;
+}
+
+
+// Horizontal taps over a vertically filtered row, one RGBA pixel per SSE register.
+static void FilterRowHorizontal(const float* row, const FilterTaps& taps, float* out, uint32_t width)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	uint32_t x = 0;
+
+	if (taps.TapCount == 2 && HasAvx2Fma())
+		x = FilterRowBoxAvx2(row, taps.Index.data(), out, width);
+
+	for (; x < width; x++)
+	{
+		const uint32_t* index = &taps.Index[x * taps.TapCount];
+		const float* weight = &taps.Weight[x * taps.TapCount];
+
+		__m128 sum = zero;
+		for (uint32_t k = 0; k < taps.TapCount; k++)
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(row + index[k] * 4), _mm_set1_ps(weight[k])));
+
+		// Negative lobes can overshoot.
+		_mm_storeu_ps(out + x * 4, _mm_min_ps(_mm_max_ps(sum, zero), one));
+	}
+}
+
+#pragma endregion
+
+
+// Float RGBA level, linear colors.
+struct LinearImage
+{
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	std::vector<float> Pixels;
+};
+
+
+/* Rows of the level being filtered. Float levels are read in place; the RGBA8
+   base level is decoded on demand into a few cached rows, so consecutive
+   destination rows of a batch reuse the rows they share.
+*/
+class SourceRows
+{
+private:
+
+	const TextureImage* Encoded;
+	const LinearImage* Linear;
+
+	std::vector<float> Buffer;
+	std::vector<int64_t> CachedRows;
+	size_t NextSlot;
+
+public:
+
+	SourceRows(const TextureImage* encoded, const LinearImage* linear, size_t cacheRows)
+	{
+		Encoded = encoded;
+		Linear = linear;
+		NextSlot = 0;
+
+		if (Encoded)
+		{
+			Buffer.resize(cacheRows * Encoded->Width * 4);
+			CachedRows.assign(cacheRows, -1);
+		}
+	}
+
+	const float* Get(uint32_t y)
+	{
+		if (!Encoded)
+			return Linear->Pixels.data() + static_cast<size_t>(y) * Linear->Width * 4;
+
+		size_t rowFloats = static_cast<size_t>(Encoded->Width) * 4;
+
+		for (size_t slot = 0; slot < CachedRows.size(); slot++)
+		{
+			if (CachedRows[slot] == y)
+				return Buffer.data() + slot * rowFloats;
+		}
+
+		const SrgbTables& srgb = GetSrgbTables();
+		const uint8_t* source = Encoded->Pixels.data() + y * rowFloats;
+		float* row = Buffer.data() + NextSlot * rowFloats;
+
+		for (size_t i = 0; i < rowFloats; i += 4)
+		{
+			row[i] = srgb.ToLinear[source[i]];
+			row[i + 1] = srgb.ToLinear[source[i + 1]];
+			row[i + 2] = srgb.ToLinear[source[i + 2]];
+			row[i + 3] = source[i + 3] * (1.0f / 255.0f);
+		}
+
+		CachedRows[NextSlot] = y;
+		NextSlot = (NextSlot + 1) % CachedRows.size();
+
+		return row;
+	}
+};
+
+
+TextureImage MakeTextureImage(const uint8_t* pixels, uint32_t width, uint32_t height, int channels)
+{
+	TextureImage image;
+	image.Width = width;
+	image.Height = height;
+	image.Pixels.resize(static_cast<size_t>(width) * height * 4);
+
+	size_t pixelCount = static_cast<size_t>(width) * height;
+
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		const uint8_t* source = pixels + i * channels;
+		uint8_t* destination = &image.Pixels[i * 4];
+
+		// Grey (+ alpha) expands to RGB.
+		destination[0] = source[0];
+		destination[1] = channels >= 3 ? source[1] : source[0];
+		destination[2] = channels >= 3 ? source[2] : source[0];
+		destination[3] = (channels == 4) ? source[3] : (channels == 2) ? source[1] : 255;
+	}
+
+	return image;
+}
+
+
+std::vector<TextureImage> GenerateMipChain(const TextureImage& image, JobSystem& jobs, Mip_Filter filter)
+{
+	uint32_t levelCount = GetMipLevelCount(image.Width, image.Height);
+	std::vector<TextureImage> levels(levelCount);
+	levels[0] = image;
+
+	LinearImage source;
+	LinearImage destination;
+
+	for (uint32_t level = 1; level < levelCount; level++)
+	{
+		uint32_t srcWidth = levels[level - 1].Width;
+		uint32_t srcHeight = levels[level - 1].Height;
+
+		TextureImage& mip = levels[level];
+		mip.Width = std::max(srcWidth / 2, 1u);
+		mip.Height = std::max(srcHeight / 2, 1u);
+		mip.Pixels.resize(static_cast<size_t>(mip.Width) * mip.Height * 4);
+
+		destination.Width = mip.Width;
+		destination.Height = mip.Height;
+		destination.Pixels.resize(mip.Pixels.size());
+
+		FilterTaps horizontal = (filter == MIP_FILTER_KAISER) ? BuildKaiserTaps(srcWidth, mip.Width) : BuildBoxTaps(srcWidth, mip.Width);
+		FilterTaps vertical = (filter == MIP_FILTER_KAISER) ? BuildKaiserTaps(srcHeight, mip.Height) : BuildBoxTaps(srcHeight, mip.Height);
+
+		// Level 1 reads the RGBA8 base level, later levels the previous float level.
+		const TextureImage* encodedSource = (level == 1) ? &levels[0] : nullptr;
+
+		jobs.ParallelFor(mip.Height, MIP_ROW_BATCH_SIZE, [&](size_t begin, size_t end)
+		{
+			SourceRows rows(encodedSource, &source, vertical.TapCount + 2);
+			std::vector<float> column(static_cast<size_t>(srcWidth) * 4);
+
+			for (size_t y = begin; y < end; y++)
+			{
+				// Vertical taps first, then horizontal taps on the summed row.
+				std::fill(column.begin(), column.end(), 0.0f);
+
+				for (uint32_t k = 0; k < vertical.TapCount; k++)
+				{
+					size_t tap = y * vertical.TapCount + k;
+					AccumulateRow(column.data(), rows.Get(vertical.Index[tap]), vertical.Weight[tap], column.size());
+				}
+
+				float* linearRow = destination.Pixels.data() + y * mip.Width * 4;
+				FilterRowHorizontal(column.data(), horizontal, linearRow, mip.Width);
+				EncodeRow(linearRow, mip.Pixels.data() + y * mip.Width * 4, mip.Width);
+			}
+		});
+
+		source.Width = destination.Width;
+		source.Height = destination.Height;
+		source.Pixels.swap(destination.Pixels);
+	}
+
+	return levels;
+}
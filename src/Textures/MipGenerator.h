@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../Jobs/JobSystem.h"
+
+#include <cstdint>
+#include <vector>
+
+/* CPU mip chain generation.
+
+   Colors are filtered in linear space and re-encoded as sRGB, alpha is
+   filtered as is. Levels above the first are kept in float while the chain is
+   built, so rounding doesn't accumulate. Rows of every level are filtered in
+   parallel with SSE, AVX2/FMA when the CPU reports it at run time, and
+   encoded to RGBA8 as they are produced (AVX2 gathers for the sRGB table).
+*/
+
+// RGBA8 image, color channels sRGB encoded.
+struct TextureImage
+{
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	std::vector<uint8_t> Pixels;
+};
+
+enum Mip_Filter
+{
+	// 2x2 average (clamped at odd edges).
+	MIP_FILTER_BOX,
+
+	// Kaiser-windowed sinc, sharper minification. Wraps like GL_REPEAT.
+	MIP_FILTER_KAISER
+};
+
+// Kaiser filter half width in destination texels, and window shape.
+#define KAISER_FILTER_WIDTH 3.0f
+#define KAISER_FILTER_ALPHA 4.0f
+
+// RGBA8 image from stb_image output with 1 to 4 channels.
+TextureImage MakeTextureImage(const uint8_t* pixels, uint32_t width, uint32_t height, int channels);
+
+// Full mip chain, level 0 is a copy of image.
+std::vector<TextureImage> GenerateMipChain(const TextureImage& image, JobSystem& jobs, Mip_Filter filter = MIP_FILTER_BOX);
@@ -0,0 +1,328 @@
+#include "TextureBaker.h"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+// Block rows per encode batch.
+#define ENCODE_ROW_BATCH_SIZE 4
+
+
+bool HasTranslucentPixels(const TextureImage& image)
+{
+	for (size_t i = 3; i < image.Pixels.size(); i += 4)
+	{
+		if (image.Pixels[i] != 255)
+			return true;
+	}
+
+	return false;
+}
+
+
+#pragma region BlockEncoding
+
+// A 4x4 block as structure of arrays, one byte per pixel and channel.
+struct PixelBlock
+{
+	alignas(16) uint8_t R[16];
+	alignas(16) uint8_t G[16];
+	alignas(16) uint8_t B[16];
+	alignas(16) uint8_t A[16];
+};
+
+// Gather a block, clamping at the image edges (levels smaller than 4x4).
+static void LoadBlock(const TextureImage& image, uint32_t blockX, uint32_t blockY, PixelBlock& block)
+{
+	for (uint32_t y = 0; y < 4; y++)
+	{
+		uint32_t row = std::min(blockY * 4 + y, image.Height - 1);
+
+		for (uint32_t x = 0; x < 4; x++)
+		{
+			uint32_t column = std::min(blockX * 4 + x, image.Width - 1);
+			const uint8_t* pixel = &image.Pixels[(static_cast<size_t>(row) * image.Width + column) * 4];
+
+			block.R[y * 4 + x] = pixel[0];
+			block.G[y * 4 + x] = pixel[1];
+			block.B[y * 4 + x] = pixel[2];
+			block.A[y * 4 + x] = pixel[3];
+		}
+	}
+}
+
+
+static uint8_t HorizontalMin(__m128i values)
+{
+	values = _mm_min_epu8(values, _mm_srli_si128(values, 8));
+	values = _mm_min_epu8(values, _mm_srli_si128(values, 4));
+	values = _mm_min_epu8(values, _mm_srli_si128(values, 2));
+	values = _mm_min_epu8(values, _mm_srli_si128(values, 1));
+	return static_cast<uint8_t>(_mm_cvtsi128_si32(values));
+}
+
+
+static uint8_t HorizontalMax(__m128i values)
+{
+	values = _mm_max_epu8(values, _mm_srli_si128(values, 8));
+	values = _mm_max_epu8(values, _mm_srli_si128(values, 4));
+	values = _mm_max_epu8(values, _mm_srli_si128(values, 2));
+	values = _mm_max_epu8(values, _mm_srli_si128(values, 1));
+	return static_cast<uint8_t>(_mm_cvtsi128_si32(values));
+}
+
+
+static uint16_t PackRGB565(int r, int g, int b)
+{
+	return static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+
+static void UnpackRGB565(uint16_t color, int& r, int& g, int& b)
+{
+	r = (color >> 11) & 31;
+	g = (color >> 5) & 63;
+	b = color & 31;
+
+	r = (r << 3) | (r >> 2);
+	g = (g << 2) | (g >> 4);
+	b = (b << 3) | (b >> 2);
+}
+
+
+// |a - b| of unsigned 16-bit lanes.
+static __m128i AbsDiff16(__m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+}
+
+
+// Color part of BC1 / BC3: bounding box endpoints inset by 1/16 of the range,
+// nearest of the four palette colors (sum of absolute differences) per pixel.
+static void EncodeColorBlock(const PixelBlock& block, uint8_t* out)
+{
+	__m128i r = _mm_load_si128(reinterpret_cast<const __m128i*>(block.R));
+	__m128i g = _mm_load_si128(reinterpret_cast<const __m128i*>(block.G));
+	__m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(block.B));
+
+	int minColor[3] = { HorizontalMin(r), HorizontalMin(g), HorizontalMin(b) };
+	int maxColor[3] = { HorizontalMax(r), HorizontalMax(g), HorizontalMax(b) };
+
+	for (int c = 0; c < 3; c++)
+	{
+		int inset = (maxColor[c] - minColor[c]) >> 4;
+		minColor[c] += inset;
+		maxColor[c] -= inset;
+	}
+
+	uint16_t color0 = PackRGB565(maxColor[0], maxColor[1], maxColor[2]);
+	uint16_t color1 = PackRGB565(minColor[0], minColor[1], minColor[2]);
+
+	// color0 > color1 selects the four color mode.
+	if (color0 < color1)
+		std::swap(color0, color1);
+
+	uint32_t indices = 0;
+
+	if (color0 != color1)
+	{
+		int palette[4][3];
+		UnpackRGB565(color0, palette[0][0], palette[0][1], palette[0][2]);
+		UnpackRGB565(color1, palette[1][0], palette[1][1], palette[1][2]);
+
+		for (int c = 0; c < 3; c++)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		// Distances of all 16 pixels to each palette color, 8 pixels per register.
+		__m128i zero = _mm_setzero_si128();
+		__m128i channels[2][3] = {
+			{ _mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(g, zero), _mm_unpacklo_epi8(b, zero) },
+			{ _mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero), _mm_unpackhi_epi8(b, zero) }
+		};
+
+		alignas(16) uint8_t selected[16];
+
+		for (int half = 0; half < 2; half++)
+		{
+			__m128i distance[4];
+			for (int p = 0; p < 4; p++)
+			{
+				distance[p] = _mm_add_epi16(_mm_add_epi16(
+					AbsDiff16(channels[half][0], _mm_set1_epi16(static_cast<short>(palette[p][0]))),
+					AbsDiff16(channels[half][1], _mm_set1_epi16(static_cast<short>(palette[p][1])))),
+					AbsDiff16(channels[half][2], _mm_set1_epi16(static_cast<short>(palette[p][2]))));
+			}
+
+			// Running minimum; lanes take the later index where it is strictly closer.
+			__m128i best = distance[0];
+			__m128i index = zero;
+			for (int p = 1; p < 4; p++)
+			{
+				__m128i closer = _mm_cmplt_epi16(distance[p], best);
+				best = _mm_min_epi16(best, distance[p]);
+				index = _mm_or_si128(_mm_andnot_si128(closer, index), _mm_and_si128(closer, _mm_set1_epi16(static_cast<short>(p))));
+			}
+
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(selected + half * 8), _mm_packus_epi16(index, zero));
+		}
+
+		for (int i = 0; i < 16; i++)
+			indices |= static_cast<uint32_t>(selected[i]) << (i * 2);
+	}
+
+	out[0] = static_cast<uint8_t>(color0 & 0xFF);
+	out[1] = static_cast<uint8_t>(color0 >> 8);
+	out[2] = static_cast<uint8_t>(color1 & 0xFF);
+	out[3] = static_cast<uint8_t>(color1 >> 8);
+	out[4] = static_cast<uint8_t>(indices & 0xFF);
+	out[5] = static_cast<uint8_t>((indices >> 8) & 0xFF);
+	out[6] = static_cast<uint8_t>((indices >> 16) & 0xFF);
+	out[7] = static_cast<uint8_t>(indices >> 24);
+}
+
+
+// Alpha part of BC3: min / max endpoints, eight interpolated levels.
+static void EncodeAlphaBlock(const PixelBlock& block, uint8_t* out)
+{
+	__m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(block.A));
+	int alpha0 = HorizontalMax(a);
+	int alpha1 = HorizontalMin(a);
+
+	uint64_t indices = 0;
+
+	if (alpha0 != alpha1)
+	{
+		// alpha0 > alpha1: index 0 = alpha0, 1 = alpha1, 2..7 interpolate from alpha0 to alpha1.
+		int palette[8] = { alpha0, alpha1 };
+		for (int i = 1; i < 7; i++)
+			palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+
+		for (int i = 0; i < 16; i++)
+		{
+			int best = 0;
+			int bestDistance = 256;
+			for (int p = 0; p < 8; p++)
+			{
+				int distance = std::abs(block.A[i] - palette[p]);
+				if (distance < bestDistance)
+				{
+					best = p;
+					bestDistance = distance;
+				}
+			}
+
+			indices |= static_cast<uint64_t>(best) << (i * 3);
+		}
+	}
+
+	out[0] = static_cast<uint8_t>(alpha0);
+	out[1] = static_cast<uint8_t>(alpha1);
+	for (int i = 0; i < 6; i++)
+		out[2 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xFF);
+}
+
+
+static void EncodeBlocks(const TextureImage& image, uint8_t* out, size_t blockSize, JobSystem& jobs)
+{
+	uint32_t blocksX = (image.Width + 3) / 4;
+	uint32_t blocksY = (image.Height + 3) / 4;
+
+	jobs.ParallelFor(blocksY, ENCODE_ROW_BATCH_SIZE, [&](size_t begin, size_t end)
+	{
+		PixelBlock block;
+
+		for (size_t y = begin; y < end; y++)
+		{
+			for (uint32_t x = 0; x < blocksX; x++)
+			{
+				uint8_t* blockOut = out + (y * blocksX + x) * blockSize;
+				LoadBlock(image, x, static_cast<uint32_t>(y), block);
+
+				if (blockSize == 16)
+				{
+					EncodeAlphaBlock(block, blockOut);
+					EncodeColorBlock(block, blockOut + 8);
+				}
+				else
+				{
+					EncodeColorBlock(block, blockOut);
+				}
+			}
+		}
+	});
+}
+
+#pragma endregion
+
+
+void EncodeBC1(const TextureImage& image, uint8_t* out, JobSystem& jobs)
+{
+	EncodeBlocks(image, out, 8, jobs);
+}
+
+
+void EncodeBC3(const TextureImage& image, uint8_t* out, JobSystem& jobs)
+{
+	EncodeBlocks(image, out, 16, jobs);
+}
+
+
+bool WriteTextureFile(const std::string& path, Texture_Format format, const std::vector<TextureImage>& levels, JobSystem& jobs)
+{
+	if (levels.empty() || levels.size() > TEXTURE_MAX_LEVELS)
+		return false;
+
+	TextureFileHeader header = {};
+	header.Magic = TEXTURE_FILE_MAGIC;
+	header.Version = TEXTURE_FILE_VERSION;
+	header.Format = format;
+	header.Flags = TEXTURE_FLAG_SRGB;
+	header.Width = levels[0].Width;
+	header.Height = levels[0].Height;
+	header.LevelCount = static_cast<uint32_t>(levels.size());
+
+	// Encode every level into one buffer at its final offset.
+	uint64_t offset = sizeof(TextureFileHeader);
+	for (uint32_t level = 0; level < header.LevelCount; level++)
+	{
+		TextureLevel& entry = header.Levels[level];
+		entry.Width = levels[level].Width;
+		entry.Height = levels[level].Height;
+		entry.Size = GetTextureLevelSize(format, entry.Width, entry.Height);
+		entry.Offset = (offset + TEXTURE_LEVEL_ALIGNMENT - 1) / TEXTURE_LEVEL_ALIGNMENT * TEXTURE_LEVEL_ALIGNMENT;
+
+		offset = entry.Offset + entry.Size;
+	}
+
+	std::vector<uint8_t> contents(static_cast<size_t>(offset), 0);
+	std::copy(reinterpret_cast<const uint8_t*>(&header), reinterpret_cast<const uint8_t*>(&header + 1), contents.begin());
+
+	for (uint32_t level = 0; level < header.LevelCount; level++)
+	{
+		uint8_t* levelOut = contents.data() + header.Levels[level].Offset;
+
+		if (format == TEXTURE_FORMAT_BC1)
+			EncodeBC1(levels[level], levelOut, jobs);
+		else if (format == TEXTURE_FORMAT_BC3)
+			EncodeBC3(levels[level], levelOut, jobs);
+		else
+			std::copy(levels[level].Pixels.begin(), levels[level].Pixels.end(), levelOut);
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+
+	if (!file)
+	{
+		std::cout << "ERROR::TEXTURE_BAKER::WRITE_FAILED: " << path << std::endl;
+		return false;
+	}
+
+	return true;
+}
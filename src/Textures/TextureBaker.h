@@ -0,0 +1,23 @@
+#pragma once
+
+#include "MipGenerator.h"
+#include "TextureFormat.h"
+#include "../Jobs/JobSystem.h"
+
+#include <string>
+#include <vector>
+
+/* Offline texture baking: BC1/BC3 block compression of mip chains
+   (MipGenerator.h), written as a baked texture file (TextureFormat.h).
+*/
+
+// True if any pixel is not fully opaque (needs BC3 instead of BC1).
+bool HasTranslucentPixels(const TextureImage& image);
+
+// Encode an image in BC1 / BC3. out holds GetTextureLevelSize() bytes.
+// Blocks are encoded with SSE2, block rows in parallel.
+void EncodeBC1(const TextureImage& image, uint8_t* out, JobSystem& jobs);
+void EncodeBC3(const TextureImage& image, uint8_t* out, JobSystem& jobs);
+
+// Encode every level in format and write the file.
+bool WriteTextureFile(const std::string& path, Texture_Format format, const std::vector<TextureImage>& levels, JobSystem& jobs);
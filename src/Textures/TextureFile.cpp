@@ -0,0 +1,65 @@
+#include "TextureFile.h"
+
+#include <iostream>
+
+TextureFile::TextureFile()
+{
+	Header = nullptr;
+}
+
+
+bool TextureFile::Open(const std::string& path)
+{
+	Close();
+
+	if (!File.Open(path))
+		return false;
+
+	Header = reinterpret_cast<const TextureFileHeader*>(File.GetData());
+
+	bool valid = File.GetSize() >= sizeof(TextureFileHeader)
+		&& Header->Magic == TEXTURE_FILE_MAGIC
+		&& Header->Version == TEXTURE_FILE_VERSION
+		&& Header->Format <= TEXTURE_FORMAT_BC3
+		&& Header->LevelCount > 0 && Header->LevelCount <= TEXTURE_MAX_LEVELS;
+
+	// Every level has the size its format implies and lies inside the file.
+	for (uint32_t level = 0; valid && level < Header->LevelCount; level++)
+	{
+		const TextureLevel& entry = Header->Levels[level];
+
+		valid = entry.Width > 0 && entry.Height > 0
+			&& entry.Size == GetTextureLevelSize(GetFormat(), entry.Width, entry.Height)
+			&& entry.Offset % TEXTURE_LEVEL_ALIGNMENT == 0
+			&& entry.Offset <= File.GetSize()
+			&& entry.Size <= File.GetSize() - entry.Offset;
+	}
+
+	if (!valid)
+	{
+		std::cout << "ERROR::TEXTURE_FILE::INVALID_FILE: " << path << std::endl;
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+void TextureFile::Close()
+{
+	File.Close();
+	Header = nullptr;
+}
+
+
+std::string GetBakedTexturePath(const std::string& imagePath)
+{
+	size_t extension = imagePath.find_last_of('.');
+	size_t directory = imagePath.find_last_of("/\\");
+
+	if (extension == std::string::npos || (directory != std::string::npos && extension < directory))
+		return imagePath + ".ctex";
+
+	return imagePath.substr(0, extension) + ".ctex";
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "TextureFormat.h"
+#include "../IO/MappedFile.h"
+
+#include <string>
+
+/* Memory-mapped baked texture. Level data points into the mapping and is
+   uploaded as is.
+*/
+class TextureFile
+{
+private:
+
+	MappedFile File;
+	const TextureFileHeader* Header;
+
+public:
+
+	TextureFile();
+
+	// Map and validate the file. Returns false on failure.
+	bool Open(const std::string& path);
+
+	void Close();
+
+	bool IsOpen() const { return Header != nullptr; }
+
+	const TextureFileHeader& GetHeader() const { return *Header; }
+
+	Texture_Format GetFormat() const { return static_cast<Texture_Format>(Header->Format); }
+
+	uint32_t GetLevelCount() const { return Header->LevelCount; }
+
+	const TextureLevel& GetLevel(uint32_t level) const { return Header->Levels[level]; }
+
+	// Level contents in the upload format. Valid until Close().
+	const uint8_t* GetLevelData(uint32_t level) const { return File.GetData() + Header->Levels[level].Offset; }
+};
+
+// Path of the baked texture belonging to an image (extension replaced by .ctex).
+std::string GetBakedTexturePath(const std::string& imagePath);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* Baked texture file layout (version 1, little endian), a KTX-like container.
+
+   TextureFileHeader at offset 0, followed by the mip levels, largest first.
+   Every level is stored in its GPU upload format and starts on a
+   TEXTURE_LEVEL_ALIGNMENT boundary, so a mapped file is uploaded level by level
+   without decoding.
+*/
+
+#define TEXTURE_FILE_MAGIC 0x58544343u	// "CCTX"
+#define TEXTURE_FILE_VERSION 1u
+
+#define TEXTURE_LEVEL_ALIGNMENT 16u
+#define TEXTURE_MAX_LEVELS 16
+
+enum Texture_Format : uint32_t
+{
+	// Uncompressed, 4 bytes per pixel.
+	TEXTURE_FORMAT_RGBA8,
+
+	// 4x4 blocks, 8 bytes (opaque color).
+	TEXTURE_FORMAT_BC1,
+
+	// 4x4 blocks, 16 bytes (color + interpolated alpha).
+	TEXTURE_FORMAT_BC3
+};
+
+// Color channels are sRGB encoded (mips were filtered in linear space).
+#define TEXTURE_FLAG_SRGB 0x1u
+
+struct TextureLevel
+{
+	uint64_t Offset;
+	uint64_t Size;
+	uint32_t Width;
+	uint32_t Height;
+};
+
+struct TextureFileHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t Format;
+	uint32_t Flags;
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t LevelCount;
+	uint32_t Padding;
+
+	TextureLevel Levels[TEXTURE_MAX_LEVELS];
+};
+
+static_assert(sizeof(TextureLevel) == 24, "TextureLevel layout changed");
+static_assert(sizeof(TextureFileHeader) == 416, "TextureFileHeader layout changed");
+
+
+// Bytes of one level in the given format.
+inline size_t GetTextureLevelSize(Texture_Format format, uint32_t width, uint32_t height)
+{
+	size_t blocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+
+	switch (format)
+	{
+	case TEXTURE_FORMAT_BC1:
+		return blocks * 8;
+	case TEXTURE_FORMAT_BC3:
+		return blocks * 16;
+	default:
+		return static_cast<size_t>(width) * height * 4;
+	}
+}
+
+// Levels of a full mip chain down to 1x1.
+inline uint32_t GetMipLevelCount(uint32_t width, uint32_t height)
+{
+	uint32_t levels = 1;
+	while ((width > 1 || height > 1) && levels < TEXTURE_MAX_LEVELS)
+	{
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		levels++;
+	}
+
+	return levels;
+}
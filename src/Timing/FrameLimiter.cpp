@@ -0,0 +1,45 @@
+#include "FrameLimiter.h"
+
+#include <algorithm>
+#include <thread>
+
+FrameLimiter::FrameLimiter(double framesPerSecond)
+{
+	Interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(framesPerSecond, 1.0)));
+	Started = false;
+	Oversleep = FRAME_LIMITER_MIN_SPIN;
+}
+
+
+double FrameLimiter::Wait()
+{
+	Clock::time_point start = Clock::now();
+
+	if (!Started || start - NextFrame > Interval)
+	{
+		// First frame, or too far behind: the schedule starts now.
+		NextFrame = start + Interval;
+		Started = true;
+		return 0.0;
+	}
+
+	// Sleep while far enough from the deadline.
+	double remaining = std::chrono::duration<double>(NextFrame - start).count();
+	double sleep = remaining - std::max(Oversleep, FRAME_LIMITER_MIN_SPIN);
+	if (sleep > 0.0)
+	{
+		Clock::time_point sleepStart = Clock::now();
+		std::this_thread::sleep_for(std::chrono::duration<double>(sleep));
+		double overshoot = std::chrono::duration<double>(Clock::now() - sleepStart).count() - sleep;
+
+		Oversleep = std::max(overshoot, Oversleep * FRAME_LIMITER_OVERSLEEP_DECAY);
+	}
+
+	// Spin the rest.
+	while (Clock::now() < NextFrame)
+		std::this_thread::yield();
+
+	NextFrame += Interval;
+
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+
+/* Frame rate limiter.
+
+   Frames are due at fixed intervals from a running deadline. Wait() sleeps
+   until shortly before the deadline and spins (yielding) for the rest, since
+   a sleep can overshoot by a scheduler tick. How early it wakes follows the
+   largest recent oversleep, so the spin stays short where sleeps are precise.
+   A frame that misses its deadline by more than an interval restarts the
+   schedule instead of rushing the next frames to catch up.
+*/
+
+// Starting (and minimum) spin time before the deadline, seconds.
+#define FRAME_LIMITER_MIN_SPIN 0.0005
+
+// Per-wait decay of the oversleep estimate.
+#define FRAME_LIMITER_OVERSLEEP_DECAY 0.99
+
+class FrameLimiter
+{
+private:
+
+	typedef std::chrono::steady_clock Clock;
+
+	Clock::duration Interval;
+	Clock::time_point NextFrame;
+	bool Started;
+
+	// Largest recent sleep overshoot, decaying, seconds.
+	double Oversleep;
+
+public:
+
+	explicit FrameLimiter(double framesPerSecond);
+
+	// Block until the next frame is due. Returns the seconds waited.
+	double Wait();
+
+	double GetOversleep() const { return Oversleep; }
+};
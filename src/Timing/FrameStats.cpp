@@ -0,0 +1,155 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Buckets up to FRAME_STATS_MAX_US: the first two ranges are linear, then one range per power of two.
+static const size_t BUCKET_COUNT = (26 - FRAME_STATS_SUB_BUCKET_BITS + 1) * FRAME_STATS_SUB_BUCKETS;
+
+FrameStats::FrameStats()
+{
+	Counts.resize(BUCKET_COUNT);
+	Reset();
+}
+
+
+void FrameStats::Reset()
+{
+	std::fill(Counts.begin(), Counts.end(), 0);
+	TotalCount = 0;
+	TotalMs = 0.0;
+	MaxUs = 0;
+
+	Hitches = 0;
+	SmoothedSeconds = 0.0;
+}
+
+
+size_t FrameStats::GetBucketIndex(uint64_t valueUs)
+{
+	// Values below 2 * SUB_BUCKETS map to themselves. Above, the range starting
+	// at 2^(k + SUB_BUCKET_BITS) is split into SUB_BUCKETS steps of 2^k.
+	int highestBit = 63;
+	while (highestBit > 0 && !(valueUs >> highestBit))
+		highestBit--;
+
+	int range = std::max(highestBit - FRAME_STATS_SUB_BUCKET_BITS, 0);
+	return static_cast<size_t>(range) * FRAME_STATS_SUB_BUCKETS + static_cast<size_t>(valueUs >> range);
+}
+
+
+double FrameStats::GetBucketValue(size_t index)
+{
+	if (index < 2 * FRAME_STATS_SUB_BUCKETS)
+		return static_cast<double>(index);
+
+	size_t range = index / FRAME_STATS_SUB_BUCKETS - 1;
+	uint64_t subBucket = index - range * FRAME_STATS_SUB_BUCKETS;
+	uint64_t width = uint64_t(1) << range;
+
+	return static_cast<double>(subBucket * width) + 0.5 * static_cast<double>(width - 1);
+}
+
+
+double FrameStats::AddFrame(double frameSeconds)
+{
+	double frameMs = std::max(frameSeconds, 0.0) * 1000.0;
+	uint64_t frameUs = std::min(static_cast<uint64_t>(frameMs * 1000.0 + 0.5), FRAME_STATS_MAX_US - 1);
+
+	Counts[GetBucketIndex(frameUs)]++;
+	TotalCount++;
+	TotalMs += frameMs;
+	MaxUs = std::max(MaxUs, frameUs);
+
+	if (TotalCount == 1)
+	{
+		SmoothedSeconds = frameSeconds;
+	}
+	else
+	{
+		if (frameSeconds > FRAME_STATS_HITCH_FACTOR * SmoothedSeconds)
+			Hitches++;
+
+		SmoothedSeconds += (frameSeconds - SmoothedSeconds) * FRAME_STATS_SMOOTHING;
+	}
+
+	return SmoothedSeconds;
+}
+
+
+double FrameStats::GetPercentileMs(double p) const
+{
+	if (TotalCount == 0)
+		return 0.0;
+
+	// Rank of the percentile, 1-based, like FrameTimingLog's nearest rank.
+	uint64_t rank = static_cast<uint64_t>(std::min(std::max(p, 0.0), 1.0) * static_cast<double>(TotalCount - 1) + 0.5) + 1;
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < Counts.size(); i++)
+	{
+		seen += Counts[i];
+		if (seen >= rank)
+			return std::min(GetBucketValue(i), static_cast<double>(MaxUs)) / 1000.0;
+	}
+
+	return static_cast<double>(MaxUs) / 1000.0;
+}
+
+
+FrameStatsSummary FrameStats::GetSummary() const
+{
+	FrameStatsSummary summary;
+	summary.Frames = TotalCount;
+	summary.MeanMs = TotalCount > 0 ? TotalMs / static_cast<double>(TotalCount) : 0.0;
+	summary.P50Ms = GetPercentileMs(0.50);
+	summary.P95Ms = GetPercentileMs(0.95);
+	summary.P99Ms = GetPercentileMs(0.99);
+	summary.MaxMs = static_cast<double>(MaxUs) / 1000.0;
+	summary.Hitches = Hitches;
+	summary.SmoothedMs = SmoothedSeconds * 1000.0;
+
+	return summary;
+}
+
+
+void FrameStats::PrintSummary() const
+{
+	FrameStatsSummary summary = GetSummary();
+
+	std::ostringstream line;
+	line << std::fixed << std::setprecision(2) << "Frame times over " << summary.Frames << " frames: mean " << summary.MeanMs
+		<< " ms, p50 " << summary.P50Ms << ", p95 " << summary.P95Ms << ", p99 " << summary.P99Ms << ", max " << summary.MaxMs
+		<< " ms, " << summary.Hitches << " hitches (> " << FRAME_STATS_HITCH_FACTOR << "x the smoothed frame time).\n";
+
+	std::cout << line.str();
+}
+
+
+bool FrameStats::WriteCSV(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::FRAME_STATS::FILE_NOT_CREATED: " << path << std::endl;
+		return false;
+	}
+
+	file << "frame_ms,count,percentile\n";
+	file << std::fixed << std::setprecision(4);
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < Counts.size(); i++)
+	{
+		if (Counts[i] == 0)
+			continue;
+
+		seen += Counts[i];
+		file << GetBucketValue(i) / 1000.0 << "," << Counts[i] << "," << 100.0 * static_cast<double>(seen) / static_cast<double>(TotalCount) << "\n";
+	}
+
+	return true;
+}
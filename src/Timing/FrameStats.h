@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Frame time statistics.
+
+   Frame times go into a log-linear histogram (HdrHistogram layout): values in
+   microseconds, every power-of-two range split into FRAME_STATS_SUB_BUCKETS
+   linear buckets, so any percentile is within 1 / FRAME_STATS_SUB_BUCKETS
+   of the recorded value at a fixed memory cost, however long the run.
+
+   Also counts hitches (frames much slower than the recent average) and keeps
+   an exponentially smoothed frame time, which can stand in for the raw
+   deltaTime. Its sum tracks the raw sum, so time doesn't drift.
+*/
+
+// Linear buckets per power of two (2^FRAME_STATS_SUB_BUCKET_BITS).
+#define FRAME_STATS_SUB_BUCKET_BITS 7
+#define FRAME_STATS_SUB_BUCKETS (1 << FRAME_STATS_SUB_BUCKET_BITS)
+
+// Longer frames are clamped (microseconds, about a minute).
+#define FRAME_STATS_MAX_US (uint64_t(1) << 26)
+
+// A frame slower than this multiple of the smoothed frame time is a hitch.
+#define FRAME_STATS_HITCH_FACTOR 2.0
+
+// Weight of the newest frame in the smoothed frame time.
+#define FRAME_STATS_SMOOTHING 0.1
+
+struct FrameStatsSummary
+{
+	uint64_t Frames = 0;
+
+	// Milliseconds.
+	double MeanMs = 0.0;
+	double P50Ms = 0.0;
+	double P95Ms = 0.0;
+	double P99Ms = 0.0;
+	double MaxMs = 0.0;
+
+	uint64_t Hitches = 0;
+	double SmoothedMs = 0.0;
+};
+
+class FrameStats
+{
+private:
+
+	std::vector<uint64_t> Counts;
+	uint64_t TotalCount;
+	double TotalMs;
+	uint64_t MaxUs;
+
+	uint64_t Hitches;
+	double SmoothedSeconds;
+
+	static size_t GetBucketIndex(uint64_t valueUs);
+
+	// Representative value (middle) of a bucket, microseconds.
+	static double GetBucketValue(size_t index);
+
+public:
+
+	FrameStats();
+
+	// Record the time since the previous frame. Returns the smoothed frame time (seconds).
+	double AddFrame(double frameSeconds);
+
+	// p-th percentile (0..1) in milliseconds, 0 without frames.
+	double GetPercentileMs(double p) const;
+
+	FrameStatsSummary GetSummary() const;
+
+	// One line: frames, mean, p50 / p95 / p99 / max and hitches.
+	void PrintSummary() const;
+
+	// Write "frame_ms,count,percentile" for every non-empty bucket. Returns false on failure.
+	bool WriteCSV(const std::string& path) const;
+
+	void Reset();
+};
@@ -7,11 +7,51 @@
 
 #include "Shader/Shader.h"
 #include "Camera/Camera.h"
+#include "Camera/CameraController.h"
+#include "Camera/CameraPath.h"
+#include "Camera/OrbitCamera.h"
+#include "Camera/Projection.h"
+#include "Culling/Frustum.h"
+#include "Culling/MultiViewCulling.h"
+#include "Input/InputCoalescer.h"
+#include "Input/InputEventQueue.h"
+#include "Jobs/JobSystem.h"
+#include "Memory/FrameArena.h"
+#include "Memory/MemoryTracker.h"
+#include "Renderer/CameraUniforms.h"
+#include "Renderer/CameraView.h"
+#include "Renderer/DepthPrepass.h"
+#include "Renderer/DepthState.h"
+#include "Renderer/DynamicResolution.h"
+#include "Renderer/FrameCapture.h"
+#include "Renderer/GpuTimer.h"
+#include "Renderer/InstanceBuffer.h"
+#include "Renderer/LatencyTracker.h"
+#include "Renderer/OverdrawCounter.h"
+#include "Renderer/RedrawScheduler.h"
+#include "Renderer/RenderTarget.h"
+#include "Renderer/TextureArrays.h"
+#include "Renderer/TextureStreamer.h"
+#include "Replay/CameraRecording.h"
+#include "Replay/FrameTimings.h"
+#include "Scene/DefaultScene.h"
+#include "Scene/SceneFile.h"
+#include "Scene/TransformHierarchy.h"
+#include "Scene/WorldPositions.h"
+#include "Timing/FrameLimiter.h"
+#include "Timing/FrameStats.h"
+#include "LaunchOptions.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>	
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
 
 
 #pragma region CallbackFunctions
@@ -26,25 +66,93 @@ void scroll_callback(GLFWwindow* window, double xOffset, double yOffset);
 
 #pragma endregion
 
+// Secondary cameras follow the main camera.
+void updateViewCameras(std::vector<CameraView>& views);
+
+// Apply (and record) the mouse input of one tick to the main camera.
+void applyMouseInput(const CoalescedInput& input);
+
+// Move / turn a camera with the selected controller, or the camera's own input handling.
+void moveCamera(Camera& target, unsigned int directionMask, float deltaTime);
+void turnCamera(Camera& target, float xOffset, float yOffset);
+
+// Orbit mode: drag, zoom and advance the orbit camera by one tick.
+void applyOrbitInput(GLFWwindow* window, const CoalescedInput& input);
+
+// Cursor position in NDC of the window (y up).
+void getCursorNdc(GLFWwindow* window, float& x, float& y);
+
+// Nearest instance whose bounding sphere the ray hits, or -1.
+long long pickInstance(const WorldPositions& positions, float boundingRadius, const glm::dvec3& origin, const glm::vec3& direction);
+
 
 // Window Context Settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
-float textureInterpVal = 0.2f;
+// Added to the overlay blend of every material (UP / DOWN keys).
+float textureInterpVal = 0.0f;
+
+// Current framebuffer size (updated by framebuffer_size_callback).
+int framebufferWidth = SCR_WIDTH;
+int framebufferHeight = SCR_HEIGHT;
 
 // Projection Matrix Settings.
-float aspect = (float)SCR_WIDTH / (float)SCR_HEIGHT;
-float zNear = 0.1f;
-float zFar = 100.0f;
+float zNear = DEFAULT_Z_NEAR;
+float zFar = DEFAULT_Z_FAR;
+
+// Reverse-Z with an infinite far plane. zFar is only used by STANDARD_DEPTH.
+Projection_Mode projectionMode = REVERSE_Z_INFINITE;
+
+// Render with the camera at the origin. World positions are kept in double and
+// the camera position is subtracted on the CPU before converting to float.
+bool cameraRelativeRendering = true;
+
+// Views: main camera, minimap following it from above, fixed top-down debug view.
+enum View_Index
+{
+	MAIN_VIEW,
+	MINIMAP_VIEW,
+	DEBUG_TOP_DOWN_VIEW
+};
+
+// Vertex attribute carrying the per-view instance index.
+const unsigned int INSTANCE_INDEX_ATTRIB = 3;
+
+// Texture units of the base and overlay texture arrays and the shared instance data.
+const int MATERIAL_TEXTURE_UNIT = 0;
+const int OVERLAY_TEXTURE_UNIT = 1;
+const int INSTANCE_TRANSFORM_UNIT = 2;
+const int INSTANCE_MATERIAL_UNIT = 3;
 
 // Delta Time.
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
-// Initial mouse position.
-float lastX = SCR_WIDTH / 2.0f;
-float lastY = SCR_HEIGHT / 2.0f;
-bool firstMouse = true;
+// Camera movement is integrated at a fixed rate so recordings replay exactly.
+const float FIXED_TIMESTEP = 1.0f / 120.0f;
+const int MAX_TICKS_PER_FRAME = 8;
+float tickAccumulator = 0.0f;
+
+// Pressed movement keys (MOVEMENT_BIT mask), sampled by processInput.
+unsigned int movementMask = 0;
+
+// Mouse events from the callbacks, summed every frame and applied once per tick.
+InputEventQueue inputQueue;
+InputCoalescer inputCoalescer;
+
+// Late latching: mouse input that arrives during the frame turns the main view
+// right before the draws are submitted. The main view is culled with a wider
+// field of view, so the late rotation doesn't reveal culled instances.
+bool lateLatch = false;
+const float LATE_LATCH_CULL_FOV_MARGIN = 10.0f;
+
+// On-demand rendering (--on-demand): frames are drawn only when something
+// changed, otherwise the loop sleeps. Disabled, every frame draws.
+RedrawScheduler redrawScheduler(false, 0.0);
+
+// Depth pre-pass before shading (--depth-prepass, toggled with P).
+bool depthPrepassEnabled = false;
+bool prepassKeyDown = false;
 
 
 // --------- CAMERA ---------- //
@@ -53,11 +161,48 @@ bool firstMouse = true;
 // Create Camera Object.
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
+// Camera path recording / replay.
+CameraRecorder cameraRecorder;
+CameraReplay cameraReplay;
+bool replayMode = false;
+
+// Scripted spline flythrough.
+CameraPath flythroughPath;
+bool flythroughMode = false;
+
+// Camera is driven by a recording or a flythrough instead of live input,
+// one fixed tick per frame, and frame timings are collected.
+bool benchmarkRun = false;
+
+// Live input controller (--controller). Recordings still replay through Camera,
+// which snaps to the recorded states.
+enum Camera_Controller
+{
+	CONTROLLER_NONE,
+	CONTROLLER_FLY,
+	CONTROLLER_FPS,
+	CONTROLLER_SIX_DOF
+};
+
+Camera_Controller cameraController = CONTROLLER_NONE;
+FlyController flyController;
+FpsController fpsController;
+SixDofController sixDofController;
+
+// Orbit mode (--orbit): the live camera orbits a target instead of flying.
+bool orbitMode = false;
+OrbitCamera orbitCamera;
+
+// Left mouse button held / F pressed, sampled by processInput.
+bool orbitDragging = false;
+bool orbitFocusRequested = false;
+
 #pragma endregion
 
 
-int main()
+int main(int argc, char** argv)
 {
+	LaunchOptions options = ParseLaunchOptions(argc, argv);
 
 #pragma region InitWindow
 	
@@ -67,6 +212,9 @@ int main()
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+	if (options.Hidden)
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
 	// Create window context
 	GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGL Camera System", nullptr, nullptr);
 	if (!window)
@@ -84,7 +232,8 @@ int main()
 	glfwSetScrollCallback(window, scroll_callback);
 
 	// Set Mouse Capture.
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	// Orbit mode drags with a visible cursor.
+	glfwSetInputMode(window, GLFW_CURSOR, options.Orbit ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
 
 	// Load all OpenGL function pointers.
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -96,6 +245,118 @@ int main()
 #pragma endregion
 
 
+#pragma region Replay
+
+	if (!options.ReplayPath.empty())
+	{
+		if (!cameraReplay.Open(options.ReplayPath))
+		{
+			glfwTerminate();
+			return -1;
+		}
+
+		replayMode = true;
+
+		// Frame timings should measure rendering, not vsync.
+		glfwSwapInterval(0);
+	}
+	else if (!options.FlythroughPath.empty())
+	{
+		if (!flythroughPath.LoadFromFile(options.FlythroughPath))
+		{
+			glfwTerminate();
+			return -1;
+		}
+
+		flythroughMode = true;
+		glfwSwapInterval(0);
+	}
+	else if (!options.RecordPath.empty())
+	{
+		cameraRecorder.Open(options.RecordPath, FIXED_TIMESTEP, glfwGetTime());
+	}
+
+	benchmarkRun = replayMode || flythroughMode;
+
+	CameraFlythrough flythrough(flythroughPath, options.FlythroughSpeed);
+
+	// Per-frame timings of a benchmark run.
+	FrameTimingLog frameTimings;
+	GpuTimer gpuTimer;
+
+	// Input event to GPU completion of the frame showing it.
+	LatencyTracker latencyTracker;
+	lateLatch = options.LateLatch;
+
+	// Fragments per pixel of the main view's depth pre-pass and shading pass.
+	OverdrawCounter prepassOverdraw;
+	OverdrawCounter shadingOverdraw;
+
+	Prepass_Depth_Test prepassDepthTest = PREPASS_DEPTH_EQUAL;
+	if (!DepthPrepass::ParseDepthTest(options.PrepassDepthTest, prepassDepthTest))
+		std::cout << "ERROR::DEPTH_PREPASS: unknown depth test " << options.PrepassDepthTest << std::endl;
+	depthPrepassEnabled = options.DepthPrepass;
+
+	if (options.Controller == "fly")
+		cameraController = CONTROLLER_FLY;
+	else if (options.Controller == "fps")
+		cameraController = CONTROLLER_FPS;
+	else if (options.Controller == "sixdof")
+		cameraController = CONTROLLER_SIX_DOF;
+	else if (!options.Controller.empty())
+		std::cout << "ERROR::CAMERA_CONTROLLER: unknown controller " << options.Controller << std::endl;
+
+	orbitMode = options.Orbit;
+	if (orbitMode)
+	{
+		// Start around the scene origin from the initial view.
+		orbitCamera.LookFrom(camera, glm::dvec3(0.0));
+
+		// Late latching turns the camera in place, which an orbit doesn't.
+		if (lateLatch)
+			std::cout << "WARNING::ORBIT: late latch is not supported in orbit mode" << std::endl;
+		lateLatch = false;
+	}
+
+	// Render scale driven by frame times. The view targets shrink and the
+	// composite blit upscales them to the window.
+	bool dynamicResolutionEnabled = options.DynamicResolutionTargetMs > 0.0f;
+	DynamicResolution dynamicResolution(dynamicResolutionEnabled ? options.DynamicResolutionTargetMs : 1.0f);
+	if (options.HasResolutionGains)
+		dynamicResolution.SetGains(options.ResolutionGains[0], options.ResolutionGains[1], options.ResolutionGains[2]);
+	if (dynamicResolutionEnabled && !options.ResolutionLogPath.empty())
+		dynamicResolution.OpenLog(options.ResolutionLogPath);
+
+	// GPU time of the newest finished frame, fed to the resolution controller.
+	bool timeGpu = benchmarkRun || dynamicResolutionEnabled;
+	double lastGpuMs = 0.0;
+
+	// Frames read back asynchronously and encoded on worker threads.
+	std::unique_ptr<FrameCapture> frameCapture;
+	if (!options.CapturePath.empty())
+	{
+		// Benchmark runs advance one fixed tick per frame. Interactive frames come
+		// at the frame limit, or at the display's refresh rate with vsync.
+		int captureRate = static_cast<int>(1.0f / FIXED_TIMESTEP + 0.5f);
+		if (!benchmarkRun)
+		{
+			const GLFWvidmode* videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+			if (options.FrameLimit > 0.0f)
+				captureRate = static_cast<int>(options.FrameLimit + 0.5f);
+			else if (videoMode && videoMode->refreshRate > 0)
+				captureRate = videoMode->refreshRate;
+		}
+
+		Capture_Format captureFormat;
+		if (FrameCapture::ParseFormat(options.CaptureFormat, captureFormat))
+			frameCapture.reset(new FrameCapture(options.CapturePath, captureFormat, captureRate));
+		else
+			std::cout << "ERROR::CAPTURE: unknown format " << options.CaptureFormat << std::endl;
+	}
+
+#pragma endregion
+
+
 #pragma region Build_and_Compile_Shaders
 
 	// Build and compile our shader programs.
@@ -107,71 +368,178 @@ int main()
 
 #pragma region VertexData
 
-	// Configure global OpenGL state. Enable Depth Testing.
-	glEnable(GL_DEPTH_TEST);
-
-	// set up vertex data (and buffer(s)) and configure vertex attributes
-	// ------------------------------------------------------------------
-	float vertices[] = {
-
-		-0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f,
-		 0.5f, -0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 0.0f,
-		 0.5f,  0.5f, -0.5f,  0.0f, 0.0f, 1.0f,  1.0f, 1.0f,
-		 0.5f,  0.5f, -0.5f,  1.0f, 1.0f, 0.0f,  1.0f, 1.0f,
-		-0.5f,  0.5f, -0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 1.0f,
-		-0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f,
-
-		-0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f,
-		 0.5f, -0.5f,  0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 0.0f,
-		 0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  1.0f, 1.0f,
-		 0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  1.0f, 1.0f,
-		-0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 1.0f,
-		-0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f,
-
-		-0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,
-		-0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,
-		-0.5f, -0.5f, -0.5f,  0.0f, 0.0f, 1.0f,  0.0f, 1.0f,
-		-0.5f, -0.5f, -0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 1.0f,
-		-0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 0.0f,
-		-0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,
-
-		 0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,
-		 0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,
-		 0.5f, -0.5f, -0.5f,  0.0f, 0.0f, 1.0f,  0.0f, 1.0f,
-		 0.5f, -0.5f, -0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 1.0f,
-		 0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 0.0f,
-		 0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  1.0f, 0.0f,
-
-		-0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f,
-		 0.5f, -0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,
-		 0.5f, -0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  1.0f, 0.0f,
-		 0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  1.0f, 0.0f,
-		-0.5f, -0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 0.0f,
-		-0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f,
-
-		-0.5f,  0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f,
-		 0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  1.0f, 1.0f,
-		 0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  1.0f, 0.0f,
-		 0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  1.0f, 0.0f,
-		-0.5f,  0.5f,  0.5f,  1.0f, 1.0f, 0.0f,  0.0f, 0.0f,
-		-0.5f,  0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f
+	// Configure global OpenGL state. Depth testing, depth func and clip control
+	// have to match the projection matrix.
+	DepthState depthState(projectionMode, zNear, zFar);
+	depthState.apply();
+
+	// Every view renders offscreen into its own target with a float depth buffer.
+	std::vector<CameraView> views;
+	views.emplace_back(camera, 0.0f, 0.0f, 1.0f, 1.0f, SCR_WIDTH, SCR_HEIGHT);
+	views.emplace_back(camera, 0.72f, 0.68f, 0.26f, 0.3f, SCR_WIDTH, SCR_HEIGHT);
+	views.emplace_back(Camera(glm::vec3(0.0f, 40.0f, -6.0f), DEFAULT_WORLD_UP, YAW, -89.0f), 0.72f, 0.02f, 0.26f, 0.3f, SCR_WIDTH, SCR_HEIGHT);
+
+	const int viewCount = static_cast<int>(views.size());
+
+	// View frusta used to cull instances, one per view.
+	std::vector<Frustum> viewFrustums(viewCount);
+
+	// Visible sets of all views are computed together across the job system.
+	JobSystem jobSystem;
+	MultiViewCuller culler;
+
+	// Transforms and materials of instances visible in any view, uploaded once per frame.
+	InstanceBuffer instanceBuffer(viewCount);
+
+	// Projection and view matrices of every view, uploaded right before drawing.
+	CameraUniforms cameraUniforms(viewCount);
+
+	// Transient per-frame data, reset at the start of every frame.
+	FrameArena frameArena;
+
+	// Scene: a memory-mapped scene file, or the built-in cubes. Records are
+	// used in place, the mapping stays open until the end of main.
+	//-------------------------------------------------------------------------
+	SceneFile sceneFile;
+	SceneData defaultScene;
+	SceneView scene;
+
+	if (!options.ScenePath.empty())
+	{
+		if (!sceneFile.Open(options.ScenePath))
+		{
+			glfwTerminate();
+			return -1;
+		}
+
+		scene = sceneFile.GetView();
+	}
+	else
+	{
+		MemoryScope sceneMemory(MEMORY_CATEGORY_SCENE);
+		defaultScene = BuildDefaultScene();
+		scene = defaultScene.GetView();
+	}
+
+	// Materials: texture array layers and overlay blend. Textures of all
+	// materials are packed into arrays, so instances only differ by layer.
+	//----------------------------------------------------------------------
+
+	// flip the y-axis during image loading (baked textures are flipped by the baker).
+	stbi_set_flip_vertically_on_load(true);
+
+	TextureArrays textureArrays;
+	std::vector<glm::vec4> materialData;
+
+	// Base and overlay array of a material. Baked textures of one material can
+	// differ in size or format (BC1 / BC3), so the two are bound separately.
+	struct MaterialArrayPair
+	{
+		int Base;
+		int Overlay;
 	};
 
-	// world space coordinates for our cubes.
-	//---------------------------------------
-	glm::vec3 cubePositions[] = {
-		glm::vec3(0.0f,  0.0f,  0.0f),
-		glm::vec3(2.0f,  5.0f, -15.0f),
-		glm::vec3(-1.5f, -2.2f, -2.5f),
-		glm::vec3(-3.8f, -2.0f, -12.3f),
-		glm::vec3(2.4f, -0.4f, -3.5f),
-		glm::vec3(-1.7f,  3.0f, -7.5f),
-		glm::vec3(1.3f, -2.0f, -2.5f),
-		glm::vec3(1.5f,  2.0f, -2.5f),
-		glm::vec3(1.5f,  0.2f, -1.5f),
-		glm::vec3(-1.3f,  1.0f, -1.5f)
+	// Distinct array pairs, and the pair of every material.
+	std::vector<MaterialArrayPair> arrayPairs;
+	std::vector<uint32_t> materialArrayPairs;
+
+	auto addMaterial = [&](const std::string& basePath, const std::string& overlayPath, float textureInterp)
+	{
+		TextureSlot baseSlot = textureArrays.addTexture(basePath);
+		TextureSlot overlaySlot = textureArrays.addTexture(overlayPath);
+
+		if (overlaySlot.Array < 0)
+			overlaySlot = baseSlot;
+
+		MaterialArrayPair arrays = { std::max(baseSlot.Array, 0), std::max(overlaySlot.Array, 0) };
+
+		size_t pair = 0;
+		while (pair < arrayPairs.size() && (arrayPairs[pair].Base != arrays.Base || arrayPairs[pair].Overlay != arrays.Overlay))
+			pair++;
+
+		if (pair == arrayPairs.size())
+			arrayPairs.push_back(arrays);
+
+		materialArrayPairs.push_back(static_cast<uint32_t>(pair));
+		materialData.push_back(glm::vec4(std::max(baseSlot.Layer, 0), std::max(overlaySlot.Layer, 0), textureInterp, 0.0f));
 	};
 
+	if (scene.MaterialCount == 0)
+		addMaterial("texture_1.jpg", "texture_2.png", 0.2f);
+
+	for (size_t m = 0; m < scene.MaterialCount; m++)
+	{
+		const SceneMaterialRecord& material = scene.Materials[m];
+		addMaterial(scene.Textures[material.BaseTexture].Path, scene.Textures[material.OverlayTexture].Path, material.TextureInterp);
+	}
+
+	textureArrays.build(jobSystem);
+
+	// Mips above the tail stream in as instances need them, within the budget.
+	TextureStreamer textureStreamer(textureArrays, options.TextureBudgetMB * 1024 * 1024);
+	double lastTitleUpdate = 0.0;
+
+	// Instances: ordered by mesh, then texture array pair, so every draw call
+	// covers one contiguous range with a single pair of arrays bound.
+	//---------------------------------------------------------------------------
+	const int instanceCount = static_cast<int>(scene.InstanceCount);
+	const uint32_t arrayPairCount = static_cast<uint32_t>(arrayPairs.size());
+
+	auto getMaterial = [&](const SceneInstanceRecord& instance) { return scene.MaterialCount > 0 ? instance.Material : 0u; };
+	auto getDrawGroup = [&](const SceneInstanceRecord& instance) { return instance.Mesh * arrayPairCount + materialArrayPairs[getMaterial(instance)]; };
+
+	std::vector<uint32_t> instanceOrder(instanceCount);
+	std::iota(instanceOrder.begin(), instanceOrder.end(), 0u);
+	std::stable_sort(instanceOrder.begin(), instanceOrder.end(), [&](uint32_t a, uint32_t b)
+	{
+		return getDrawGroup(scene.Instances[a]) < getDrawGroup(scene.Instances[b]);
+	});
+
+	// Double precision copies of the instance positions and their per-frame
+	// camera-relative float versions.
+	WorldPositions instancePositions;
+
+	// Orientation and scale of every instance. Node translations are relative to
+	// the instance's double precision world position, so the hierarchy can stay in float.
+	TransformHierarchy instanceHierarchy;
+
+	// Draw group (mesh * arrayPairCount + array pair) and material data of every instance.
+	std::vector<uint32_t> instanceDrawGroups;
+	std::vector<glm::vec4> instanceMaterials;
+
+	// Per-instance data counts as scene memory.
+	{
+		MemoryScope sceneMemory(MEMORY_CATEGORY_SCENE);
+
+		instancePositions.Reserve(instanceCount);
+		instanceHierarchy.Reserve(instanceCount);
+		instanceDrawGroups.resize(instanceCount);
+		instanceMaterials.resize(instanceCount);
+	}
+
+	// Culling uses one sphere radius for all instances, the largest scaled mesh bound.
+	float instanceBoundingRadius = 0.0f;
+
+	for (int i = 0; i < instanceCount; i++)
+	{
+		const SceneInstanceRecord& instance = scene.Instances[instanceOrder[i]];
+
+		instancePositions.Add(glm::dvec3(instance.Position[0], instance.Position[1], instance.Position[2]));
+
+		glm::quat rotation(instance.Rotation[3], instance.Rotation[0], instance.Rotation[1], instance.Rotation[2]);
+		glm::vec3 scale(instance.Scale[0], instance.Scale[1], instance.Scale[2]);
+		instanceHierarchy.AddNode(-1, glm::vec3(0.0f), rotation, scale);
+
+		instanceDrawGroups[i] = getDrawGroup(instance);
+		instanceMaterials[i] = materialData[getMaterial(instance)];
+
+		float maxScale = std::max(std::fabs(scale.x), std::max(std::fabs(scale.y), std::fabs(scale.z)));
+		instanceBoundingRadius = std::max(instanceBoundingRadius, scene.Meshes[instance.Mesh].BoundingRadius * maxScale);
+	}
+	instanceHierarchy.SortByDepth();
+
+	std::vector<float> relativeX(instanceCount), relativeY(instanceCount), relativeZ(instanceCount);
+
 	// Vertex Array Object.
 	unsigned int VAO;
 	glGenVertexArrays(1, &VAO);
@@ -184,167 +552,513 @@ int main()
 	unsigned int VBO;
 	glGenBuffers(1, &VBO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	// Vertex data of all meshes, uploaded straight from the scene (mapped pages for scene files).
+	glBufferData(GL_ARRAY_BUFFER, scene.VertexDataSize, scene.VertexData, GL_STATIC_DRAW);
+	TrackGpuMemory(GPU_RESOURCE_BUFFER, VBO, MEMORY_CATEGORY_SCENE, scene.VertexDataSize);
 
 	// Position Attrib.
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SCENE_VERTEX_FLOATS * sizeof(float), (void*)0);
 	glEnableVertexAttribArray(0);
 
 	// Color Attrib.
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, SCENE_VERTEX_FLOATS * sizeof(float), (void*)(3 * sizeof(float)));
 	glEnableVertexAttribArray(1);
 
 	// Texture Attrib.
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, SCENE_VERTEX_FLOATS * sizeof(float), (void*)(6 * sizeof(float)));
 	glEnableVertexAttribArray(2);
 
+	// Position-only copy of the vertex data for the depth pre-pass.
+	DepthPrepass depthPrepass(scene.VertexData, scene.VertexDataSize, SCENE_VERTEX_FLOATS * sizeof(float), depthState, prepassDepthTest, INSTANCE_TRANSFORM_UNIT);
+	glBindVertexArray(VAO);
+
 #pragma endregion
 
 
-#pragma region LoadTextures
+#pragma region SamplerUnits
 
-	// Base Texture / texture 1
-	//-------------------------
+	// Tell OpenGL for each sampler to which texture unit it belongs to 
+	shaderProgram.useShaderProgram();
+	glUniform1i(glGetUniformLocation(shaderProgram.getShaderID(), "materialTextures"), MATERIAL_TEXTURE_UNIT);
+	glUniform1i(glGetUniformLocation(shaderProgram.getShaderID(), "overlayTextures"), OVERLAY_TEXTURE_UNIT);
+	glUniform1f(glGetUniformLocation(shaderProgram.getShaderID(), "textureInterpOffset"), textureInterpVal);
+	glUniform1i(glGetUniformLocation(shaderProgram.getShaderID(), "instanceTransforms"), INSTANCE_TRANSFORM_UNIT);
+	glUniform1i(glGetUniformLocation(shaderProgram.getShaderID(), "instanceMaterials"), INSTANCE_MATERIAL_UNIT);
+	glUniformBlockBinding(shaderProgram.getShaderID(), glGetUniformBlockIndex(shaderProgram.getShaderID(), "CameraBlock"), CameraUniforms::BINDING_POINT);
 
-	unsigned int texture1;
-	glGenTextures(1, &texture1);
-	glBindTexture(GL_TEXTURE_2D, texture1);
 
-	// Texture Wrapping.
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+#pragma endregion
 
-	// Texture Filtering.
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-	// Load texture images.
-	//---------------------
+#pragma region RenderLoop
 
-	// flip the y-axis during image loading.
-	stbi_set_flip_vertically_on_load(true);
+	redrawScheduler = RedrawScheduler(options.OnDemand, glfwGetTime());
+	double loopStartTime = glfwGetTime();
 
-	int width, height, nrChannels;
-	
-	unsigned char* imageData = stbi_load("texture_1.jpg", &width, &height, &nrChannels, 0);
-	if (imageData)
-	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, imageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
+	// Frame pacing: times between consecutive drawn frames, and an optional limiter.
+	FrameStats frameStats;
+	bool frameTimeValid = false;
+	std::unique_ptr<FrameLimiter> frameLimiter;
+	if (options.FrameLimit > 0.0f)
+		frameLimiter.reset(new FrameLimiter(options.FrameLimit));
+
+	while (!glfwWindowShouldClose(window))
 	{
-		cout << "FAILED TO LOAD TEXTURE-1\n";
-	}
-	stbi_image_free(imageData);
+		// Nothing changed last frame: sleep until an event or the timeout.
+		if (redrawScheduler.CanWait())
+		{
+			double waitStart = glfwGetTime();
+			glfwWaitEventsTimeout(REDRAW_WAIT_TIMEOUT);
+			redrawScheduler.AddWaitTime(glfwGetTime() - waitStart);
+			frameTimeValid = false;
 
-	// Texture 2 / Overlay texture.
-	//-----------------------------
+			// Resume as if one tick had passed, so whatever woke the loop applies now.
+			lastFrame = static_cast<float>(glfwGetTime()) - FIXED_TIMESTEP;
+		}
 
-	unsigned int texture2;
-	glGenTextures(1, &texture2);
-	glBindTexture(GL_TEXTURE_2D, texture2);
+		if (options.IdleRunSeconds > 0.0f && glfwGetTime() - loopStartTime >= options.IdleRunSeconds)
+			break;
 
-	// Texture Wrapping.
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		if (frameLimiter)
+			frameLimiter->Wait();
 
-	// Texture Filtering.
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		// Calculate Delta Time.
+		float currentFrame = static_cast<float>(glfwGetTime());
+		deltaTime = currentFrame - lastFrame;
+		lastFrame = currentFrame;
 
-	// Load Image.
-	imageData = stbi_load("texture_2.png", &width, &height, &nrChannels, 0);
-	if (imageData)
-	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		cout << "FAILED TO LOAD TEXTURE-2\n";
-	}
-	stbi_image_free(imageData);
+		// Only the time between two drawn frames is a frame time; waits and skipped frames aren't.
+		if (frameTimeValid)
+		{
+			double smoothedDelta = frameStats.AddFrame(deltaTime);
+			if (options.SmoothDeltaTime)
+				deltaTime = static_cast<float>(smoothedDelta);
+		}
+		frameTimeValid = false;
 
-	// Tell OpenGL for each sampler to which texture unit it belongs to 
-	shaderProgram.useShaderProgram();
-	glUniform1i(glGetUniformLocation(shaderProgram.getShaderID(), "texture1"), 0);
-	glUniform1i(glGetUniformLocation(shaderProgram.getShaderID(), "texture2"), 1);
-	glUniform1f(glGetUniformLocation(shaderProgram.getShaderID(), "textureInterp"), textureInterpVal);
+		double frameStartTime = glfwGetTime();
 
+		frameArena.BeginFrame();
+		BeginMemoryFrame();
 
-#pragma endregion
+		// GPU times of earlier frames.
+		long long gpuFrame;
+		double gpuMs;
+		while (gpuTimer.collect(gpuFrame, gpuMs))
+		{
+			if (benchmarkRun)
+				frameTimings.SetGpuTime(static_cast<size_t>(gpuFrame), gpuMs);
+			lastGpuMs = gpuMs;
+		}
 
+		latencyTracker.collect();
+		prepassOverdraw.collect();
+		shadingOverdraw.collect();
 
-#pragma region RenderLoop
+		// Handle Keyboard Inputs.
+		processInput(window, shaderProgram);
 
-	while (!glfwWindowShouldClose(window))
-	{
-		// Calculate Delta Time.
-		float currentFrame = static_cast<float>(glfwGetTime());
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
+		// Mouse events since the last frame.
+		inputCoalescer.Drain(inputQueue);
 
-		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		// Newest input event this frame shows, for the latency measurement.
+		double frameInputTime = -1.0;
 
-		// Bind Textures.
+		// Camera Update.
 		//---------------
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, texture1);
+		if (replayMode)
+		{
+			// One recorded tick per frame, independent of how long frames take.
+			if (!cameraReplay.NextTick(camera))
+			{
+				glfwSetWindowShouldClose(window, true);
+				break;
+			}
+		}
+		else if (flythroughMode)
+		{
+			// Constant speed along the spline, one fixed tick per frame.
+			if (!flythrough.Update(FIXED_TIMESTEP, camera))
+				glfwSetWindowShouldClose(window, true);
+		}
+		else
+		{
+			tickAccumulator += deltaTime;
+
+			if (orbitMode && orbitFocusRequested)
+			{
+				float cursorX, cursorY;
+				getCursorNdc(window, cursorX, cursorY);
+
+				glm::vec3 ray = orbitCamera.GetCursorRay(cursorX, cursorY, camera.GetCurrentFOV(), (float)framebufferWidth / (float)framebufferHeight);
+				long long picked = pickInstance(instancePositions, instanceBoundingRadius, orbitCamera.GetPosition(), ray);
+				if (picked >= 0)
+					orbitCamera.SetTarget(instancePositions.Get(static_cast<size_t>(picked)));
+
+				orbitFocusRequested = false;
+			}
+
+			int ticks = 0;
+			while (tickAccumulator >= FIXED_TIMESTEP && ticks < MAX_TICKS_PER_FRAME)
+			{
+				// Mouse input first, like replays. Later ticks of the frame get none.
+				CoalescedInput mouse = inputCoalescer.Take();
+				if (mouse.CursorEvents > 0)
+					frameInputTime = mouse.LatestTime;
+
+				if (orbitMode)
+				{
+					applyOrbitInput(window, mouse);
+					cameraRecorder.EndTick(0, camera);
+				}
+				else
+				{
+					applyMouseInput(mouse);
+					moveCamera(camera, movementMask, FIXED_TIMESTEP);
+					cameraRecorder.EndTick(movementMask, camera);
+				}
+
+				tickAccumulator -= FIXED_TIMESTEP;
+				ticks++;
+			}
+
+			// Drop the backlog after a long hitch instead of catching up.
+			if (ticks == MAX_TICKS_PER_FRAME)
+				tickAccumulator = 0.0f;
+		}
 
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, texture2);
+		// Skip the frame if nothing visible changed. Held keys, a dragged or
+		// coasting orbit and scripted runs count as animation.
+		bool animating = benchmarkRun || frameCapture != nullptr || movementMask != 0 || orbitDragging || (orbitMode && !orbitCamera.IsSettled());
+		redrawScheduler.Update(camera.GetGeneration(), animating, glfwGetTime());
 
-		// Handle Keyboard Inputs.
-		processInput(window, shaderProgram);
+		if (!redrawScheduler.ShouldRender())
+		{
+			redrawScheduler.EndFrame(false);
+			continue;
+		}
+
+		if (timeGpu)
+			gpuTimer.begin();
+
+		updateViewCameras(views);
+
+		// Positions relative to the main camera, subtracted in double. All views
+		// share this origin so they can share the instance data.
+		glm::dvec3 renderOrigin = cameraRelativeRendering ? camera.GetPosition() : glm::dvec3(0.0);
+		instancePositions.ToCameraRelative(renderOrigin, relativeX.data(), relativeY.data(), relativeZ.data());
+
+		// Projection / View Matrices and frusta of every view.
+		//-----------------------------------------------------
+		const ProjectionSettings& projectionSettings = depthState.getProjectionSettings();
+
+		for (int v = 0; v < viewCount; v++)
+		{
+			CameraView& view = views[v];
+
+			float renderScale = dynamicResolution.GetScale();
+			int viewWidth = std::max(1, static_cast<int>(CameraView::GetPixelWidth(view.Width, framebufferWidth) * renderScale));
+			int viewHeight = std::max(1, static_cast<int>(CameraView::GetPixelHeight(view.Height, framebufferHeight) * renderScale));
+			view.Target.resize(viewWidth, viewHeight);
+
+			float viewAspect = (float)view.Target.getWidth() / (float)view.Target.getHeight();
+			view.ProjectionMatrix = BuildProjectionMatrix(projectionSettings, view.ViewCamera.GetCurrentFOV(), viewAspect);
+			view.ViewMatrix = view.ViewCamera.GetViewMatrixRelativeTo(renderOrigin);
 
-		// Projection Matrix.
-		//-------------------
-		glm::mat4 projectionMatrix = glm::perspective(glm::radians(camera.GetCurrentFOV()), aspect, zNear, zFar);
-		unsigned int pMatLocation = glGetUniformLocation(shaderProgram.getShaderID(), "projectionMatrix");
-		glUniformMatrix4fv(pMatLocation, 1, GL_FALSE, &projectionMatrix[0][0]);
+			glm::mat4 cullProjection = view.ProjectionMatrix;
+			if (lateLatch && v == MAIN_VIEW)
+				cullProjection = BuildProjectionMatrix(projectionSettings, view.ViewCamera.GetCurrentFOV() + LATE_LATCH_CULL_FOV_MARGIN, viewAspect);
 
-		// View Matrix.
-		//-------------
-		glm::mat4 viewMatrix = camera.GetViewMatrix();
-		unsigned int vMatLocation = glGetUniformLocation(shaderProgram.getShaderID(), "viewMatrix");
-		glUniformMatrix4fv(vMatLocation, 1, GL_FALSE, &viewMatrix[0][0]);
+			viewFrustums[v].ExtractPlanes(cullProjection * view.ViewMatrix, projectionSettings.ZeroToOneDepth);
+		}
+
+		// Visible sets of all views, computed in parallel.
+		culler.Cull(viewFrustums.data(), viewCount, relativeX.data(), relativeY.data(), relativeZ.data(),
+			instanceBoundingRadius, instanceCount, jobSystem);
+
+		// Only changed subtrees recompute, so a static scene costs nothing here.
+		instanceHierarchy.Update(jobSystem);
+
+		// Model Matrices of every instance visible in any view, uploaded once.
+		//-----------------------------------------------------------------
+		const std::vector<uint32_t>& sharedInstances = culler.GetSharedInstances();
+		FrameVector<glm::mat4> instanceTransforms(sharedInstances.size(), FrameAllocator<glm::mat4>(frameArena));
+		FrameVector<glm::vec4> visibleMaterials(sharedInstances.size(), FrameAllocator<glm::vec4>(frameArena));
+
+		for (size_t i = 0; i < sharedInstances.size(); i++)
+		{
+			uint32_t instance = sharedInstances[i];
+			glm::mat4 modelMatrix = instanceHierarchy.GetWorldMatrix(instance);
+			modelMatrix[3] += glm::vec4(relativeX[instance], relativeY[instance], relativeZ[instance], 0.0f);
+
+			instanceTransforms[i] = modelMatrix;
+			visibleMaterials[i] = instanceMaterials[instance];
+		}
 
+		instanceBuffer.uploadTransforms(instanceTransforms.data(), instanceTransforms.size());
+		instanceBuffer.uploadMaterials(visibleMaterials.data(), visibleMaterials.size());
 
-		// Bind Vertex Array Object before any draw calls.
-		glBindVertexArray(VAO);
+		// Texture streaming: finest mip every array needs for the main view.
+		//-------------------------------------------------------------------
+		textureStreamer.beginFrame();
 
-		// Draw 10 cubes in different location from the world origin.
-		//-----------------------------------------------------------
+		const std::vector<uint32_t>& mainInstances = culler.GetViewInstances(MAIN_VIEW);
+		glm::vec3 cameraOffset = glm::vec3(camera.GetPosition() - renderOrigin);
+		int mainViewHeight = views[MAIN_VIEW].Target.getHeight();
 
-		for (int i = 0; i < 10; i++)
+		for (uint32_t visibleIndex : mainInstances)
 		{
-			// Model Matrix.
-			//--------------
-			glm::mat4 modelMatrix = glm::mat4(1.0f);	// Identity Mat.
+			uint32_t instance = sharedInstances[visibleIndex];
+			const MaterialArrayPair& arrays = arrayPairs[instanceDrawGroups[instance] % arrayPairCount];
+			float distance = glm::length(glm::vec3(relativeX[instance], relativeY[instance], relativeZ[instance]) - cameraOffset);
+
+			for (int textureArray : { arrays.Base, arrays.Overlay })
+			{
+				if (textureArray >= textureArrays.getArrayCount())
+					continue;
+
+				uint32_t level = TextureStreamer::GetRequiredLevel(distance, instanceBoundingRadius, textureArrays.getWidth(textureArray),
+					camera.GetCurrentFOV(), mainViewHeight);
 
-			// translate each cube to a new position.
-			modelMatrix = glm::translate(modelMatrix, cubePositions[i]);
+				textureStreamer.requestLevel(textureArray, level);
+			}
+		}
 
-			unsigned int mMatLocation = glGetUniformLocation(shaderProgram.getShaderID(), "modelMatrix");
-			glUniformMatrix4fv(mMatLocation, 1, GL_FALSE, &modelMatrix[0][0]);
+		textureStreamer.update();
 
-			// Draw Vertices.
-			glDrawArrays(GL_TRIANGLES, 0, 36);
+		// Residency stats in the window title.
+		if (frameStartTime - lastTitleUpdate > 0.5)
+		{
+			const TextureStreamingStats& streaming = textureStreamer.getStats();
+			MemoryCategoryStats memory = GetTotalMemoryStats();
+			std::string title = "OpenGL Camera System | textures " + std::to_string(streaming.ResidentBytes / (1024 * 1024)) + " / "
+				+ std::to_string(streaming.BudgetBytes / (1024 * 1024)) + " MB, " + std::to_string(streaming.PendingLoads) + " loading, "
+				+ std::to_string(streaming.StarvedArrays) + " below requested mip | frame arena "
+				+ std::to_string(frameArena.GetStats().HighWaterBytes / 1024) + " / " + std::to_string(frameArena.GetStats().Capacity / 1024) + " KB"
+				+ " | CPU " + std::to_string(memory.CpuLiveBytes / (1024 * 1024)) + " MB, GPU " + std::to_string(memory.GpuLiveBytes / (1024 * 1024))
+				+ " MB, " + std::to_string(memory.FrameAllocations) + " allocs/frame";
+
+			const LatencyStats& latency = latencyTracker.getStats();
+			if (latency.Samples > 0)
+			{
+				title += " | input latency " + std::to_string(static_cast<int>(latency.MeanMs + 0.5)) + " ms (p95 "
+					+ std::to_string(static_cast<int>(latency.P95Ms + 0.5)) + ")" + (lateLatch ? ", late latch" : "");
+			}
+
+			if (shadingOverdraw.getSampleCount() > 0)
+			{
+				title += " | shaded " + std::to_string(shadingOverdraw.getFragmentsPerPixel()).substr(0, 4) + " fragments/pixel";
+				if (depthPrepassEnabled)
+					title += " (depth pass " + std::to_string(prepassOverdraw.getFragmentsPerPixel()).substr(0, 4) + ")";
+			}
+
+			FrameStatsSummary frames = frameStats.GetSummary();
+			title += " | frame p50 " + std::to_string(frames.P50Ms).substr(0, 5) + " ms, p99 " + std::to_string(frames.P99Ms).substr(0, 5)
+				+ " ms, " + std::to_string(frames.Hitches) + " hitches";
+
+			if (dynamicResolutionEnabled)
+				title += " | render scale " + std::to_string(static_cast<int>(dynamicResolution.GetScale() * 100.0f + 0.5f)) + "%";
+
+			if (frameCapture)
+			{
+				CaptureStats capture = frameCapture->getStats();
+				title += " | capture " + std::to_string(capture.Captured) + " frames, "
+					+ std::to_string(capture.DroppedReadback + capture.DroppedEncoder) + " dropped";
+			}
+
+			glfwSetWindowTitle(window, title.c_str());
+			lastTitleUpdate = frameStartTime;
+		}
+
+		// Camera matrices. With late latching the main view takes the mouse input
+		// that arrived while the frame was prepared, without applying it to the
+		// camera (the next tick does).
+		//------------------------------------------------------------------------
+		if (lateLatch && !benchmarkRun)
+		{
+			glfwPollEvents();
+			inputCoalescer.Drain(inputQueue);
+
+			const CoalescedInput& pending = inputCoalescer.Peek();
+			if (pending.CursorEvents > 0)
+			{
+				Camera latchedCamera = camera;
+				turnCamera(latchedCamera, pending.MouseX, pending.MouseY);
+
+				views[MAIN_VIEW].ViewMatrix = latchedCamera.GetViewMatrixRelativeTo(renderOrigin);
+				frameInputTime = pending.LatestTime;
+			}
 		}
 
+		for (int v = 0; v < viewCount; v++)
+			cameraUniforms.setView(v, views[v].ProjectionMatrix, views[v].ViewMatrix);
+
+		cameraUniforms.upload();
+		double latchTime = glfwGetTime();
+
+		// Bind instance data. Texture array pairs are bound per draw group.
+		//-------------------------------------------------------------
+		instanceBuffer.bindTransforms(INSTANCE_TRANSFORM_UNIT);
+		instanceBuffer.bindMaterials(INSTANCE_MATERIAL_UNIT);
+		int boundPair = -1;
+
+		// Draw the visible instances of a view. The depth pass only needs positions,
+		// so draw groups of one mesh merge across texture arrays.
+		auto drawInstances = [&](int v, const std::vector<uint32_t>& viewInstances, bool depthOnly)
+		{
+			// Visible instances keep the instance order, so each draw group is one contiguous range.
+			size_t first = 0;
+			while (first < viewInstances.size())
+			{
+				uint32_t drawGroup = instanceDrawGroups[sharedInstances[viewInstances[first]]];
+				uint32_t mesh = drawGroup / arrayPairCount;
+
+				size_t last = first + 1;
+				while (last < viewInstances.size())
+				{
+					uint32_t nextGroup = instanceDrawGroups[sharedInstances[viewInstances[last]]];
+					if (depthOnly ? nextGroup / arrayPairCount != mesh : nextGroup != drawGroup)
+						break;
+					last++;
+				}
+
+				int pair = static_cast<int>(drawGroup % arrayPairCount);
+				const MaterialArrayPair& arrays = arrayPairs[pair];
+				if (!depthOnly && pair != boundPair && arrays.Base < textureArrays.getArrayCount())
+				{
+					textureArrays.bind(arrays.Base, MATERIAL_TEXTURE_UNIT);
+					textureArrays.bind(arrays.Overlay, OVERLAY_TEXTURE_UNIT);
+					boundPair = pair;
+				}
+
+				const SceneMeshRecord& meshRecord = scene.Meshes[mesh];
+				instanceBuffer.bindViewIndices(v, INSTANCE_INDEX_ATTRIB, first);
+
+				glDrawArraysInstanced(GL_TRIANGLES, static_cast<GLint>(meshRecord.VertexOffset / meshRecord.VertexStride),
+					static_cast<GLsizei>(meshRecord.VertexCount), static_cast<GLsizei>(last - first));
+
+				first = last;
+			}
+		};
+
+		// Draw the instances of every view into its own target.
+		//---------------------------------------------------
+		for (int v = 0; v < viewCount; v++)
+		{
+			CameraView& view = views[v];
+
+			view.Target.bind();
+			glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			cameraUniforms.bind(v);
+
+			const std::vector<uint32_t>& viewInstances = culler.GetViewInstances(v);
+			if (viewInstances.empty())
+				continue;
+
+			instanceBuffer.uploadViewIndices(v, viewInstances.data(), viewInstances.size());
+
+			// Overdraw is counted on the main view, which covers most pixels.
+			bool countOverdraw = v == MAIN_VIEW;
+			long long viewPixels = static_cast<long long>(view.Target.getWidth()) * view.Target.getHeight();
+
+			if (depthPrepassEnabled)
+			{
+				depthPrepass.beginDepthPass();
+
+				if (countOverdraw)
+					prepassOverdraw.begin(viewPixels);
+				drawInstances(v, viewInstances, true);
+				if (countOverdraw)
+					prepassOverdraw.end();
+
+				depthPrepass.beginShadingPass();
+			}
+
+			shaderProgram.useShaderProgram();
+			glBindVertexArray(VAO);
+
+			if (countOverdraw)
+				shadingOverdraw.begin(viewPixels);
+			drawInstances(v, viewInstances, false);
+			if (countOverdraw)
+				shadingOverdraw.end();
+
+			if (depthPrepassEnabled)
+				depthPrepass.end();
+		}
+
+		// Composite the views into the window.
+		//-------------------------------------
+		for (const CameraView& view : views)
+		{
+			view.Target.blitToDefault(static_cast<int>(view.X * framebufferWidth), static_cast<int>(view.Y * framebufferHeight),
+				CameraView::GetPixelWidth(view.Width, framebufferWidth), CameraView::GetPixelHeight(view.Height, framebufferHeight));
+		}
+
+		if (frameCapture)
+			frameCapture->capture(framebufferWidth, framebufferHeight);
+
+		double cpuFrameMs = (glfwGetTime() - frameStartTime) * 1000.0;
+
+		if (timeGpu)
+			gpuTimer.end();
+
+		if (benchmarkRun)
+			frameTimings.AddFrame(cpuFrameMs);
+
+		// Next frame's scale from whichever side limits the frame. GPU times lag a
+		// few frames behind, which the controller's gains account for.
+		if (dynamicResolutionEnabled)
+			dynamicResolution.Update(static_cast<float>(std::max(cpuFrameMs, lastGpuMs)));
+
 		// Swap buffers and poll IO events.
 		//---------------------------------
 		glfwSwapBuffers(window);
+		latencyTracker.endFrame(frameInputTime, latchTime);
+		redrawScheduler.EndFrame(true);
+		frameTimeValid = true;
+
+		// Mips still streaming in change the image on their own.
+		if (textureStreamer.getStats().PendingLoads > 0)
+			redrawScheduler.Request(REDRAW_RESOURCES);
+
 		glfwPollEvents();
 	}
 
+	RedrawStats redrawStats = redrawScheduler.GetStats(glfwGetTime());
+
+	// Wait for the GPU timings still in flight.
+	long long gpuFrame;
+	double gpuMs;
+	while (gpuTimer.collect(gpuFrame, gpuMs, true))
+	{
+		if (benchmarkRun)
+			frameTimings.SetGpuTime(static_cast<size_t>(gpuFrame), gpuMs);
+	}
+
+	cameraRecorder.Close();
+
 	// De-allocate all resources once they've outlived their purpose.
 	//---------------------------------------------------------------
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
+	ReleaseGpuMemory(GPU_RESOURCE_BUFFER, VBO);
 	glDeleteProgram(shaderProgram.getShaderID());
+	textureStreamer.deleteBuffers();
+	textureArrays.deleteTextures();
+	instanceBuffer.deleteBuffers();
+	for (CameraView& view : views)
+		view.Target.deleteBuffers();
+	gpuTimer.deleteQueries();
+	prepassOverdraw.deleteQueries();
+	shadingOverdraw.deleteQueries();
+	depthPrepass.deleteBuffers();
+	latencyTracker.deleteQueries();
+	if (frameCapture)
+		frameCapture->deleteBuffers();
+	cameraUniforms.deleteBuffers();
 
 	// Clear all previously allocated resources.
 	//------------------------------------------
@@ -352,13 +1066,100 @@ int main()
 
 #pragma endregion
 
-	return 0;
+	// Benchmark results.
+	//-------------------
+	int exitCode = 0;
+
+	if (replayMode)
+	{
+		std::cout << "Replayed " << cameraReplay.GetCurrentTick() << " / " << cameraReplay.GetTickCount() << " ticks, "
+			<< cameraReplay.GetDivergedTicks() << " diverged from the recording.\n";
+	}
+
+	if (benchmarkRun)
+	{
+		if (!options.TimingsPath.empty())
+			frameTimings.WriteCSV(options.TimingsPath);
+
+		FrameTimingLog baseline;
+		if (!options.BaselinePath.empty() && baseline.ReadCSV(options.BaselinePath))
+		{
+			if (!FrameTimingLog::Compare(baseline, frameTimings, options.RegressionTolerance))
+				exitCode = 1;
+		}
+	}
+
+	frameStats.PrintSummary();
+
+	if (shadingOverdraw.getSampleCount() > 0)
+	{
+		std::cout << "Main view shaded " << shadingOverdraw.getFragmentsPerPixel() << " fragments per pixel";
+		if (prepassOverdraw.getSampleCount() > 0)
+			std::cout << ", depth pre-pass " << prepassOverdraw.getFragmentsPerPixel();
+		std::cout << (depthPrepassEnabled ? " (depth pre-pass on at exit).\n" : " (depth pre-pass off at exit).\n");
+	}
+	if (!options.FrameStatsPath.empty())
+		frameStats.WriteCSV(options.FrameStatsPath);
+
+	if (redrawScheduler.IsEnabled() || options.IdleRunSeconds > 0.0f)
+	{
+		std::cout << "Rendered " << redrawStats.RenderedFrames << " frames (" << redrawStats.SkippedFrames << " skipped"
+			<< (redrawScheduler.IsEnabled() ? ", on demand" : ", continuous") << ") in " << redrawStats.WallSeconds << " s: CPU time "
+			<< redrawStats.CpuSeconds << " s (" << 100.0 * redrawStats.CpuSeconds / std::max(redrawStats.WallSeconds, 1.0e-9)
+			<< "% of one core), waiting for events " << 100.0 * redrawStats.WaitSeconds / std::max(redrawStats.WallSeconds, 1.0e-9)
+			<< "% of the time.\n";
+	}
+
+	const LatencyStats& latency = latencyTracker.getStats();
+	if (latency.Samples > 0)
+	{
+		std::cout << "Input to GPU completion: " << latency.TotalMeanMs << " ms mean over " << latency.Samples << " frames, last "
+			<< LATENCY_WINDOW_SIZE << ": " << latency.MeanMs << " ms mean, " << latency.P95Ms << " ms p95, "
+			<< latency.MeanInputToLatchMs << " ms until the camera was latched" << (lateLatch ? " (late latch)" : "") << ".\n";
+	}
+
+	if (frameCapture)
+	{
+		CaptureStats capture = frameCapture->getStats();
+		std::cout << "Captured " << capture.Captured << " frames (" << capture.Encoded << " encoded), dropped "
+			<< capture.DroppedReadback << " waiting for readback and " << capture.DroppedEncoder << " waiting for encoders. "
+			<< "Capture overhead " << capture.MeanOverheadMs << " ms mean, " << capture.MaxOverheadMs << " ms max per frame; "
+			<< capture.MeanEncodeMs << " ms per encoded frame.\n";
+	}
+
+	// Memory per subsystem. GL objects are deleted by now, budgets compare peaks.
+	if (!options.MemoryReportPath.empty() || !options.MemoryBudgetsPath.empty())
+		PrintMemoryReport();
+
+	if (!options.MemoryReportPath.empty())
+		WriteMemoryReport(options.MemoryReportPath);
+
+	if (!options.MemoryBudgetsPath.empty() && !CheckMemoryBudgets(options.MemoryBudgetsPath))
+		exitCode = 1;
+
+	return exitCode;
 }
 
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
 	glViewport(0, 0, width, height);
+
+	// View targets and projections follow the window size.
+	framebufferWidth = width;
+	framebufferHeight = height;
+
+	redrawScheduler.Request(REDRAW_RESIZE);
+}
+
+
+void updateViewCameras(std::vector<CameraView>& views)
+{
+	views[MAIN_VIEW].ViewCamera = camera;
+
+	// Minimap looks straight down from above the main camera, oriented like it.
+	glm::dvec3 minimapPosition = camera.GetPosition() + glm::dvec3(0.0, 25.0, 0.0);
+	views[MINIMAP_VIEW].ViewCamera.SetState(minimapPosition, camera.GetYaw(), -89.0f, DEFAULT_FOV);
 }
 
 
@@ -376,60 +1177,188 @@ void processInput(GLFWwindow* window, Shader& shaderProgram)
 	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
 	{
 		textureInterpVal = ((textureInterpVal + 0.0001f) < 1.0f) ? (textureInterpVal + 0.0001f) : 1.0f;
-		glUniform1f(glGetUniformLocation(shaderProgram.getShaderID(), "textureInterp"), textureInterpVal);
+		glUniform1f(glGetUniformLocation(shaderProgram.getShaderID(), "textureInterpOffset"), textureInterpVal);
+		redrawScheduler.Request(REDRAW_INPUT);
 	}
 
 	if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
 	{
-		textureInterpVal = ((textureInterpVal - 0.0001f) > 0.0f) ? (textureInterpVal - 0.0001f) : 0.0f;
-		glUniform1f(glGetUniformLocation(shaderProgram.getShaderID(), "textureInterp"), textureInterpVal);
+		textureInterpVal = ((textureInterpVal - 0.0001f) > -1.0f) ? (textureInterpVal - 0.0001f) : -1.0f;
+		glUniform1f(glGetUniformLocation(shaderProgram.getShaderID(), "textureInterpOffset"), textureInterpVal);
+		redrawScheduler.Request(REDRAW_INPUT);
+	}
+
+#pragma endregion
+
+
+#pragma region DepthPrepass
+
+	// Toggle the depth pre-pass on press.
+	bool prepassKeyPressed = glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS;
+	if (prepassKeyPressed && !prepassKeyDown)
+	{
+		depthPrepassEnabled = !depthPrepassEnabled;
+		redrawScheduler.Request(REDRAW_INPUT);
 	}
+	prepassKeyDown = prepassKeyPressed;
 
 #pragma endregion
 
 
 #pragma region CameraMovement
 
+	// Sample pressed directions. Movement is applied at the fixed timestep.
+	movementMask = 0;
+	orbitDragging = false;
+
+	// Camera is scripted during benchmark runs.
+	if (benchmarkRun)
+		return;
+
 	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-		camera.ProcessKeyboard(FORWARD, deltaTime);
+		movementMask |= MOVEMENT_BIT(FORWARD);
 
 	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-		camera.ProcessKeyboard(BACKWARD, deltaTime);
+		movementMask |= MOVEMENT_BIT(BACKWARD);
 
 	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-		camera.ProcessKeyboard(LEFT, deltaTime);
+		movementMask |= MOVEMENT_BIT(LEFT);
 
 	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-		camera.ProcessKeyboard(RIGHT, deltaTime);
+		movementMask |= MOVEMENT_BIT(RIGHT);
+
+	if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
+		movementMask |= MOVEMENT_BIT(UP);
+
+	if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
+		movementMask |= MOVEMENT_BIT(DOWN);
+
+	orbitDragging = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+
+	if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS)
+		orbitFocusRequested = true;
 
 #pragma endregion
 
 }
 
 
-void mouse_callback(GLFWwindow* window, double xPosIn, double yPosIn)
+void applyMouseInput(const CoalescedInput& input)
 {
-	float xpos = static_cast<float>(xPosIn);
-	float ypos = static_cast<float>(yPosIn);
+	if (input.CursorEvents > 0)
+	{
+		turnCamera(camera, input.MouseX, input.MouseY);
+		cameraRecorder.AddEvent(MOUSE_MOVE_EVENT, input.LatestTime, input.MouseX, input.MouseY);
+	}
 
-	if (firstMouse)
+	if (input.ScrollEvents > 0)
 	{
-		lastX = xpos;
-		lastY = ypos;
-		firstMouse = false;
+		camera.ProcessMouseScroll(input.Scroll);
+		cameraRecorder.AddEvent(MOUSE_SCROLL_EVENT, input.LatestTime, 0.0f, input.Scroll);
 	}
+}
 
-	float xOffset = xpos - lastX;
-	float yOffset = lastY - ypos;
 
-	lastX = xpos;
-	lastY = ypos;
+void moveCamera(Camera& target, unsigned int directionMask, float deltaTime)
+{
+	switch (cameraController)
+	{
+	case CONTROLLER_FLY: flyController.ProcessMovement(target, directionMask, deltaTime); break;
+	case CONTROLLER_FPS: fpsController.ProcessMovement(target, directionMask, deltaTime); break;
+	case CONTROLLER_SIX_DOF: sixDofController.ProcessMovement(target, directionMask, deltaTime); break;
+	default: target.ProcessKeyboardMask(directionMask, deltaTime); break;
+	}
+}
+
+
+void turnCamera(Camera& target, float xOffset, float yOffset)
+{
+	switch (cameraController)
+	{
+	case CONTROLLER_FLY: flyController.ProcessMouseInput(target, xOffset, yOffset); break;
+	case CONTROLLER_FPS: fpsController.ProcessMouseInput(target, xOffset, yOffset); break;
+	case CONTROLLER_SIX_DOF: sixDofController.ProcessMouseInput(target, xOffset, yOffset); break;
+	default: target.ProcessMouseInput(xOffset, yOffset); break;
+	}
+}
+
+
+void applyOrbitInput(GLFWwindow* window, const CoalescedInput& input)
+{
+	if (input.CursorEvents > 0 && orbitDragging)
+		orbitCamera.Rotate(input.MouseX, input.MouseY);
+
+	if (input.ScrollEvents > 0)
+	{
+		float cursorX, cursorY;
+		getCursorNdc(window, cursorX, cursorY);
+		orbitCamera.Zoom(input.Scroll, cursorX, cursorY, camera.GetCurrentFOV(), (float)framebufferWidth / (float)framebufferHeight);
+	}
+
+	// Settled orbits skip the camera update entirely.
+	if (orbitCamera.Update(FIXED_TIMESTEP, orbitDragging))
+		orbitCamera.Apply(camera);
+}
+
+
+void getCursorNdc(GLFWwindow* window, float& x, float& y)
+{
+	double cursorX, cursorY;
+	int width, height;
+	glfwGetCursorPos(window, &cursorX, &cursorY);
+	glfwGetWindowSize(window, &width, &height);
 
-	camera.ProcessMouseInput(xOffset, yOffset);
+	x = static_cast<float>(2.0 * cursorX / std::max(width, 1) - 1.0);
+	y = static_cast<float>(1.0 - 2.0 * cursorY / std::max(height, 1));
+}
+
+
+long long pickInstance(const WorldPositions& positions, float boundingRadius, const glm::dvec3& origin, const glm::vec3& direction)
+{
+	glm::dvec3 ray(direction);
+	double radiusSquared = static_cast<double>(boundingRadius) * boundingRadius;
+
+	long long nearest = -1;
+	double nearestDistance = 0.0;
+
+	for (size_t i = 0; i < positions.Size(); i++)
+	{
+		glm::dvec3 offset = positions.Get(i) - origin;
+		double along = glm::dot(offset, ray);
+		if (along <= 0.0 || (nearest >= 0 && along >= nearestDistance))
+			continue;
+
+		if (glm::dot(offset, offset) - along * along <= radiusSquared)
+		{
+			nearest = static_cast<long long>(i);
+			nearestDistance = along;
+		}
+	}
+
+	return nearest;
+}
+
+
+// Callbacks only queue the event, the render loop consumes it.
+void mouse_callback(GLFWwindow* window, double xPosIn, double yPosIn)
+{
+	InputEvent event;
+	event.Time = glfwGetTime();
+	event.Type = INPUT_CURSOR_MOVED;
+	event.X = static_cast<float>(xPosIn);
+	event.Y = static_cast<float>(yPosIn);
+
+	inputQueue.Push(event);
 }
 
 
 void scroll_callback(GLFWwindow* window, double xOffset, double yOffset)
 {
-	camera.ProcessMouseScroll(static_cast<float>(yOffset));
+	InputEvent event;
+	event.Time = glfwGetTime();
+	event.Type = INPUT_SCROLLED;
+	event.X = static_cast<float>(xOffset);
+	event.Y = static_cast<float>(yOffset);
+
+	inputQueue.Push(event);
 }
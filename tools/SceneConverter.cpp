@@ -0,0 +1,57 @@
+/* Scene converter.
+
+   Converts text scenes to the binary memory-mapped scene format, and generates
+   large cube field scenes for load benchmarks.
+
+     scene_converter <input.txt> <output.scene>
+     scene_converter --generate-cubes <count> <output.txt>
+
+   Build (from the repository root):
+     g++ -O2 -std=c++17 -IDependencies/includes -Isrc tools/SceneConverter.cpp
+         src/Scene/SceneData.cpp src/Scene/SceneFile.cpp src/Scene/DefaultScene.cpp src/IO/MappedFile.cpp -o scene_converter
+*/
+
+#include "Scene/DefaultScene.h"
+#include "Scene/SceneFile.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+	if (argc == 4 && strcmp(argv[1], "--generate-cubes") == 0)
+	{
+		size_t count = static_cast<size_t>(strtoull(argv[2], nullptr, 10));
+		SceneData scene = BuildCubeFieldScene(count, 1000.0, 42);
+
+		return scene.SaveText(argv[3]) ? 0 : 1;
+	}
+
+	if (argc != 3)
+	{
+		std::cout << "Usage: scene_converter <input.txt> <output.scene>\n"
+			<< "       scene_converter --generate-cubes <count> <output.txt>\n";
+		return 1;
+	}
+
+	SceneData scene;
+	if (!scene.LoadText(argv[1]))
+		return 1;
+
+	scene.SortInstancesByMesh();
+
+	if (!WriteSceneFile(argv[2], scene))
+		return 1;
+
+	// Read back through the mapped path so broken output fails here.
+	SceneFile file;
+	if (!file.Open(argv[2]))
+		return 1;
+
+	const SceneView& view = file.GetView();
+	std::cout << "Wrote " << argv[2] << ": " << view.MeshCount << " meshes, " << view.InstanceCount << " instances, "
+		<< view.MaterialCount << " materials, " << view.TextureCount << " textures, " << file.GetHeader().FileSize << " bytes.\n";
+
+	return 0;
+}
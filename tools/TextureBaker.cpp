@@ -0,0 +1,136 @@
+/* Texture baker.
+
+   Decodes an image, builds its gamma-correct mip chain and writes a baked
+   texture file (.ctex) that the viewport maps and uploads without decoding.
+
+     texture_baker [--format auto|rgba8|bc1|bc3] [--filter box|kaiser] [--threads N] <input image> [output.ctex]
+
+   auto picks BC1 for opaque images and BC3 otherwise. kaiser keeps distant
+   detail sharper than the default box filter. Without an output path
+   the file is written next to the image, where the viewport looks for it.
+
+   Build (from the repository root):
+     g++ -O2 -std=c++17 -pthread -IDependencies/includes -Isrc tools/TextureBaker.cpp
+         src/Textures/TextureBaker.cpp src/Textures/MipGenerator.cpp src/Textures/TextureFile.cpp src/IO/MappedFile.cpp src/Jobs/JobSystem.cpp -o texture_baker
+*/
+
+#include "Textures/TextureBaker.h"
+#include "Textures/TextureFile.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+	std::string formatName = "auto";
+	std::string filterName = "box";
+	unsigned int threadCount = 0;
+	std::string inputPath;
+	std::string outputPath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+			formatName = argv[++i];
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			filterName = argv[++i];
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			threadCount = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (inputPath.empty())
+			inputPath = argv[i];
+		else
+			outputPath = argv[i];
+	}
+
+	if (inputPath.empty())
+	{
+		std::cout << "Usage: texture_baker [--format auto|rgba8|bc1|bc3] [--filter box|kaiser] [--threads N] <input image> [output.ctex]\n";
+		return 1;
+	}
+
+	if (outputPath.empty())
+		outputPath = GetBakedTexturePath(inputPath);
+
+	// Same orientation as the viewport's stb_image loads.
+	stbi_set_flip_vertically_on_load(true);
+
+	int width, height, nrChannels;
+	unsigned char* imageData = stbi_load(inputPath.c_str(), &width, &height, &nrChannels, 0);
+	if (!imageData)
+	{
+		std::cout << "ERROR::TEXTURE_BAKER::FAILED_TO_LOAD: " << inputPath << std::endl;
+		return 1;
+	}
+
+	TextureImage image = MakeTextureImage(imageData, static_cast<uint32_t>(width), static_cast<uint32_t>(height), nrChannels);
+	stbi_image_free(imageData);
+
+	Texture_Format format = TEXTURE_FORMAT_RGBA8;
+	if (formatName == "bc1")
+		format = TEXTURE_FORMAT_BC1;
+	else if (formatName == "bc3")
+		format = TEXTURE_FORMAT_BC3;
+	else if (formatName == "auto")
+		format = HasTranslucentPixels(image) ? TEXTURE_FORMAT_BC3 : TEXTURE_FORMAT_BC1;
+	else if (formatName != "rgba8")
+	{
+		std::cout << "ERROR::TEXTURE_BAKER::UNKNOWN_FORMAT: " << formatName << std::endl;
+		return 1;
+	}
+
+	Mip_Filter filter = MIP_FILTER_BOX;
+	if (filterName == "kaiser")
+		filter = MIP_FILTER_KAISER;
+	else if (filterName != "box")
+	{
+		std::cout << "ERROR::TEXTURE_BAKER::UNKNOWN_FILTER: " << filterName << std::endl;
+		return 1;
+	}
+
+	JobSystem jobs(threadCount);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::vector<TextureImage> levels = GenerateMipChain(image, jobs, filter);
+	if (!WriteTextureFile(outputPath, format, levels, jobs))
+		return 1;
+
+	double bakeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	// Sizes of the uploaded mip chains, baked against decoded RGBA8.
+	size_t uncompressedBytes = 0;
+	size_t bakedBytes = 0;
+	for (const TextureImage& level : levels)
+	{
+		uncompressedBytes += GetTextureLevelSize(TEXTURE_FORMAT_RGBA8, level.Width, level.Height);
+		bakedBytes += GetTextureLevelSize(format, level.Width, level.Height);
+	}
+
+	const char* formatNames[] = { "rgba8", "bc1", "bc3" };
+
+	std::cout << outputPath << ": " << width << "x" << height << ", " << levels.size() << " levels, " << formatNames[format]
+		<< ", baked in " << bakeMs << " ms on " << jobs.GetThreadCount() << " threads.\n";
+	std::cout << "GPU memory: " << bakedBytes / 1024 << " KB (RGBA8 mip chain: " << uncompressedBytes / 1024 << " KB).\n";
+
+	// Time the runtime path: map and validate.
+	start = std::chrono::high_resolution_clock::now();
+	TextureFile file;
+	if (!file.Open(outputPath))
+		return 1;
+	double mapMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	imageData = stbi_load(inputPath.c_str(), &width, &height, &nrChannels, 0);
+	double decodeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	stbi_image_free(imageData);
+
+	std::cout << "Load: " << mapMs << " ms mapped, " << decodeMs << " ms decoding the image (before GPU mip generation).\n";
+
+	return 0;
+}